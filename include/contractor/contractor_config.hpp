@@ -41,7 +41,7 @@ namespace contractor
 
 struct ContractorConfig
 {
-    ContractorConfig() : requested_num_threads(0) {}
+    ContractorConfig() : requested_num_threads(0), renumber_nodes(false) {}
 
     // Infer the output names from the path of the .osrm file
     void UseDefaultOutputNames()
@@ -50,6 +50,10 @@ struct ContractorConfig
         core_output_path = osrm_input_path.string() + ".core";
         graph_output_path = osrm_input_path.string() + ".hsgr";
         node_file_path = osrm_input_path.string() + ".enw";
+        cnbg_ebg_mapping_path = osrm_input_path.string() + ".cnbg_to_ebg";
+        mld_partition_path = osrm_input_path.string() + ".partition";
+        mld_storage_path = osrm_input_path.string() + ".cells";
+        mld_graph_path = osrm_input_path.string() + ".mldgr";
         updater_config.osrm_input_path = osrm_input_path;
         updater_config.UseDefaultOutputNames();
     }
@@ -63,6 +67,10 @@ struct ContractorConfig
     std::string graph_output_path;
 
     std::string node_file_path;
+    std::string cnbg_ebg_mapping_path;
+    std::string mld_partition_path;
+    std::string mld_storage_path;
+    std::string mld_graph_path;
 
     bool use_cached_priority;
 
@@ -73,6 +81,10 @@ struct ContractorConfig
     // The remaining vertices form the core of the hierarchy
     //(e.g. 0.8 contracts 80 percent of the hierarchy, leaving a core of 20%)
     double core_factor;
+
+    // Renumbers the nodes of the edge-based graph in all files in the order of the hierarchy,
+    // which invalidates the files of osrm-partition and osrm-customize
+    bool renumber_nodes;
 };
 }
 }
@@ -0,0 +1,72 @@
+#ifndef OSRM_CONTRACTOR_RENUMBER_HPP
+#define OSRM_CONTRACTOR_RENUMBER_HPP
+
+#include "contractor/query_edge.hpp"
+
+#include "extractor/renumber.hpp"
+
+#include "util/deallocating_vector.hpp"
+#include "util/permutation.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/parallel_sort.h>
+
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+
+using extractor::renumber;
+
+// Orders the nodes of the contracted graph top-down for cache locality of the queries.
+// The core comes first, then every node is followed by the lower nodes below it in a
+// depth-first search that starts at the highest levels. The result maps old to new IDs.
+std::vector<NodeID> makePermutation(const NodeID number_of_nodes,
+                                    const util::DeallocatingVector<QueryEdge> &edges,
+                                    const std::vector<float> &node_levels,
+                                    const std::vector<bool> &is_core_node);
+
+inline void renumber(util::DeallocatingVector<QueryEdge> &edges,
+                     const std::vector<NodeID> &permutation)
+{
+    for (auto &edge : edges)
+    {
+        edge.source = permutation[edge.source];
+        edge.target = permutation[edge.target];
+        // only shortcuts store a node, the others the ID of their turn
+        if (edge.data.shortcut)
+            edge.data.turn_id = permutation[edge.data.turn_id];
+    }
+    tbb::parallel_sort(edges.begin(), edges.end());
+}
+
+inline void renumber(std::vector<bool> &is_core_node, const std::vector<NodeID> &permutation)
+{
+    // the core marker is empty if the graph was fully contracted
+    if (is_core_node.empty())
+        return;
+
+    std::vector<bool> renumbered(is_core_node.size());
+    for (const auto node : util::irange<NodeID>(0, is_core_node.size()))
+        renumbered[permutation[node]] = is_core_node[node];
+    is_core_node.swap(renumbered);
+}
+
+// node levels and node weights
+template <typename T>
+inline void renumber(std::vector<T> &node_values, const std::vector<NodeID> &permutation)
+{
+    if (node_values.empty())
+        return;
+
+    BOOST_ASSERT(node_values.size() == permutation.size());
+    util::inplacePermutation(node_values.begin(), node_values.end(), permutation);
+}
+}
+}
+
+#endif
@@ -5,9 +5,15 @@
 #include "partition/multi_level_partition.hpp"
 #include "util/query_heap.hpp"
 
+#include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_do.h>
+#include <tbb/parallel_for.h>
 
+#include <atomic>
+#include <cstdint>
 #include <unordered_set>
+#include <vector>
 
 namespace osrm
 {
@@ -35,70 +41,257 @@ class CellCustomizer
         const GraphT &graph, Heap &heap, partition::CellStorage &cells, LevelID level, CellID id)
     {
         auto cell = cells.GetCell(level, id);
-        auto destinations = cell.GetDestinationNodes();
-
-        // for each source do forward search
         for (auto source : cell.GetSourceNodes())
         {
-            std::unordered_set<NodeID> destinations_set(destinations.begin(), destinations.end());
-            heap.Clear();
-            heap.Insert(source, 0, {false, 0});
+            CustomizeSource(graph, heap, cells, level, id, source);
+        }
+    }
 
-            // explore search space
-            while (!heap.Empty() && !destinations_set.empty())
-            {
-                const NodeID node = heap.DeleteMin();
-                const EdgeWeight weight = heap.GetKey(node);
-                const EdgeDuration duration = heap.GetData(node).duration;
+    // Customizes all cells of all levels. A cell is customized as soon as all of its children
+    // are, so workers never wait for the slowest cell of a level. The searches of cells with
+    // many sources are split across threads as well, since the few cells of the top levels
+    // would otherwise be customized by only a few threads.
+    template <typename GraphT> void Customize(const GraphT &graph, partition::CellStorage &cells)
+    {
+        const auto level_offsets = GetLevelOffsets();
+        const auto parents = GetParents(level_offsets);
+        const std::vector<bool> dirty(level_offsets.back(), true);
+        CustomizeCells(graph, cells, level_offsets, parents, dirty);
+    }
 
-                if (level == 1)
-                    RelaxNode<true>(graph, cells, heap, level, node, weight, duration);
-                else
-                    RelaxNode<false>(graph, cells, heap, level, node, weight, duration);
+    // Only customizes the cells that depend on the outgoing edges of the updated nodes and
+    // keeps the metric of all other cells. An edge is only relaxed in the lowest cell that
+    // contains both of its nodes, higher cells see it through the cliques of their children.
+    // Returns the number of customized cells.
+    template <typename GraphT>
+    std::size_t Customize(const GraphT &graph,
+                          partition::CellStorage &cells,
+                          const std::vector<NodeID> &updated_nodes)
+    {
+        const LevelID number_of_levels = partition.GetNumberOfLevels();
+        const auto level_offsets = GetLevelOffsets();
+        const auto parents = GetParents(level_offsets);
 
-                destinations_set.erase(node);
+        std::vector<bool> dirty(level_offsets.back(), false);
+        for (const auto node : updated_nodes)
+        {
+            for (const auto edge : graph.GetAdjacentEdgeRange(node))
+            {
+                if (!graph.GetEdgeData(edge).forward)
+                    continue;
+
+                const LevelID level =
+                    partition.GetHighestDifferentLevel(node, graph.GetTarget(edge)) + 1;
+                if (level < number_of_levels)
+                {
+                    dirty[level_offsets[level] + partition.GetCell(level, node)] = true;
+                }
             }
+        }
 
-            // fill a map of destination nodes to placeholder pointers
-            auto weights = cell.GetOutWeight(source);
-            auto durations = cell.GetOutDuration(source);
-            for (auto &destination : destinations)
+        std::size_t number_of_dirty_cells = 0;
+        for (LevelID level = 1; level < number_of_levels; ++level)
+        {
+            for (CellID id = 0; id < partition.GetNumberOfCells(level); ++id)
             {
-                BOOST_ASSERT(!weights.empty());
-                BOOST_ASSERT(!durations.empty());
+                if (!dirty[level_offsets[level] + id])
+                    continue;
+
+                ++number_of_dirty_cells;
+                if (level + 1 < number_of_levels)
+                {
+                    const auto parent = parents[level_offsets[level] + id];
+                    dirty[level_offsets[level + 1] + parent] = true;
+                }
+            }
+        }
+
+        CustomizeCells(graph, cells, level_offsets, parents, dirty);
+        return number_of_dirty_cells;
+    }
 
-                const bool inserted = heap.WasInserted(destination);
-                weights.front() = inserted ? heap.GetKey(destination) : INVALID_EDGE_WEIGHT;
-                durations.front() =
-                    inserted ? heap.GetData(destination).duration : MAXIMAL_EDGE_DURATION;
+  private:
+    // Cells with at least this many sources run their searches in parallel
+    static constexpr std::size_t PARALLEL_SOURCES_THRESHOLD = 64;
 
-                weights.advance_begin(1);
-                durations.advance_begin(1);
+    struct CellTask
+    {
+        LevelID level;
+        CellID id;
+    };
+
+    // index 0 is unused, cells of a level are indexed starting at level_offsets[level]
+    std::vector<std::size_t> GetLevelOffsets() const
+    {
+        const LevelID number_of_levels = partition.GetNumberOfLevels();
+        std::vector<std::size_t> level_offsets(number_of_levels + 1, 0);
+        for (LevelID level = 1; level < number_of_levels; ++level)
+        {
+            level_offsets[level + 1] = level_offsets[level] + partition.GetNumberOfCells(level);
+        }
+        return level_offsets;
+    }
+
+    std::vector<CellID> GetParents(const std::vector<std::size_t> &level_offsets) const
+    {
+        std::vector<CellID> parents(level_offsets.back(), INVALID_CELL_ID);
+        for (LevelID level = 2; level < partition.GetNumberOfLevels(); ++level)
+        {
+            for (CellID id = 0; id < partition.GetNumberOfCells(level); ++id)
+            {
+                const auto begin = partition.BeginChildren(level, id);
+                const auto end = partition.EndChildren(level, id);
+                for (auto child = begin; child != end; ++child)
+                {
+                    parents[level_offsets[level - 1] + child] = id;
+                }
             }
-            BOOST_ASSERT(weights.empty());
-            BOOST_ASSERT(durations.empty());
         }
+        return parents;
     }
 
-    template <typename GraphT> void Customize(const GraphT &graph, partition::CellStorage &cells)
+    // Customizes the dirty cells, the parent of a dirty cell has to be dirty as well
+    template <typename GraphT>
+    void CustomizeCells(const GraphT &graph,
+                        partition::CellStorage &cells,
+                        const std::vector<std::size_t> &level_offsets,
+                        const std::vector<CellID> &parents,
+                        const std::vector<bool> &dirty)
     {
+        const LevelID number_of_levels = partition.GetNumberOfLevels();
+        if (number_of_levels < 2)
+            return;
+
         Heap heap_exemplar(graph.GetNumberOfNodes());
         HeapPtr heaps(heap_exemplar);
 
-        for (std::size_t level = 1; level < partition.GetNumberOfLevels(); ++level)
+        std::vector<std::atomic<std::uint32_t>> pending_children(level_offsets.back());
+        for (LevelID level = 1; level + 1 < number_of_levels; ++level)
+        {
+            for (CellID id = 0; id < partition.GetNumberOfCells(level); ++id)
+            {
+                if (dirty[level_offsets[level] + id])
+                {
+                    const auto parent = parents[level_offsets[level] + id];
+                    BOOST_ASSERT(dirty[level_offsets[level + 1] + parent]);
+                    ++pending_children[level_offsets[level + 1] + parent];
+                }
+            }
+        }
+
+        std::vector<CellTask> ready_cells;
+        for (LevelID level = 1; level < number_of_levels; ++level)
         {
-            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, partition.GetNumberOfCells(level)),
-                              [&](const tbb::blocked_range<std::size_t> &range) {
-                                  auto &heap = heaps.local();
-                                  for (auto id = range.begin(), end = range.end(); id != end; ++id)
-                                  {
-                                      Customize(graph, heap, cells, level, id);
-                                  }
-                              });
+            for (CellID id = 0; id < partition.GetNumberOfCells(level); ++id)
+            {
+                const auto index = level_offsets[level] + id;
+                if (dirty[index] && pending_children[index] == 0)
+                {
+                    ready_cells.push_back({level, id});
+                }
+            }
         }
+
+        using Feeder = tbb::parallel_do_feeder<CellTask>;
+        tbb::parallel_do(
+            begin(ready_cells), end(ready_cells), [&](const CellTask &task, Feeder &feeder) {
+                CustomizeCell(graph, heaps, cells, task.level, task.id);
+
+                const LevelID parent_level = task.level + 1;
+                if (parent_level == number_of_levels)
+                    return;
+
+                const auto parent = parents[level_offsets[task.level] + task.id];
+                BOOST_ASSERT(parent != INVALID_CELL_ID);
+                // the last child to finish schedules its parent
+                if (--pending_children[level_offsets[parent_level] + parent] == 0)
+                {
+                    feeder.add({parent_level, parent});
+                }
+            });
+    }
+
+    template <typename GraphT>
+    void CustomizeCell(const GraphT &graph,
+                       HeapPtr &heaps,
+                       partition::CellStorage &cells,
+                       LevelID level,
+                       CellID id) const
+    {
+        auto sources = cells.GetCell(level, id).GetSourceNodes();
+        const auto number_of_sources = static_cast<std::size_t>(sources.size());
+        if (number_of_sources < PARALLEL_SOURCES_THRESHOLD)
+        {
+            auto &heap = heaps.local();
+            for (auto source : sources)
+            {
+                CustomizeSource(graph, heap, cells, level, id, source);
+            }
+            return;
+        }
+
+        // Every search writes to its own row of the cell. The thread-local heap is only
+        // used within a chunk, which can not be interrupted by other tasks of this thread.
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0, number_of_sources, 8),
+                          [&](const tbb::blocked_range<std::size_t> &range) {
+                              auto &heap = heaps.local();
+                              for (auto index = range.begin(); index != range.end(); ++index)
+                              {
+                                  CustomizeSource(graph, heap, cells, level, id, sources[index]);
+                              }
+                          });
+    }
+
+    template <typename GraphT>
+    void CustomizeSource(const GraphT &graph,
+                         Heap &heap,
+                         partition::CellStorage &cells,
+                         LevelID level,
+                         CellID id,
+                         NodeID source) const
+    {
+        auto cell = cells.GetCell(level, id);
+        auto destinations = cell.GetDestinationNodes();
+
+        std::unordered_set<NodeID> destinations_set(destinations.begin(), destinations.end());
+        heap.Clear();
+        heap.Insert(source, 0, {false, 0});
+
+        // explore search space
+        while (!heap.Empty() && !destinations_set.empty())
+        {
+            const NodeID node = heap.DeleteMin();
+            const EdgeWeight weight = heap.GetKey(node);
+            const EdgeDuration duration = heap.GetData(node).duration;
+
+            if (level == 1)
+                RelaxNode<true>(graph, cells, heap, level, node, weight, duration);
+            else
+                RelaxNode<false>(graph, cells, heap, level, node, weight, duration);
+
+            destinations_set.erase(node);
+        }
+
+        // fill a map of destination nodes to placeholder pointers
+        auto weights = cell.GetOutWeight(source);
+        auto durations = cell.GetOutDuration(source);
+        for (auto &destination : destinations)
+        {
+            BOOST_ASSERT(!weights.empty());
+            BOOST_ASSERT(!durations.empty());
+
+            const bool inserted = heap.WasInserted(destination);
+            weights.front() = inserted ? heap.GetKey(destination) : INVALID_EDGE_WEIGHT;
+            durations.front() =
+                inserted ? heap.GetData(destination).duration : MAXIMAL_EDGE_DURATION;
+
+            weights.advance_begin(1);
+            durations.advance_begin(1);
+        }
+        BOOST_ASSERT(weights.empty());
+        BOOST_ASSERT(durations.empty());
     }
 
-  private:
     template <bool first_level, typename GraphT>
     void RelaxNode(const GraphT &graph,
                    const partition::CellStorage &cells,
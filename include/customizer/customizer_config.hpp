@@ -15,7 +15,7 @@ namespace customizer
 
 struct CustomizationConfig
 {
-    CustomizationConfig() : requested_num_threads(0) {}
+    CustomizationConfig() : requested_num_threads(0), incremental(false) {}
 
     void UseDefaults()
     {
@@ -35,6 +35,7 @@ struct CustomizationConfig
         edge_based_graph_path = basepath + ".osrm.ebg";
         mld_partition_path = basepath + ".osrm.partition";
         mld_storage_path = basepath + ".osrm.cells";
+        cell_updates_path = basepath + ".osrm.cell_updates";
         mld_graph_path = basepath + ".osrm.mldgr";
 
         updater_config.osrm_input_path = basepath + ".osrm";
@@ -46,9 +47,13 @@ struct CustomizationConfig
     boost::filesystem::path edge_based_graph_path;
     boost::filesystem::path mld_partition_path;
     boost::filesystem::path mld_storage_path;
+    // the updated nodes of the last customization of mld_storage_path
+    boost::filesystem::path cell_updates_path;
     boost::filesystem::path mld_graph_path;
 
     unsigned requested_num_threads;
+    // only recompute the cells affected by the segment speed and turn penalty updates
+    bool incremental;
 
     updater::UpdaterConfig updater_config;
 };
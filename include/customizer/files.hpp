@@ -0,0 +1,43 @@
+#ifndef OSRM_CUSTOMIZER_FILES_HPP
+#define OSRM_CUSTOMIZER_FILES_HPP
+
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <vector>
+
+namespace osrm
+{
+namespace customizer
+{
+namespace files
+{
+
+// reads .osrm.cell_updates file
+inline void readUpdatedNodes(const boost::filesystem::path &path,
+                             std::vector<NodeID> &updated_nodes)
+{
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    storage::serialization::read(reader, updated_nodes);
+}
+
+// writes .osrm.cell_updates file
+inline void writeUpdatedNodes(const boost::filesystem::path &path,
+                              const std::vector<NodeID> &updated_nodes)
+{
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    storage::serialization::write(writer, updated_nodes);
+}
+}
+}
+}
+
+#endif
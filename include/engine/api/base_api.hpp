@@ -4,9 +4,12 @@
 #include "engine/api/base_parameters.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 
+#include "engine/api/binary_factory.hpp"
 #include "engine/api/json_factory.hpp"
 #include "engine/hint.hpp"
 
+#include "util/binary_writer.hpp"
+
 #include <boost/assert.hpp>
 #include <boost/range/algorithm/transform.hpp>
 
@@ -66,6 +69,31 @@ class BaseAPI
         }
     }
 
+    void WriteWaypoints(const std::vector<PhantomNodes> &segment_end_coordinates,
+                        util::binary::Writer &writer) const
+    {
+        BOOST_ASSERT(parameters.coordinates.size() > 0);
+        BOOST_ASSERT(parameters.coordinates.size() == segment_end_coordinates.size() + 1);
+
+        writer.UInt32(static_cast<std::uint32_t>(parameters.coordinates.size()));
+        WriteWaypoint(segment_end_coordinates.front().source_phantom, writer);
+        for (const auto &phantom_pair : segment_end_coordinates)
+        {
+            WriteWaypoint(phantom_pair.target_phantom, writer);
+        }
+    }
+
+    void WriteWaypoint(const PhantomNode &phantom, util::binary::Writer &writer) const
+    {
+        // an empty hint if no hints are requested
+        binary::writeWaypoint(
+            writer,
+            phantom.location,
+            facade.GetNameForID(facade.GetNameIndex(phantom.forward_segment_id.id)).to_string(),
+            parameters.generate_hints ? Hint{phantom, facade.GetCheckSum()}.ToBase64()
+                                      : std::string{});
+    }
+
     const datafacade::BaseDataFacade &facade;
     const BaseParameters &parameters;
 };
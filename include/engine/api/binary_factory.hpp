@@ -0,0 +1,66 @@
+#ifndef ENGINE_API_BINARY_FACTORY_HPP
+#define ENGINE_API_BINARY_FACTORY_HPP
+
+#include "util/binary_writer.hpp"
+#include "util/coordinate.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+namespace api
+{
+namespace binary
+{
+
+// The layout of the binary response format is documented in docs/http.md
+const constexpr char BINARY_FORMAT_MAGIC[4] = {'O', 'S', 'R', 'M'};
+const constexpr std::uint32_t BINARY_FORMAT_VERSION = 1;
+
+inline void writeHeader(util::binary::Writer &writer,
+                        const std::string &code,
+                        const std::string &message)
+{
+    writer.Bytes(BINARY_FORMAT_MAGIC, sizeof(BINARY_FORMAT_MAGIC));
+    writer.UInt32(BINARY_FORMAT_VERSION);
+    writer.String(code);
+    writer.String(message);
+}
+
+// Fixed point longitude and latitude with COORDINATE_PRECISION, as stored internally
+inline void writeCoordinate(util::binary::Writer &writer, const util::Coordinate coordinate)
+{
+    writer.Int32(static_cast<std::int32_t>(coordinate.lon));
+    writer.Int32(static_cast<std::int32_t>(coordinate.lat));
+}
+
+template <typename ForwardIter>
+void writeCoordinates(util::binary::Writer &writer, ForwardIter begin, ForwardIter end)
+{
+    writer.UInt32(static_cast<std::uint32_t>(std::distance(begin, end)));
+    for (; begin != end; ++begin)
+    {
+        writeCoordinate(writer, *begin);
+    }
+}
+
+inline void writeWaypoint(util::binary::Writer &writer,
+                          const util::Coordinate location,
+                          const std::string &name,
+                          const std::string &hint)
+{
+    writeCoordinate(writer, location);
+    writer.String(name);
+    writer.String(hint);
+}
+
+} // ns binary
+} // ns api
+} // ns engine
+} // ns osrm
+
+#endif // ENGINE_API_BINARY_FACTORY_HPP
@@ -19,9 +19,11 @@
 
 #include "engine/internal_route_result.hpp"
 
+#include "util/binary_writer.hpp"
 #include "util/coordinate.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_util.hpp"
+#include "util/metrics.hpp"
 
 #include <iterator>
 #include <vector>
@@ -44,6 +46,7 @@ class RouteAPI : public BaseAPI
     void MakeResponse(const InternalManyRoutesResult &raw_routes,
                       util::json::Object &response) const
     {
+        util::metrics::StageScope rendering(util::metrics::Stage::Rendering);
         BOOST_ASSERT(!raw_routes.routes.empty());
 
         util::json::Array jsRoutes;
@@ -65,7 +68,97 @@ class RouteAPI : public BaseAPI
         response.values["code"] = "Ok";
     }
 
+    // Binary format with the summary and overview geometry of each route,
+    // steps and annotations are not part of it.
+    void MakeResponse(const InternalManyRoutesResult &raw_routes,
+                      util::binary::Writer &writer) const
+    {
+        util::metrics::StageScope rendering(util::metrics::Stage::Rendering);
+        BOOST_ASSERT(!raw_routes.routes.empty());
+
+        binary::writeHeader(writer, "Ok", "");
+        BaseAPI::WriteWaypoints(raw_routes.routes[0].segment_end_coordinates, writer);
+
+        const auto number_of_routes =
+            std::count_if(raw_routes.routes.begin(),
+                          raw_routes.routes.end(),
+                          [](const InternalRouteResult &route) { return route.is_valid(); });
+        writer.UInt32(static_cast<std::uint32_t>(number_of_routes));
+
+        for (const auto &route : raw_routes.routes)
+        {
+            if (!route.is_valid())
+                continue;
+
+            WriteRoute(route.segment_end_coordinates,
+                       route.unpacked_path_segments,
+                       route.source_traversed_in_reverse,
+                       route.target_traversed_in_reverse,
+                       writer);
+        }
+    }
+
   protected:
+    void WriteRoute(const std::vector<PhantomNodes> &segment_end_coordinates,
+                    const std::vector<std::vector<PathData>> &unpacked_path_segments,
+                    const std::vector<bool> &source_traversed_in_reverse,
+                    const std::vector<bool> &target_traversed_in_reverse,
+                    util::binary::Writer &writer) const
+    {
+        util::metrics::StageScope guidance(util::metrics::Stage::Guidance);
+        std::vector<guidance::RouteLeg> legs;
+        std::vector<guidance::LegGeometry> leg_geometries;
+        const auto number_of_legs = segment_end_coordinates.size();
+        legs.reserve(number_of_legs);
+        leg_geometries.reserve(number_of_legs);
+
+        for (auto idx : util::irange<std::size_t>(0UL, number_of_legs))
+        {
+            const auto &phantoms = segment_end_coordinates[idx];
+            const auto &path_data = unpacked_path_segments[idx];
+
+            const bool reversed_source = source_traversed_in_reverse[idx];
+            const bool reversed_target = target_traversed_in_reverse[idx];
+
+            auto leg_geometry = guidance::assembleGeometry(BaseAPI::facade,
+                                                           path_data,
+                                                           phantoms.source_phantom,
+                                                           phantoms.target_phantom,
+                                                           reversed_source,
+                                                           reversed_target);
+            legs.push_back(guidance::assembleLeg(facade,
+                                                 path_data,
+                                                 leg_geometry,
+                                                 phantoms.source_phantom,
+                                                 phantoms.target_phantom,
+                                                 reversed_target,
+                                                 false));
+            leg_geometries.push_back(std::move(leg_geometry));
+        }
+
+        const auto route = guidance::assembleRoute(legs);
+        writer.Float(static_cast<float>(route.distance));
+        writer.Float(static_cast<float>(route.duration));
+        writer.Float(static_cast<float>(route.weight));
+
+        writer.UInt32(static_cast<std::uint32_t>(legs.size()));
+        for (const auto &leg : legs)
+        {
+            writer.Float(static_cast<float>(leg.distance));
+            writer.Float(static_cast<float>(leg.duration));
+            writer.Float(static_cast<float>(leg.weight));
+        }
+
+        std::vector<util::Coordinate> overview;
+        if (parameters.overview != RouteParameters::OverviewType::False)
+        {
+            const auto use_simplification =
+                parameters.overview == RouteParameters::OverviewType::Simplified;
+            overview = guidance::assembleOverview(leg_geometries, use_simplification);
+        }
+        binary::writeCoordinates(writer, overview.begin(), overview.end());
+    }
+
     template <typename ForwardIter>
     util::json::Value MakeGeometry(ForwardIter begin, ForwardIter end) const
     {
@@ -101,6 +194,7 @@ class RouteAPI : public BaseAPI
                                  const std::vector<bool> &source_traversed_in_reverse,
                                  const std::vector<bool> &target_traversed_in_reverse) const
     {
+        util::metrics::StageScope guidance(util::metrics::Stage::Guidance);
         std::vector<guidance::RouteLeg> legs;
         std::vector<guidance::LegGeometry> leg_geometries;
         auto number_of_legs = segment_end_coordinates.size();
@@ -15,11 +15,15 @@
 
 #include "engine/internal_route_result.hpp"
 
+#include "util/binary_writer.hpp"
 #include "util/integer_range.hpp"
+#include "util/json_writer.hpp"
+#include "util/metrics.hpp"
 
 #include <boost/range/algorithm/transform.hpp>
 
 #include <iterator>
+#include <limits>
 
 namespace osrm
 {
@@ -40,6 +44,7 @@ class TableAPI final : public BaseAPI
                               const std::vector<PhantomNode> &phantoms,
                               util::json::Object &response) const
     {
+        util::metrics::StageScope rendering(util::metrics::Stage::Rendering);
         auto number_of_sources = parameters.sources.size();
         auto number_of_destinations = parameters.destinations.size();
 
@@ -69,6 +74,74 @@ class TableAPI final : public BaseAPI
         response.values["code"] = "Ok";
     }
 
+    // Binary format, durations are a contiguous row-major array of float seconds
+    virtual void MakeResponse(const std::vector<EdgeWeight> &durations,
+                              const std::vector<PhantomNode> &phantoms,
+                              util::binary::Writer &writer) const
+    {
+        util::metrics::StageScope rendering(util::metrics::Stage::Rendering);
+        const auto number_of_sources =
+            parameters.sources.empty() ? phantoms.size() : parameters.sources.size();
+        const auto number_of_destinations =
+            parameters.destinations.empty() ? phantoms.size() : parameters.destinations.size();
+        BOOST_ASSERT(durations.size() == number_of_sources * number_of_destinations);
+
+        binary::writeHeader(writer, "Ok", "");
+        writer.UInt32(static_cast<std::uint32_t>(number_of_sources));
+        writer.UInt32(static_cast<std::uint32_t>(number_of_destinations));
+        WriteWaypoints(phantoms, parameters.sources, writer);
+        WriteWaypoints(phantoms, parameters.destinations, writer);
+
+        for (const auto duration : durations)
+        {
+            writer.Float(duration == MAXIMAL_EDGE_DURATION
+                             ? std::numeric_limits<float>::quiet_NaN()
+                             : static_cast<float>(duration / 10.));
+        }
+    }
+
+    // Streams the response, so the durations are never stored as json::Value nodes
+    virtual void MakeResponse(const std::vector<EdgeWeight> &durations,
+                              const std::vector<PhantomNode> &phantoms,
+                              util::json::Writer &writer) const
+    {
+        util::metrics::StageScope rendering(util::metrics::Stage::Rendering);
+        auto number_of_sources = parameters.sources.size();
+        auto number_of_destinations = parameters.destinations.size();
+
+        writer.StartObject();
+
+        // symmetric case
+        writer.Key("sources");
+        if (parameters.sources.empty())
+        {
+            writer.Value(MakeWaypoints(phantoms));
+            number_of_sources = phantoms.size();
+        }
+        else
+        {
+            writer.Value(MakeWaypoints(phantoms, parameters.sources));
+        }
+
+        writer.Key("destinations");
+        if (parameters.destinations.empty())
+        {
+            writer.Value(MakeWaypoints(phantoms));
+            number_of_destinations = phantoms.size();
+        }
+        else
+        {
+            writer.Value(MakeWaypoints(phantoms, parameters.destinations));
+        }
+
+        writer.Key("durations");
+        WriteTable(durations, number_of_sources, number_of_destinations, writer);
+        writer.Key("code");
+        writer.String("Ok");
+
+        writer.EndObject();
+    }
+
   protected:
     virtual util::json::Array MakeWaypoints(const std::vector<PhantomNode> &phantoms) const
     {
@@ -97,6 +170,28 @@ class TableAPI final : public BaseAPI
         return json_waypoints;
     }
 
+    // All phantoms if no indices are given
+    virtual void WriteWaypoints(const std::vector<PhantomNode> &phantoms,
+                                const std::vector<std::size_t> &indices,
+                                util::binary::Writer &writer) const
+    {
+        if (indices.empty())
+        {
+            for (const auto &phantom : phantoms)
+            {
+                BaseAPI::WriteWaypoint(phantom, writer);
+            }
+        }
+        else
+        {
+            for (const auto index : indices)
+            {
+                BOOST_ASSERT(index < phantoms.size());
+                BaseAPI::WriteWaypoint(phantoms[index], writer);
+            }
+        }
+    }
+
     virtual util::json::Array MakeTable(const std::vector<EdgeWeight> &values,
                                         std::size_t number_of_rows,
                                         std::size_t number_of_columns) const
@@ -123,6 +218,32 @@ class TableAPI final : public BaseAPI
         return json_table;
     }
 
+    virtual void WriteTable(const std::vector<EdgeWeight> &values,
+                            std::size_t number_of_rows,
+                            std::size_t number_of_columns,
+                            util::json::Writer &writer) const
+    {
+        writer.StartArray();
+        for (const auto row : util::irange<std::size_t>(0UL, number_of_rows))
+        {
+            writer.StartArray();
+            for (const auto column : util::irange<std::size_t>(0UL, number_of_columns))
+            {
+                const auto duration = values[row * number_of_columns + column];
+                if (duration == MAXIMAL_EDGE_DURATION)
+                {
+                    writer.Null();
+                }
+                else
+                {
+                    writer.Number(duration / 10.);
+                }
+            }
+            writer.EndArray();
+        }
+        writer.EndArray();
+    }
+
     const TableParameters &parameters;
 };
 
@@ -2,12 +2,17 @@
 #define OSRM_ENGINE_DATA_WATCHDOG_HPP
 
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
+#include "engine/datafacade/numa_replica_allocator.hpp"
 #include "engine/datafacade/shared_memory_allocator.hpp"
+#include "engine/result_cache.hpp"
 
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
 #include "storage/shared_monitor.hpp"
 
+#include "util/epoch.hpp"
+#include "util/numa.hpp"
+
 #include <boost/interprocess/sync/named_upgradable_mutex.hpp>
 #include <boost/thread/lock_types.hpp>
 #include <boost/thread/locks.hpp>
@@ -15,6 +20,7 @@
 
 #include <memory>
 #include <thread>
+#include <vector>
 
 namespace osrm
 {
@@ -24,22 +30,39 @@ namespace engine
 // This class monitors the shared memory region that contains the pointers to
 // the data and layout regions that should be used. This region is updated
 // once a new dataset arrives.
+// Requests get the current facade through an epoch::ReadGuard. The old facade and with it the
+// old shared memory regions are released once no request uses them anymore.
+// With NUMA replication there is one facade per node, each with its own copy of the metric.
+// The result cache is cleared whenever the dataset changes.
 template <typename AlgorithmT> class DataWatchdog final
 {
     using mutex_type = typename storage::SharedMonitor<storage::SharedDataTimestamp>::mutex_type;
     using FacadeT = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
 
   public:
-    DataWatchdog() : active(true), timestamp(0)
+    // With warm_up set the pages of every dataset are touched before its facade is used
+    explicit DataWatchdog(const bool warm_up = false,
+                          const bool numa_replicate = false,
+                          ResultCache *result_cache = nullptr)
+        : warm_up(warm_up), result_cache(result_cache), active(true), timestamp(0)
     {
+        const auto num_facades = numa_replicate ? util::numa::getNodeCount() : 1;
+        for (unsigned node = 0; node < num_facades; ++node)
+        {
+            facades.push_back(std::make_unique<util::EpochPointer<const FacadeT>>());
+        }
+
         // create the initial facade before launching the watchdog thread
+        std::shared_ptr<datafacade::ContiguousBlockAllocator> allocator;
         {
             boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
-            facade = std::make_shared<const FacadeT>(
-                std::make_unique<datafacade::SharedMemoryAllocator>(barrier.data().region));
+            allocator = std::make_shared<datafacade::SharedMemoryAllocator>(
+                barrier.data().region, barrier.data().metric_region);
             timestamp = barrier.data().timestamp;
         }
+        WarmUp(*allocator);
+        Update(MakeFacades(std::move(allocator)));
 
         watcher = std::thread(&DataWatchdog::Run, this);
     }
@@ -51,28 +74,98 @@ template <typename AlgorithmT> class DataWatchdog final
         watcher.join();
     }
 
-    std::shared_ptr<const FacadeT> Get() const { return facade; }
+    util::EpochHandle<const FacadeT> Get() const
+    {
+        if (facades.size() == 1)
+            return facades.front()->Acquire();
+
+        return facades[util::numa::getCurrentNode() % facades.size()]->Acquire();
+    }
 
   private:
+    using FacadeList = std::vector<std::unique_ptr<const FacadeT>>;
+
+    // With NUMA replication this copies the metric once per node, so like the warm-up it runs
+    // without the region lock.
+    FacadeList MakeFacades(std::shared_ptr<datafacade::ContiguousBlockAllocator> allocator) const
+    {
+        FacadeList next_facades;
+        if (facades.size() == 1)
+        {
+            next_facades.push_back(std::make_unique<const FacadeT>(std::move(allocator)));
+        }
+        else
+        {
+            for (unsigned node = 0; node < facades.size(); ++node)
+            {
+                next_facades.push_back(std::make_unique<const FacadeT>(
+                    std::make_shared<datafacade::NumaReplicaAllocator>(allocator, node)));
+            }
+        }
+        return next_facades;
+    }
+
+    // Touches every page of the dataset, so it must run without the region lock. Otherwise
+    // osrm-datastore and every other osrm-routed process attaching to the region wait for it.
+    // The allocator keeps the regions attached after the lock is released.
+    void WarmUp(datafacade::ContiguousBlockAllocator &allocator) const
+    {
+        if (warm_up)
+        {
+            datafacade::warmUp(allocator);
+        }
+    }
+
+    void Update(FacadeList next_facades)
+    {
+        BOOST_ASSERT(next_facades.size() == facades.size());
+        for (std::size_t node = 0; node < facades.size(); ++node)
+        {
+            facades[node]->Update(std::move(next_facades[node]));
+        }
+    }
+
     void Run()
     {
         while (active)
         {
-            boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
-
-            while (active && timestamp == barrier.data().timestamp)
+            std::shared_ptr<datafacade::ContiguousBlockAllocator> allocator;
             {
-                barrier.wait(current_region_lock);
+                boost::interprocess::scoped_lock<mutex_type> current_region_lock(
+                    barrier.get_mutex());
+
+                while (active && timestamp == barrier.data().timestamp)
+                {
+                    barrier.wait(current_region_lock);
+                }
+
+                if (timestamp != barrier.data().timestamp)
+                {
+                    auto region = barrier.data().region;
+                    auto metric_region = barrier.data().metric_region;
+                    allocator =
+                        std::make_shared<datafacade::SharedMemoryAllocator>(region, metric_region);
+                    timestamp = barrier.data().timestamp;
+                    util::Log() << "updated facade to region " << region
+                                << " and metric region " << metric_region << " with timestamp "
+                                << timestamp;
+                }
             }
 
-            if (timestamp != barrier.data().timestamp)
+            // Replicates the metric and waits for the requests on the old facades without
+            // blocking osrm-datastore
+            if (allocator)
             {
-                auto region = barrier.data().region;
-                facade = std::make_shared<const FacadeT>(
-                    std::make_unique<datafacade::SharedMemoryAllocator>(region));
-                timestamp = barrier.data().timestamp;
-                util::Log() << "updated facade to region " << region << " with timestamp "
-                            << timestamp;
+                WarmUp(*allocator);
+                auto next_facades = MakeFacades(std::move(allocator));
+
+                // Invalidating before and after the switch rejects all responses of the old
+                // dataset, only requests racing with the switch itself may still hit them.
+                if (result_cache)
+                    result_cache->Invalidate();
+                Update(std::move(next_facades));
+                if (result_cache)
+                    result_cache->Invalidate();
             }
         }
 
@@ -81,9 +174,12 @@ template <typename AlgorithmT> class DataWatchdog final
 
     storage::SharedMonitor<storage::SharedDataTimestamp> barrier;
     std::thread watcher;
+    const bool warm_up;
+    ResultCache *const result_cache;
     bool active;
     unsigned timestamp;
-    std::shared_ptr<const FacadeT> facade;
+    // EpochPointer can't be moved, so they are kept by pointer
+    std::vector<std::unique_ptr<util::EpochPointer<const FacadeT>>> facades;
 };
 }
 }
@@ -2,6 +2,10 @@
 #define OSRM_ENGINE_DATAFACADE_CONTIGUOUS_BLOCK_ALLOCATOR_HPP_
 
 #include "storage/shared_datatype.hpp"
+#include "storage/warm_up.hpp"
+
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
 
 namespace osrm
 {
@@ -18,8 +22,26 @@ class ContiguousBlockAllocator
     // interface to give access to the datafacades
     virtual storage::DataLayout &GetLayout() = 0;
     virtual char *GetMemory() = 0;
+
+    // The metric blocks (see DataLayout::IsMetricBlock) can be stored in separate memory
+    virtual storage::DataLayout &GetMetricLayout() { return GetLayout(); }
+    virtual char *GetMetricMemory() { return GetMemory(); }
 };
 
+// Populates the page tables for all memory of the allocator, see storage::warmUp
+inline void warmUp(ContiguousBlockAllocator &allocator)
+{
+    TIMER_START(warm_up);
+    auto touched = storage::warmUp(allocator.GetLayout(), allocator.GetMemory());
+    if (allocator.GetMetricMemory() != allocator.GetMemory())
+    {
+        touched += storage::warmUp(allocator.GetMetricLayout(), allocator.GetMetricMemory());
+    }
+    TIMER_STOP(warm_up);
+    util::Log() << "Warmed up " << (touched >> 20) << " MiB of data in " << TIMER_MSEC(warm_up)
+                << "ms";
+}
+
 } // namespace datafacade
 } // namespace engine
 } // namespace osrm
@@ -16,6 +16,7 @@
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "extractor/intersection_bearings_container.hpp"
 #include "extractor/node_data_container.hpp"
+#include "extractor/packed_geometry.hpp"
 #include "extractor/packed_osm_ids.hpp"
 #include "extractor/profile_properties.hpp"
 #include "extractor/segment_data_container.hpp"
@@ -97,7 +98,7 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CH> : public datafacade::Algor
         std::shared_ptr<ContiguousBlockAllocator> allocator_)
         : allocator(std::move(allocator_))
     {
-        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
+        InitializeInternalPointers(allocator->GetMetricLayout(), allocator->GetMetricMemory());
     }
 
     void InitializeInternalPointers(storage::DataLayout &data_layout, char *memory_block)
@@ -180,7 +181,7 @@ class ContiguousInternalMemoryAlgorithmDataFacade<CoreCH>
         std::shared_ptr<ContiguousBlockAllocator> allocator_)
         : allocator(std::move(allocator_))
     {
-        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
+        InitializeInternalPointers(allocator->GetMetricLayout(), allocator->GetMetricMemory());
     }
 
     void InitializeInternalPointers(storage::DataLayout &data_layout, char *memory_block)
@@ -224,6 +225,10 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     util::vector_view<TurnPenalty> m_turn_weight_penalties;
     util::vector_view<TurnPenalty> m_turn_duration_penalties;
     extractor::SegmentDataView segment_data;
+    // only set if the geometry node lists are packed, m_geometry_nodes is empty then
+    extractor::PackedGeometryView packed_geometry;
+    util::vector_view<unsigned> m_geometry_indices;
+    util::vector_view<NodeID> m_geometry_nodes;
     extractor::TurnDataView turn_data;
     extractor::EdgeBasedNodeDataView edge_based_node_data;
 
@@ -287,11 +292,14 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
             data_layout.GetBlockPtr<RTreeNode>(memory_block, storage::DataLayout::R_SEARCH_TREE);
         auto tree_level_sizes_ptr = data_layout.GetBlockPtr<std::uint64_t>(
             memory_block, storage::DataLayout::R_SEARCH_TREE_LEVELS);
+        auto projected_leaves_ptr = data_layout.GetBlockPtr<SharedRTree::ProjectedLeaf>(
+            memory_block, storage::DataLayout::R_SEARCH_TREE_PROJECTED_LEAVES);
         m_static_rtree.reset(
             new SharedRTree(tree_nodes_ptr,
                             data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE],
                             tree_level_sizes_ptr,
                             data_layout.num_entries[storage::DataLayout::R_SEARCH_TREE_LEVELS],
+                            projected_leaves_ptr,
                             file_index_path,
                             m_coordinate_list));
         m_geospatial_query.reset(
@@ -432,11 +440,34 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         util::vector_view<unsigned> geometry_begin_indices(
             geometries_index_ptr, data_layout.num_entries[storage::DataLayout::GEOMETRIES_INDEX]);
 
-        auto num_entries = data_layout.num_entries[storage::DataLayout::GEOMETRIES_NODE_LIST];
+        m_geometry_indices = geometry_begin_indices;
+
+        // the node list is empty if the geometry is packed, the datasources are never packed
+        auto num_entries = data_layout.num_entries[storage::DataLayout::DATASOURCES_LIST];
 
         auto geometries_node_list_ptr = data_layout.GetBlockPtr<NodeID>(
             memory_block, storage::DataLayout::GEOMETRIES_NODE_LIST);
-        util::vector_view<NodeID> geometry_node_list(geometries_node_list_ptr, num_entries);
+        util::vector_view<NodeID> geometry_node_list(
+            geometries_node_list_ptr,
+            data_layout.num_entries[storage::DataLayout::GEOMETRIES_NODE_LIST]);
+        m_geometry_nodes = geometry_node_list;
+
+        auto packed_first_nodes_ptr = data_layout.GetBlockPtr<NodeID>(
+            memory_block, storage::DataLayout::GEOMETRIES_PACKED_FIRST_NODES);
+        auto packed_blocks_ptr = data_layout.GetBlockPtr<extractor::PackedGeometryBlock>(
+            memory_block, storage::DataLayout::GEOMETRIES_PACKED_BLOCKS);
+        auto packed_words_ptr = data_layout.GetBlockPtr<extractor::PackedGeometryView::WordT>(
+            memory_block, storage::DataLayout::GEOMETRIES_PACKED_WORDS);
+        packed_geometry = extractor::PackedGeometryView{
+            util::vector_view<NodeID>(
+                packed_first_nodes_ptr,
+                data_layout.num_entries[storage::DataLayout::GEOMETRIES_PACKED_FIRST_NODES]),
+            util::vector_view<extractor::PackedGeometryBlock>(
+                packed_blocks_ptr,
+                data_layout.num_entries[storage::DataLayout::GEOMETRIES_PACKED_BLOCKS]),
+            util::vector_view<extractor::PackedGeometryView::WordT>(
+                packed_words_ptr,
+                data_layout.num_entries[storage::DataLayout::GEOMETRIES_PACKED_WORDS])};
 
         auto geometries_fwd_weight_list_ptr =
             data_layout.GetBlockPtr<extractor::SegmentDataView::SegmentWeightVector::block_type>(
@@ -525,14 +556,18 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         m_entry_class_table = std::move(entry_class_table);
     }
 
-    void InitializeInternalPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeInternalPointers(storage::DataLayout &data_layout,
+                                    char *memory_block,
+                                    storage::DataLayout &metric_layout,
+                                    char *metric_memory_block)
     {
-        InitializeChecksumPointer(data_layout, memory_block);
+        InitializeChecksumPointer(metric_layout, metric_memory_block);
+        InitializeTurnPenalties(metric_layout, metric_memory_block);
+        InitializeGeometryPointers(metric_layout, metric_memory_block);
+
         InitializeNodeInformationPointers(data_layout, memory_block);
         InitializeEdgeBasedNodeDataInformationPointers(data_layout, memory_block);
         InitializeEdgeInformationPointers(data_layout, memory_block);
-        InitializeTurnPenalties(data_layout, memory_block);
-        InitializeGeometryPointers(data_layout, memory_block);
         InitializeTimestampPointer(data_layout, memory_block);
         InitializeNamePointers(data_layout, memory_block);
         InitializeTurnLaneDescriptionsPointers(data_layout, memory_block);
@@ -547,7 +582,10 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     ContiguousInternalMemoryDataFacadeBase(std::shared_ptr<ContiguousBlockAllocator> allocator_)
         : allocator(std::move(allocator_))
     {
-        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
+        InitializeInternalPointers(allocator->GetLayout(),
+                                   allocator->GetMemory(),
+                                   allocator->GetMetricLayout(),
+                                   allocator->GetMetricMemory());
     }
 
     // node and edge information access
@@ -561,63 +599,66 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         return m_osmnodeid_list[id];
     }
 
-    std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID id) const override final
+    NodeForwardRange GetUncompressedForwardGeometry(const EdgeID id) const override final
     {
+        const auto begin = m_geometry_indices[id];
+        const auto end = m_geometry_indices[id + 1];
+
+        if (!packed_geometry.empty())
+        {
+            if (begin == end)
+                return NodeForwardRange{extractor::GeometryIterator{&packed_geometry, begin, 0},
+                                        extractor::GeometryIterator{&packed_geometry, end, 0}};
+
+            // the end iterator needs the last node to iterate backwards
+            return NodeForwardRange{
+                extractor::GeometryIterator{
+                    &packed_geometry, begin, packed_geometry.GetFirstNode(id)},
+                extractor::GeometryIterator{
+                    &packed_geometry, end, packed_geometry.GetLastNode(id, begin, end)}};
+        }
 
-        auto range = segment_data.GetForwardGeometry(id);
-        return std::vector<NodeID>{range.begin(), range.end()};
+        return NodeForwardRange{extractor::GeometryIterator{m_geometry_nodes.data() + begin},
+                                extractor::GeometryIterator{m_geometry_nodes.data() + end}};
     }
 
-    virtual std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID id) const override final
+    NodeReverseRange GetUncompressedReverseGeometry(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseGeometry(id);
-        return std::vector<NodeID>{range.begin(), range.end()};
+        return NodeReverseRange{GetUncompressedForwardGeometry(id)};
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedForwardDurations(const EdgeID id) const override final
+    DurationForwardRange GetUncompressedForwardDurations(const EdgeID id) const override final
     {
-        auto range = segment_data.GetForwardDurations(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        return segment_data.GetForwardDurations(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedReverseDurations(const EdgeID id) const override final
+    DurationReverseRange GetUncompressedReverseDurations(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseDurations(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        return segment_data.GetReverseDurations(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedForwardWeights(const EdgeID id) const override final
+    WeightForwardRange GetUncompressedForwardWeights(const EdgeID id) const override final
     {
-        auto range = segment_data.GetForwardWeights(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        return segment_data.GetForwardWeights(id);
     }
 
-    virtual std::vector<EdgeWeight>
-    GetUncompressedReverseWeights(const EdgeID id) const override final
+    WeightReverseRange GetUncompressedReverseWeights(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseWeights(id);
-        return std::vector<EdgeWeight>{range.begin(), range.end()};
+        return segment_data.GetReverseWeights(id);
     }
 
     // Returns the data source ids that were used to supply the edge
     // weights.
-    virtual std::vector<DatasourceID>
-    GetUncompressedForwardDatasources(const EdgeID id) const override final
+    DatasourceForwardRange GetUncompressedForwardDatasources(const EdgeID id) const override final
     {
-        auto range = segment_data.GetForwardDatasources(id);
-        return std::vector<DatasourceID>{range.begin(), range.end()};
+        return segment_data.GetForwardDatasources(id);
     }
 
     // Returns the data source ids that were used to supply the edge
     // weights.
-    virtual std::vector<DatasourceID>
-    GetUncompressedReverseDatasources(const EdgeID id) const override final
+    DatasourceReverseRange GetUncompressedReverseDatasources(const EdgeID id) const override final
     {
-        auto range = segment_data.GetReverseDatasources(id);
-        return std::vector<DatasourceID>{range.begin(), range.end()};
+        return segment_data.GetReverseDatasources(id);
     }
 
     virtual TurnPenalty GetWeightPenaltyForEdgeID(const unsigned id) const override final
@@ -766,6 +807,20 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
             input_coordinate, bearing, bearing_range, approach);
     }
 
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> &max_distances,
+        const std::vector<boost::optional<Bearing>> &bearings,
+        const std::vector<boost::optional<Approach>> &approaches,
+        const int max_threads) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        return m_geospatial_query->NearestPhantomNodesWithAlternativeFromBigComponent(
+            input_coordinates, max_distances, bearings, approaches, max_threads);
+    }
+
     unsigned GetCheckSum() const override final { return m_check_sum; }
 
     GeometryID GetGeometryIndex(const NodeID id) const override final
@@ -924,13 +979,17 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
 
     QueryGraph query_graph;
 
-    void InitializeInternalPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializeInternalPointers(storage::DataLayout &data_layout,
+                                    char *memory_block,
+                                    storage::DataLayout &metric_layout,
+                                    char *metric_memory_block)
     {
-        InitializeMLDDataPointers(data_layout, memory_block);
-        InitializeGraphPointer(data_layout, memory_block);
+        InitializePartitionPointers(data_layout, memory_block);
+        InitializeCellStoragePointers(metric_layout, metric_memory_block);
+        InitializeGraphPointer(metric_layout, metric_memory_block);
     }
 
-    void InitializeMLDDataPointers(storage::DataLayout &data_layout, char *memory_block)
+    void InitializePartitionPointers(storage::DataLayout &data_layout, char *memory_block)
     {
         if (data_layout.GetBlockSize(storage::DataLayout::MLD_PARTITION) > 0)
         {
@@ -956,7 +1015,10 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
             mld_partition =
                 partition::MultiLevelPartitionView{level_data, partition, cell_to_children};
         }
+    }
 
+    void InitializeCellStoragePointers(storage::DataLayout &data_layout, char *memory_block)
+    {
         if (data_layout.GetBlockSize(storage::DataLayout::MLD_CELL_WEIGHTS) > 0)
         {
             BOOST_ASSERT(data_layout.GetBlockSize(storage::DataLayout::MLD_CELLS) > 0);
@@ -1040,7 +1102,10 @@ template <> class ContiguousInternalMemoryAlgorithmDataFacade<MLD> : public Algo
         std::shared_ptr<ContiguousBlockAllocator> allocator_)
         : allocator(std::move(allocator_))
     {
-        InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
+        InitializeInternalPointers(allocator->GetLayout(),
+                                   allocator->GetMemory(),
+                                   allocator->GetMetricLayout(),
+                                   allocator->GetMetricMemory());
     }
 
     const partition::MultiLevelPartitionView &GetMultiLevelPartition() const override
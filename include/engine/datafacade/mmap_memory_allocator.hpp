@@ -0,0 +1,42 @@
+#ifndef OSRM_ENGINE_DATAFACADE_MMAP_MEMORY_ALLOCATOR_HPP_
+#define OSRM_ENGINE_DATAFACADE_MMAP_MEMORY_ALLOCATOR_HPP_
+
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+#include "storage/storage_config.hpp"
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+/**
+ * This allocator maps a memory image file read-only into the process.
+ * The image holds the DataLayout and the memory block in the same format
+ * osrm-datastore uses for shared memory. It is created from the .osrm files
+ * on first use and whenever one of them is newer than the image, otherwise
+ * the data is served from the page cache without being copied. Processes
+ * using the same image share its pages.
+ */
+class MMapMemoryAllocator : public ContiguousBlockAllocator
+{
+  public:
+    explicit MMapMemoryAllocator(const storage::StorageConfig &config);
+    ~MMapMemoryAllocator() override final;
+
+    // interface to give access to the datafacades
+    storage::DataLayout &GetLayout() override final;
+    char *GetMemory() override final;
+
+  private:
+    boost::iostreams::mapped_file_source mapped_memory;
+};
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_DATAFACADE_MMAP_MEMORY_ALLOCATOR_HPP_
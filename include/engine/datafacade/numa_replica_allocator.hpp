@@ -0,0 +1,44 @@
+#ifndef OSRM_ENGINE_DATAFACADE_NUMA_REPLICA_ALLOCATOR_HPP_
+#define OSRM_ENGINE_DATAFACADE_NUMA_REPLICA_ALLOCATOR_HPP_
+
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+
+#include <memory>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+/**
+ * This allocator keeps a copy of the metric blocks of another allocator in memory
+ * of a single NUMA node. The metric blocks hold the graph and the weights which
+ * every query reads, so the threads of that node read them without crossing the
+ * interconnect. All other blocks are shared with the source allocator.
+ */
+class NumaReplicaAllocator : public ContiguousBlockAllocator
+{
+  public:
+    NumaReplicaAllocator(std::shared_ptr<ContiguousBlockAllocator> source, const unsigned node);
+    ~NumaReplicaAllocator() override final;
+
+    // interface to give access to the datafacades
+    storage::DataLayout &GetLayout() override final;
+    char *GetMemory() override final;
+    storage::DataLayout &GetMetricLayout() override final;
+    char *GetMetricMemory() override final;
+
+  private:
+    std::shared_ptr<ContiguousBlockAllocator> source;
+    storage::DataLayout metric_layout;
+    std::unique_ptr<char[]> metric_memory;
+    char *aligned_metric_memory;
+};
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
+
+#endif // OSRM_ENGINE_DATAFACADE_NUMA_REPLICA_ALLOCATOR_HPP_
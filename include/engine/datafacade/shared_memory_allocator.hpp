@@ -16,22 +16,27 @@ namespace datafacade
 {
 
 /**
-* This allocator uses an IPC shared memory block as the data location.
+* This allocator uses IPC shared memory blocks as the data location, one for the
+* static data and one for the metric.
 * Many SharedMemoryDataFacade objects can be created that point to the same shared
-* memory block.
+* memory blocks.
 */
 class SharedMemoryAllocator : public ContiguousBlockAllocator
 {
   public:
-    explicit SharedMemoryAllocator(storage::SharedDataType data_region);
+    SharedMemoryAllocator(storage::SharedDataType data_region,
+                          storage::SharedDataType metric_region);
     ~SharedMemoryAllocator() override final;
 
     // interface to give access to the datafacades
     storage::DataLayout &GetLayout() override final;
     char *GetMemory() override final;
+    storage::DataLayout &GetMetricLayout() override final;
+    char *GetMetricMemory() override final;
 
   private:
     std::unique_ptr<storage::SharedMemory> m_large_memory;
+    std::unique_ptr<storage::SharedMemory> m_metric_memory;
 };
 
 } // namespace datafacade
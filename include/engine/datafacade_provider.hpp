@@ -3,8 +3,16 @@
 
 #include "engine/data_watchdog.hpp"
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
+#include "engine/datafacade/mmap_memory_allocator.hpp"
+#include "engine/datafacade/numa_replica_allocator.hpp"
 #include "engine/datafacade/process_memory_allocator.hpp"
 
+#include "util/epoch.hpp"
+#include "util/numa.hpp"
+
+#include <memory>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -17,7 +25,8 @@ template <typename AlgorithmT> class DataFacadeProvider
   public:
     virtual ~DataFacadeProvider() = default;
 
-    virtual std::shared_ptr<const FacadeT> Get() const = 0;
+    // The facade stays valid as long as the handle lives, it must not leave the calling thread
+    virtual util::EpochHandle<const FacadeT> Get() const = 0;
 };
 
 template <typename AlgorithmT> class ImmutableProvider final : public DataFacadeProvider<AlgorithmT>
@@ -25,16 +34,48 @@ template <typename AlgorithmT> class ImmutableProvider final : public DataFacade
     using FacadeT = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
 
   public:
-    ImmutableProvider(const storage::StorageConfig &config)
-        : immutable_data_facade(std::make_shared<FacadeT>(
-              std::make_shared<datafacade::ProcessMemoryAllocator>(config)))
+    // With numa_replicate set every NUMA node gets a facade with its own copy of the metric
+    ImmutableProvider(const storage::StorageConfig &config,
+                      const bool use_mmap,
+                      const bool warm_up = false,
+                      const bool numa_replicate = false)
     {
+        std::shared_ptr<datafacade::ContiguousBlockAllocator> allocator;
+        if (use_mmap)
+            allocator = std::make_shared<datafacade::MMapMemoryAllocator>(config);
+        else
+            allocator = std::make_shared<datafacade::ProcessMemoryAllocator>(config);
+
+        if (warm_up)
+            datafacade::warmUp(*allocator);
+
+        const auto num_nodes = util::numa::getNodeCount();
+        if (numa_replicate && num_nodes > 1)
+        {
+            for (unsigned node = 0; node < num_nodes; ++node)
+            {
+                immutable_data_facades.push_back(std::make_shared<FacadeT>(
+                    std::make_shared<datafacade::NumaReplicaAllocator>(allocator, node)));
+            }
+        }
+        else
+        {
+            immutable_data_facades.push_back(std::make_shared<FacadeT>(std::move(allocator)));
+        }
     }
 
-    std::shared_ptr<const FacadeT> Get() const override final { return immutable_data_facade; }
+    util::EpochHandle<const FacadeT> Get() const override final
+    {
+        if (immutable_data_facades.size() == 1)
+            return util::EpochHandle<const FacadeT>(immutable_data_facades.front().get());
+
+        const auto node = util::numa::getCurrentNode() % immutable_data_facades.size();
+        return util::EpochHandle<const FacadeT>(immutable_data_facades[node].get());
+    }
 
   private:
-    std::shared_ptr<const FacadeT> immutable_data_facade;
+    // one facade per NUMA node, or a single one without replication
+    std::vector<std::shared_ptr<const FacadeT>> immutable_data_facades;
 };
 
 template <typename AlgorithmT> class WatchingProvider final : public DataFacadeProvider<AlgorithmT>
@@ -43,7 +84,14 @@ template <typename AlgorithmT> class WatchingProvider final : public DataFacadeP
     DataWatchdog<AlgorithmT> watchdog;
 
   public:
-    std::shared_ptr<const FacadeT> Get() const override final
+    explicit WatchingProvider(const bool warm_up = false,
+                              const bool numa_replicate = false,
+                              ResultCache *result_cache = nullptr)
+        : watchdog(warm_up, numa_replicate, result_cache)
+    {
+    }
+
+    util::EpochHandle<const FacadeT> Get() const override final
     {
         // We need a singleton here because multiple instances of DataWatchdog
         // conflict on shared memory mappings
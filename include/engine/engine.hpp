@@ -12,6 +12,7 @@
 #include "engine/datafacade_provider.hpp"
 #include "engine/engine_config.hpp"
 #include "engine/engine_config.hpp"
+#include "engine/result_cache.hpp"
 #include "engine/plugins/match.hpp"
 #include "engine/plugins/nearest.hpp"
 #include "engine/plugins/table.hpp"
@@ -20,11 +21,16 @@
 #include "engine/plugins/viaroute.hpp"
 #include "engine/routing_algorithms.hpp"
 #include "engine/status.hpp"
+#include "util/binary_writer.hpp"
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
+#include "util/metrics.hpp"
 
+#include <cstddef>
+#include <limits>
 #include <memory>
 #include <string>
 
@@ -39,8 +45,14 @@ class EngineInterface
     virtual ~EngineInterface() = default;
     virtual Status Route(const api::RouteParameters &parameters,
                          util::json::Object &result) const = 0;
+    virtual Status Route(const api::RouteParameters &parameters,
+                         util::binary::Writer &result) const = 0;
     virtual Status Table(const api::TableParameters &parameters,
                          util::json::Object &result) const = 0;
+    virtual Status Table(const api::TableParameters &parameters,
+                         util::json::Writer &result) const = 0;
+    virtual Status Table(const api::TableParameters &parameters,
+                         util::binary::Writer &result) const = 0;
     virtual Status Nearest(const api::NearestParameters &parameters,
                            util::json::Object &result) const = 0;
     virtual Status Trip(const api::TripParameters &parameters,
@@ -54,25 +66,38 @@ template <typename Algorithm> class Engine final : public EngineInterface
 {
   public:
     explicit Engine(const EngineConfig &config)
-        : route_plugin(config.max_locations_viaroute),       //
-          table_plugin(config.max_locations_distance_table), //
-          nearest_plugin(config.max_results_nearest),        //
-          trip_plugin(config.max_locations_trip),            //
-          match_plugin(config.max_locations_map_matching),   //
-          tile_plugin()                                      //
+        : result_cache(makeResultCache(config)),                                 //
+          heaps(maxHeapIndexMemory(config), config.max_threads_distance_table),  //
+          route_plugin(config.max_locations_viaroute, result_cache.get()),       //
+          table_plugin(config.max_locations_distance_table,                      //
+                       config.max_threads_distance_table,                        //
+                       result_cache.get()),                                      //
+          nearest_plugin(config.max_results_nearest, result_cache.get()),        //
+          trip_plugin(config.max_locations_trip),                                //
+          match_plugin(config.max_locations_map_matching),                       //
+          tile_plugin()                                                          //
 
     {
         if (config.use_shared_memory)
         {
             util::Log(logDEBUG) << "Using shared memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<WatchingProvider<Algorithm>>();
+            facade_provider = std::make_unique<WatchingProvider<Algorithm>>(
+                config.warm_up, config.numa_replicate, result_cache.get());
+        }
+        else if (config.use_mmap)
+        {
+            util::Log(logDEBUG) << "Using memory mapped files with algorithm "
+                                << routing_algorithms::name<Algorithm>();
+            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(
+                config.storage_config, true, config.warm_up, config.numa_replicate);
         }
         else
         {
             util::Log(logDEBUG) << "Using internal memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(config.storage_config);
+            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(
+                config.storage_config, false, config.warm_up, config.numa_replicate);
         }
     }
 
@@ -86,6 +111,16 @@ template <typename Algorithm> class Engine final : public EngineInterface
     Status Route(const api::RouteParameters &params,
                  util::json::Object &result) const override final
     {
+        util::metrics::RequestScope request(util::metrics::Endpoint::Route);
+        auto facade = facade_provider->Get();
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        return route_plugin.HandleRequest(*facade, algorithms, params, result);
+    }
+
+    Status Route(const api::RouteParameters &params,
+                 util::binary::Writer &result) const override final
+    {
+        util::metrics::RequestScope request(util::metrics::Endpoint::Route);
         auto facade = facade_provider->Get();
         auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
         return route_plugin.HandleRequest(*facade, algorithms, params, result);
@@ -94,6 +129,25 @@ template <typename Algorithm> class Engine final : public EngineInterface
     Status Table(const api::TableParameters &params,
                  util::json::Object &result) const override final
     {
+        util::metrics::RequestScope request(util::metrics::Endpoint::Table);
+        auto facade = facade_provider->Get();
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        return table_plugin.HandleRequest(*facade, algorithms, params, result);
+    }
+
+    Status Table(const api::TableParameters &params,
+                 util::json::Writer &result) const override final
+    {
+        util::metrics::RequestScope request(util::metrics::Endpoint::Table);
+        auto facade = facade_provider->Get();
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        return table_plugin.HandleRequest(*facade, algorithms, params, result);
+    }
+
+    Status Table(const api::TableParameters &params,
+                 util::binary::Writer &result) const override final
+    {
+        util::metrics::RequestScope request(util::metrics::Endpoint::Table);
         auto facade = facade_provider->Get();
         auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
         return table_plugin.HandleRequest(*facade, algorithms, params, result);
@@ -102,6 +156,7 @@ template <typename Algorithm> class Engine final : public EngineInterface
     Status Nearest(const api::NearestParameters &params,
                    util::json::Object &result) const override final
     {
+        util::metrics::RequestScope request(util::metrics::Endpoint::Nearest);
         auto facade = facade_provider->Get();
         auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
         return nearest_plugin.HandleRequest(*facade, algorithms, params, result);
@@ -109,6 +164,7 @@ template <typename Algorithm> class Engine final : public EngineInterface
 
     Status Trip(const api::TripParameters &params, util::json::Object &result) const override final
     {
+        util::metrics::RequestScope request(util::metrics::Endpoint::Trip);
         auto facade = facade_provider->Get();
         auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
         return trip_plugin.HandleRequest(*facade, algorithms, params, result);
@@ -117,6 +173,7 @@ template <typename Algorithm> class Engine final : public EngineInterface
     Status Match(const api::MatchParameters &params,
                  util::json::Object &result) const override final
     {
+        util::metrics::RequestScope request(util::metrics::Endpoint::Match);
         auto facade = facade_provider->Get();
         auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
         return match_plugin.HandleRequest(*facade, algorithms, params, result);
@@ -124,6 +181,7 @@ template <typename Algorithm> class Engine final : public EngineInterface
 
     Status Tile(const api::TileParameters &params, std::string &result) const override final
     {
+        util::metrics::RequestScope request(util::metrics::Endpoint::Tile);
         auto facade = facade_provider->Get();
         auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
         return tile_plugin.HandleRequest(*facade, algorithms, params, result);
@@ -132,6 +190,23 @@ template <typename Algorithm> class Engine final : public EngineInterface
     static bool CheckCompability(const EngineConfig &config);
 
   private:
+    static std::size_t maxHeapIndexMemory(const EngineConfig &config)
+    {
+        if (config.max_heap_index_memory_mb < 0)
+            return std::numeric_limits<std::size_t>::max();
+        return static_cast<std::size_t>(config.max_heap_index_memory_mb) * 1024 * 1024;
+    }
+
+    static std::unique_ptr<ResultCache> makeResultCache(const EngineConfig &config)
+    {
+        if (config.result_cache_size <= 0)
+            return nullptr;
+        util::Log() << "Caching up to " << config.result_cache_size << " responses";
+        return std::make_unique<ResultCache>(config.result_cache_size);
+    }
+
+    // declared first, the data watchdog invalidates it until it is stopped
+    std::unique_ptr<ResultCache> result_cache;
     std::unique_ptr<DataFacadeProvider<Algorithm>> facade_provider;
     mutable SearchEngineData<Algorithm> heaps;
 
@@ -152,7 +227,7 @@ bool Engine<routing_algorithms::ch::Algorithm>::CheckCompability(const EngineCon
         using mutex_type = typename decltype(barrier)::mutex_type;
         boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
-        auto mem = storage::makeSharedMemory(barrier.data().region);
+        auto mem = storage::makeSharedMemory(barrier.data().metric_region);
         auto layout = reinterpret_cast<storage::DataLayout *>(mem->Ptr());
         return layout->GetBlockSize(storage::DataLayout::CH_GRAPH_NODE_LIST) > 4 &&
                layout->GetBlockSize(storage::DataLayout::CH_GRAPH_EDGE_LIST) > 4;
@@ -183,7 +258,7 @@ bool Engine<routing_algorithms::corech::Algorithm>::CheckCompability(const Engin
         using mutex_type = typename decltype(barrier)::mutex_type;
         boost::interprocess::scoped_lock<mutex_type> current_region_lock(barrier.get_mutex());
 
-        auto mem = storage::makeSharedMemory(barrier.data().region);
+        auto mem = storage::makeSharedMemory(barrier.data().metric_region);
         auto layout = reinterpret_cast<storage::DataLayout *>(mem->Ptr());
         return layout->GetBlockSize(storage::DataLayout::CH_CORE_MARKER) >
                sizeof(std::uint64_t) + sizeof(util::FingerPrint);
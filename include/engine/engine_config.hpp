@@ -54,6 +54,26 @@ namespace engine
  *  - Nearest
  *
  * In addition, shared memory can be used for datasets loaded with osrm-datastore.
+ * With warm_up set all pages of a dataset are touched in the order queries use them before it
+ * serves the first query.
+ *
+ * With numa_replicate set every NUMA node of the machine gets its own copy of the graph and the
+ * weights, and each query reads the copy of the node its thread runs on. This costs the memory
+ * of the metric once per node. Pin the request threads to nodes for the best results.
+ *
+ * The per-thread search heaps index nodes with an array over all nodes of the graph as long as
+ * this index fits into max_heap_index_memory_mb (-1 for unlimited, 0 to always use hash maps).
+ * The budget applies to each heap, a thread keeps up to five of them (forward and reverse heaps
+ * for the shortest path and alternatives, and the many-to-many heap). Larger graphs fall back to
+ * hash map based heaps, trading query speed for memory.
+ *
+ * Distance tables can be computed on up to max_threads_distance_table threads per request
+ * (-1 for all available threads). The coordinates of a table request are snapped on as many
+ * threads.
+ *
+ * Up to result_cache_size responses of route, table and nearest requests are cached (0 to
+ * disable the cache). Requests that snap to the same locations with the same options are
+ * answered from the cache, until the dataset changes.
  *
  * You can chose between three algorithms:
  *  - Algorithm::CH
@@ -87,7 +107,13 @@ struct EngineConfig final
     int max_locations_distance_table = -1;
     int max_locations_map_matching = -1;
     int max_results_nearest = -1;
+    int max_heap_index_memory_mb = 256;
+    int max_threads_distance_table = 1;
     bool use_shared_memory = true;
+    bool use_mmap = false;
+    bool warm_up = false;
+    bool numa_replicate = false;
+    int result_cache_size = 0;
     Algorithm algorithm = Algorithm::CH;
 };
 }
@@ -2,6 +2,7 @@
 #define GEOSPATIAL_QUERY_HPP
 
 #include "engine/approach.hpp"
+#include "engine/bearing.hpp"
 #include "engine/phantom_node.hpp"
 #include "util/bearing.hpp"
 #include "util/coordinate_calculation.hpp"
@@ -11,6 +12,8 @@
 
 #include "osrm/coordinate.hpp"
 
+#include <boost/optional.hpp>
+
 #include <algorithm>
 #include <cmath>
 #include <memory>
@@ -28,6 +31,8 @@ inline std::pair<bool, bool> boolPairAnd(const std::pair<bool, bool> &A,
 }
 
 // Implements complex queries on top of an RTree and builds PhantomNodes from it.
+// The searches reuse the traversal context of the calling thread, see
+// StaticRTree::GetThreadContext.
 //
 // Only holds a weak reference on the RTree and coordinates!
 template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
@@ -54,7 +59,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                const double max_distance,
                                const Approach approach) const
     {
-        auto results = rtree.Nearest(
+        const auto &results = rtree.Nearest(
+            RTreeT::GetThreadContext(),
             input_coordinate,
             [this, approach, &input_coordinate](const CandidateSegment &segment) {
                 return boolPairAnd(HasValidEdge(segment),
@@ -77,7 +83,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                                const int bearing_range,
                                const Approach approach) const
     {
-        auto results = rtree.Nearest(
+        const auto &results = rtree.Nearest(
+            RTreeT::GetThreadContext(),
             input_coordinate,
             [this, approach, &input_coordinate, bearing, bearing_range, max_distance](
                 const CandidateSegment &segment) {
@@ -104,17 +111,16 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const int bearing_range,
                         const Approach approach) const
     {
-        auto results = rtree.Nearest(
+        const auto &results = rtree.NearestK(
+            RTreeT::GetThreadContext(),
             input_coordinate,
+            max_results,
             [this, approach, &input_coordinate, bearing, bearing_range](
                 const CandidateSegment &segment) {
                 auto use_direction = boolPairAnd(
                     CheckSegmentBearing(segment, bearing, bearing_range), HasValidEdge(segment));
                 return boolPairAnd(use_direction,
                                    CheckApproach(input_coordinate, segment, approach));
-            },
-            [max_results](const std::size_t num_results, const CandidateSegment &) {
-                return num_results >= max_results;
             });
 
         return MakePhantomNodes(input_coordinate, results);
@@ -131,7 +137,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const int bearing_range,
                         const Approach approach) const
     {
-        auto results = rtree.Nearest(
+        const auto &results = rtree.Nearest(
+            RTreeT::GetThreadContext(),
             input_coordinate,
             [this, approach, &input_coordinate, bearing, bearing_range](
                 const CandidateSegment &segment) {
@@ -156,14 +163,13 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const unsigned max_results,
                         const Approach approach) const
     {
-        auto results = rtree.Nearest(
+        const auto &results = rtree.NearestK(
+            RTreeT::GetThreadContext(),
             input_coordinate,
+            max_results,
             [this, approach, &input_coordinate](const CandidateSegment &segment) {
                 return boolPairAnd(HasValidEdge(segment),
                                    CheckApproach(input_coordinate, segment, approach));
-            },
-            [max_results](const std::size_t num_results, const CandidateSegment &) {
-                return num_results >= max_results;
             });
 
         return MakePhantomNodes(input_coordinate, results);
@@ -177,7 +183,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                         const double max_distance,
                         const Approach approach) const
     {
-        auto results = rtree.Nearest(
+        const auto &results = rtree.Nearest(
+            RTreeT::GetThreadContext(),
             input_coordinate,
             [this, approach, &input_coordinate](const CandidateSegment &segment) {
                 return boolPairAnd(HasValidEdge(segment),
@@ -201,7 +208,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         bool has_small_component = false;
         bool has_big_component = false;
-        auto results = rtree.Nearest(
+        const auto &results = rtree.Nearest(
+            RTreeT::GetThreadContext(),
             input_coordinate,
             [this, approach, &input_coordinate, &has_big_component, &has_small_component](
                 const CandidateSegment &segment) {
@@ -245,7 +253,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         bool has_small_component = false;
         bool has_big_component = false;
-        auto results = rtree.Nearest(
+        const auto &results = rtree.Nearest(
+            RTreeT::GetThreadContext(),
             input_coordinate,
             [this, approach, &input_coordinate, &has_big_component, &has_small_component](
                 const CandidateSegment &segment) {
@@ -290,7 +299,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         bool has_small_component = false;
         bool has_big_component = false;
-        auto results = rtree.Nearest(
+        const auto &results = rtree.Nearest(
+            RTreeT::GetThreadContext(),
             input_coordinate,
             [this,
              approach,
@@ -346,7 +356,8 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
     {
         bool has_small_component = false;
         bool has_big_component = false;
-        auto results = rtree.Nearest(
+        const auto &results = rtree.Nearest(
+            RTreeT::GetThreadContext(),
             input_coordinate,
             [this,
              approach,
@@ -393,6 +404,91 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                               MakePhantomNode(input_coordinate, results.back()).phantom_node);
     }
 
+    // Snaps many coordinates like NearestPhantomNodeWithAlternativeFromBigComponent in one
+    // batch. max_distances, bearings and approaches are either empty or have an optional entry
+    // for every coordinate. The queries of the batch run on up to max_threads threads.
+    std::vector<std::pair<PhantomNode, PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> &input_coordinates,
+        const std::vector<boost::optional<double>> &max_distances,
+        const std::vector<boost::optional<Bearing>> &bearings,
+        const std::vector<boost::optional<Approach>> &approaches,
+        const int max_threads) const
+    {
+        BOOST_ASSERT(max_distances.empty() || max_distances.size() == input_coordinates.size());
+        BOOST_ASSERT(bearings.empty() || bearings.size() == input_coordinates.size());
+        BOOST_ASSERT(approaches.empty() || approaches.size() == input_coordinates.size());
+
+        // only written by the thread running the query
+        struct ComponentState
+        {
+            bool has_small_component = false;
+            bool has_big_component = false;
+        };
+        std::vector<ComponentState> states(input_coordinates.size());
+
+        std::vector<std::pair<PhantomNode, PhantomNode>> phantom_node_pairs(
+            input_coordinates.size());
+        rtree.BatchNearest(
+            input_coordinates,
+            [&](const std::size_t query, const CandidateSegment &segment) {
+                auto &state = states[query];
+                const auto use_segment =
+                    (!state.has_small_component ||
+                     (!state.has_big_component && !IsTinyComponent(segment)));
+                if (!use_segment)
+                {
+                    return std::make_pair(false, false);
+                }
+
+                auto use_directions = HasValidEdge(segment);
+                if (!bearings.empty() && bearings[query])
+                {
+                    use_directions = boolPairAnd(use_directions,
+                                                 CheckSegmentBearing(segment,
+                                                                     bearings[query]->bearing,
+                                                                     bearings[query]->range));
+                }
+                if (!approaches.empty() && approaches[query])
+                {
+                    use_directions = boolPairAnd(
+                        use_directions,
+                        CheckApproach(input_coordinates[query], segment, *approaches[query]));
+                }
+
+                if (use_directions.first || use_directions.second)
+                {
+                    state.has_big_component = state.has_big_component || !IsTinyComponent(segment);
+                    state.has_small_component =
+                        state.has_small_component || IsTinyComponent(segment);
+                }
+
+                return use_directions;
+            },
+            [&](const std::size_t query,
+                const std::size_t num_results,
+                const CandidateSegment &segment) {
+                return (num_results > 0 && states[query].has_big_component) ||
+                       (!max_distances.empty() && max_distances[query] &&
+                        CheckSegmentDistance(
+                            input_coordinates[query], segment, *max_distances[query]));
+            },
+            [&](const std::size_t query, const std::vector<EdgeData> &results) {
+                if (results.empty())
+                {
+                    return;
+                }
+
+                BOOST_ASSERT(results.size() == 1 || results.size() == 2);
+                phantom_node_pairs[query] = std::make_pair(
+                    MakePhantomNode(input_coordinates[query], results.front()).phantom_node,
+                    MakePhantomNode(input_coordinates[query], results.back()).phantom_node);
+            },
+            max_threads);
+
+        return phantom_node_pairs;
+    }
+
   private:
     std::vector<PhantomNodeWithDistance>
     MakePhantomNodes(const util::Coordinate input_coordinate,
@@ -435,13 +531,11 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         const auto geometry_id = datafacade.GetGeometryIndex(data.forward_segment_id.id).id;
         const auto component_id = datafacade.GetComponentID(data.forward_segment_id.id);
 
-        const std::vector<EdgeWeight> forward_weight_vector =
-            datafacade.GetUncompressedForwardWeights(geometry_id);
-        const std::vector<EdgeWeight> reverse_weight_vector =
-            datafacade.GetUncompressedReverseWeights(geometry_id);
-        const std::vector<EdgeWeight> forward_duration_vector =
+        const auto forward_weight_vector = datafacade.GetUncompressedForwardWeights(geometry_id);
+        const auto reverse_weight_vector = datafacade.GetUncompressedReverseWeights(geometry_id);
+        const auto forward_duration_vector =
             datafacade.GetUncompressedForwardDurations(geometry_id);
-        const std::vector<EdgeWeight> reverse_duration_vector =
+        const auto reverse_duration_vector =
             datafacade.GetUncompressedReverseDurations(geometry_id);
 
         for (std::size_t i = 0; i < data.fwd_segment_position; i++)
@@ -572,16 +666,14 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
         BOOST_ASSERT(data.forward_segment_id.id != SPECIAL_NODEID);
         const auto geometry_id = datafacade.GetGeometryIndex(data.forward_segment_id.id).id;
 
-        const std::vector<EdgeWeight> forward_weight_vector =
-            datafacade.GetUncompressedForwardWeights(geometry_id);
+        const auto forward_weight_vector = datafacade.GetUncompressedForwardWeights(geometry_id);
 
         if (forward_weight_vector[data.fwd_segment_position] != INVALID_SEGMENT_WEIGHT)
         {
             forward_edge_valid = data.forward_segment_id.enabled;
         }
 
-        const std::vector<EdgeWeight> reverse_weight_vector =
-            datafacade.GetUncompressedReverseWeights(geometry_id);
+        const auto reverse_weight_vector = datafacade.GetUncompressedReverseWeights(geometry_id);
         if (reverse_weight_vector[reverse_weight_vector.size() - data.fwd_segment_position - 1] !=
             INVALID_SEGMENT_WEIGHT)
         {
@@ -11,6 +11,7 @@
 #include "util/coordinate.hpp"
 #include "util/coordinate_calculation.hpp"
 
+#include <iterator>
 #include <utility>
 #include <vector>
 
@@ -54,10 +55,9 @@ inline LegGeometry assembleGeometry(const datafacade::BaseDataFacade &facade,
     const auto source_node_id =
         reversed_source ? source_node.reverse_segment_id.id : source_node.forward_segment_id.id;
     const auto source_gemetry_id = facade.GetGeometryIndex(source_node_id).id;
-    const std::vector<NodeID> source_geometry =
-        facade.GetUncompressedForwardGeometry(source_gemetry_id);
-    geometry.osm_node_ids.push_back(
-        facade.GetOSMNodeIDOfNode(source_geometry[source_segment_start_coordinate]));
+    const auto source_geometry = facade.GetUncompressedForwardGeometry(source_gemetry_id);
+    geometry.osm_node_ids.push_back(facade.GetOSMNodeIDOfNode(
+        *std::next(source_geometry.begin(), source_segment_start_coordinate)));
 
     auto cumulative_distance = 0.;
     auto current_distance = 0.;
@@ -95,8 +95,7 @@ inline LegGeometry assembleGeometry(const datafacade::BaseDataFacade &facade,
     const auto target_node_id =
         reversed_target ? target_node.reverse_segment_id.id : target_node.forward_segment_id.id;
     const auto target_gemetry_id = facade.GetGeometryIndex(target_node_id).id;
-    const std::vector<DatasourceID> forward_datasources =
-        facade.GetUncompressedForwardDatasources(target_gemetry_id);
+    const auto forward_datasources = facade.GetUncompressedForwardDatasources(target_gemetry_id);
 
     // FIXME if source and target phantoms are on the same segment then duration and weight
     // will be from one projected point till end of segment
@@ -118,10 +117,9 @@ inline LegGeometry assembleGeometry(const datafacade::BaseDataFacade &facade,
     // target node rev:       1       1 <- 2 <- 3
     const auto target_segment_end_coordinate =
         target_node.fwd_segment_position + (reversed_target ? 0 : 1);
-    const std::vector<NodeID> target_geometry =
-        facade.GetUncompressedForwardGeometry(target_gemetry_id);
-    geometry.osm_node_ids.push_back(
-        facade.GetOSMNodeIDOfNode(target_geometry[target_segment_end_coordinate]));
+    const auto target_geometry = facade.GetUncompressedForwardGeometry(target_gemetry_id);
+    geometry.osm_node_ids.push_back(facade.GetOSMNodeIDOfNode(
+        *std::next(target_geometry.begin(), target_segment_end_coordinate)));
 
     BOOST_ASSERT(geometry.segment_distances.size() == geometry.segment_offsets.size() - 1);
     BOOST_ASSERT(geometry.locations.size() > geometry.segment_distances.size());
@@ -17,7 +17,7 @@ namespace plugins
 class NearestPlugin final : public BasePlugin
 {
   public:
-    explicit NearestPlugin(const int max_results);
+    explicit NearestPlugin(const int max_results, ResultCache *result_cache = nullptr);
 
     Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                          const RoutingAlgorithmsInterface &algorithms,
@@ -26,6 +26,7 @@ class NearestPlugin final : public BasePlugin
 
   private:
     const int max_results;
+    ResultCache *const result_cache;
 };
 }
 }
@@ -2,14 +2,19 @@
 #define BASE_PLUGIN_HPP
 
 #include "engine/api/base_parameters.hpp"
+#include "engine/api/binary_factory.hpp"
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/phantom_node.hpp"
+#include "engine/result_cache.hpp"
 #include "engine/status.hpp"
 
+#include "util/binary_writer.hpp"
 #include "util/coordinate.hpp"
 #include "util/coordinate_calculation.hpp"
 #include "util/integer_range.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
+#include "util/metrics.hpp"
 
 #include <algorithm>
 #include <iterator>
@@ -45,6 +50,27 @@ class BasePlugin
         return Status::Error;
     }
 
+    Status Error(const std::string &code,
+                 const std::string &message,
+                 util::json::Writer &json_writer) const
+    {
+        json_writer.StartObject();
+        json_writer.Key("code");
+        json_writer.String(code);
+        json_writer.Key("message");
+        json_writer.String(message);
+        json_writer.EndObject();
+        return Status::Error;
+    }
+
+    Status Error(const std::string &code,
+                 const std::string &message,
+                 util::binary::Writer &binary_writer) const
+    {
+        api::binary::writeHeader(binary_writer, code, message);
+        return Status::Error;
+    }
+
     // Decides whether to use the phantom node from a big or small component if both are found.
     // Returns true if all phantom nodes are in the same component after snapping.
     std::vector<PhantomNode>
@@ -114,6 +140,7 @@ class BasePlugin
                            const api::BaseParameters &parameters,
                            const std::vector<double> radiuses) const
     {
+        util::metrics::StageScope snapping(util::metrics::Stage::Snapping);
         std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
             parameters.coordinates.size());
         BOOST_ASSERT(radiuses.size() == parameters.coordinates.size());
@@ -162,6 +189,7 @@ class BasePlugin
                     const api::BaseParameters &parameters,
                     unsigned number_of_results) const
     {
+        util::metrics::StageScope snapping(util::metrics::Stage::Snapping);
         std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
             parameters.coordinates.size());
 
@@ -233,9 +261,12 @@ class BasePlugin
         return phantom_nodes;
     }
 
+    // Coordinates without a valid hint are snapped in one batch on up to max_threads threads
     std::vector<PhantomNodePair> GetPhantomNodes(const datafacade::BaseDataFacade &facade,
-                                                 const api::BaseParameters &parameters) const
+                                                 const api::BaseParameters &parameters,
+                                                 const int max_threads = 1) const
     {
+        util::metrics::StageScope snapping(util::metrics::Stage::Snapping);
         std::vector<PhantomNodePair> phantom_node_pairs(parameters.coordinates.size());
 
         const bool use_hints = !parameters.hints.empty();
@@ -244,12 +275,13 @@ class BasePlugin
         const bool use_approaches = !parameters.approaches.empty();
 
         BOOST_ASSERT(parameters.IsValid());
+        std::vector<std::size_t> snapped_indices;
+        std::vector<util::Coordinate> coordinates;
+        std::vector<boost::optional<double>> radiuses;
+        std::vector<boost::optional<Bearing>> bearings;
+        std::vector<boost::optional<Approach>> approaches;
         for (const auto i : util::irange<std::size_t>(0UL, parameters.coordinates.size()))
         {
-            Approach approach = engine::Approach::UNRESTRICTED;
-            if (use_approaches && parameters.approaches[i])
-                approach = parameters.approaches[i].get();
-
             if (use_hints && parameters.hints[i] &&
                 parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
             {
@@ -258,54 +290,39 @@ class BasePlugin
                 continue;
             }
 
-            if (use_bearings && parameters.bearings[i])
-            {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            *parameters.radiuses[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range,
-                            approach);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i],
-                            parameters.bearings[i]->bearing,
-                            parameters.bearings[i]->range,
-                            approach);
-                }
-            }
-            else
-            {
-                if (use_radiuses && parameters.radiuses[i])
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i], *parameters.radiuses[i], approach);
-                }
-                else
-                {
-                    phantom_node_pairs[i] =
-                        facade.NearestPhantomNodeWithAlternativeFromBigComponent(
-                            parameters.coordinates[i], approach);
-                }
-            }
+            snapped_indices.push_back(i);
+            coordinates.push_back(parameters.coordinates[i]);
+            if (use_radiuses)
+                radiuses.push_back(parameters.radiuses[i]);
+            if (use_bearings)
+                bearings.push_back(parameters.bearings[i]);
+            if (use_approaches)
+                approaches.push_back(parameters.approaches[i]);
+        }
 
-            // we didn't find a fitting node, return error
-            if (!phantom_node_pairs[i].first.IsValid())
+        if (!coordinates.empty())
+        {
+            auto snapped_pairs = facade.NearestPhantomNodesWithAlternativeFromBigComponent(
+                coordinates, radiuses, bearings, approaches, max_threads);
+            BOOST_ASSERT(snapped_pairs.size() == snapped_indices.size());
+            for (const auto j : util::irange<std::size_t>(0UL, snapped_indices.size()))
             {
-                // This ensures the list of phantom nodes only consists of valid nodes.
-                // We can use this on the call-site to detect an error.
-                phantom_node_pairs.pop_back();
-                break;
+                BOOST_ASSERT(snapped_pairs[j].first.IsValid() ==
+                             snapped_pairs[j].second.IsValid());
+                phantom_node_pairs[snapped_indices[j]] = std::move(snapped_pairs[j]);
             }
-            BOOST_ASSERT(phantom_node_pairs[i].first.IsValid());
-            BOOST_ASSERT(phantom_node_pairs[i].second.IsValid());
+        }
+
+        const auto all_valid = std::all_of(
+            phantom_node_pairs.begin(),
+            phantom_node_pairs.end(),
+            [](const PhantomNodePair &phantom_pair) { return phantom_pair.first.IsValid(); });
+        // we didn't find a fitting node, return error
+        if (!all_valid)
+        {
+            // This ensures the list of phantom nodes only consists of valid nodes.
+            // We can use this on the call-site to detect an error.
+            phantom_node_pairs.pop_back();
         }
         return phantom_node_pairs;
     }
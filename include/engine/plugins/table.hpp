@@ -7,7 +7,9 @@
 #include "engine/routing_algorithms.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/search_engine_data.hpp"
+#include "util/binary_writer.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
 
 namespace osrm
 {
@@ -19,15 +21,37 @@ namespace plugins
 class TablePlugin final : public BasePlugin
 {
   public:
-    explicit TablePlugin(const int max_locations_distance_table);
+    // The coordinates of a request are snapped on up to max_threads threads
+    explicit TablePlugin(const int max_locations_distance_table,
+                         const int max_threads = 1,
+                         ResultCache *result_cache = nullptr);
 
     Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                          const RoutingAlgorithmsInterface &algorithms,
                          const api::TableParameters &params,
                          util::json::Object &result) const;
 
+    // Writes the response directly instead of building a json::Object first
+    Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                         const RoutingAlgorithmsInterface &algorithms,
+                         const api::TableParameters &params,
+                         util::json::Writer &result) const;
+
+    Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                         const RoutingAlgorithmsInterface &algorithms,
+                         const api::TableParameters &params,
+                         util::binary::Writer &result) const;
+
   private:
+    template <typename ResultT>
+    Status HandleRequestImpl(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                             const RoutingAlgorithmsInterface &algorithms,
+                             const api::TableParameters &params,
+                             ResultT &result) const;
+
     const int max_locations_distance_table;
+    const int max_threads;
+    ResultCache *const result_cache;
 };
 }
 }
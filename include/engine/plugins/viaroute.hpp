@@ -7,6 +7,7 @@
 #include "engine/datafacade/datafacade_base.hpp"
 #include "engine/routing_algorithms.hpp"
 #include "engine/search_engine_data.hpp"
+#include "util/binary_writer.hpp"
 #include "util/json_container.hpp"
 
 #include <cstdlib>
@@ -27,14 +28,27 @@ class ViaRoutePlugin final : public BasePlugin
 {
   private:
     const int max_locations_viaroute;
+    ResultCache *const result_cache;
 
   public:
-    explicit ViaRoutePlugin(int max_locations_viaroute);
+    explicit ViaRoutePlugin(int max_locations_viaroute, ResultCache *result_cache = nullptr);
 
     Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                          const RoutingAlgorithmsInterface &algorithms,
                          const api::RouteParameters &route_parameters,
                          util::json::Object &json_result) const;
+
+    Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                         const RoutingAlgorithmsInterface &algorithms,
+                         const api::RouteParameters &route_parameters,
+                         util::binary::Writer &binary_result) const;
+
+  private:
+    template <typename ResultT>
+    Status HandleRequestImpl(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                             const RoutingAlgorithmsInterface &algorithms,
+                             const api::RouteParameters &route_parameters,
+                             ResultT &result) const;
 };
 }
 }
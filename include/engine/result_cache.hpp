@@ -0,0 +1,219 @@
+#ifndef OSRM_ENGINE_RESULT_CACHE_HPP
+#define OSRM_ENGINE_RESULT_CACHE_HPP
+
+#include "engine/api/base_parameters.hpp"
+#include "engine/hint.hpp"
+#include "engine/phantom_node.hpp"
+#include "engine/status.hpp"
+
+#include "util/binary_writer.hpp"
+#include "util/json_container.hpp"
+#include "util/json_writer.hpp"
+
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+/**
+ * Size bounded cache of complete responses, keyed on the snapped phantom nodes and the
+ * options of a request.
+ *
+ * The entries are spread over shards with their own lock and least recently used order.
+ * Invalidate() is called by DataWatchdog before and after it replaces the data facade, a
+ * result computed with a facade is only stored if no invalidation happened since the request
+ * read Generation() while holding that facade.
+ * Hits and misses are counted for the endpoint of the current request, see util::metrics.
+ */
+class ResultCache
+{
+  public:
+    struct Entry
+    {
+        Status status;
+        // the response of requests with a json::Object result
+        util::json::Object object;
+        // the response of requests with a json::Writer or binary::Writer result
+        std::vector<char> bytes;
+    };
+
+    explicit ResultCache(const std::size_t max_entries, const std::size_t num_shards = 16);
+
+    std::uint64_t Generation() const { return generation.load(std::memory_order_acquire); }
+
+    // Returns nullptr if the key is not cached
+    std::shared_ptr<const Entry> Get(const std::string &key);
+
+    void Put(std::string key, std::shared_ptr<const Entry> entry, const std::uint64_t generation);
+
+    // Removes all entries and rejects the results of requests that are still running
+    void Invalidate();
+
+    std::size_t Size() const;
+
+  private:
+    struct CachedEntry
+    {
+        std::string key;
+        std::shared_ptr<const Entry> entry;
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        // most recently used first
+        std::list<CachedEntry> entries;
+        std::unordered_map<std::string, std::list<CachedEntry>::iterator> index;
+    };
+
+    Shard &GetShard(const std::string &key);
+
+    const std::size_t max_entries_per_shard;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<std::uint64_t> generation;
+};
+
+/// Builds the key of a request from its snapped phantom nodes and its options
+class ResultCacheKey
+{
+  public:
+    // Only values without padding, structs are added field by field
+    template <typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                            ResultCacheKey &>::type
+    Add(const T &value)
+    {
+        key.append(reinterpret_cast<const char *>(&value), sizeof(value));
+        return *this;
+    }
+
+    template <typename T> ResultCacheKey &Add(const boost::optional<T> &value)
+    {
+        Add(static_cast<bool>(value));
+        if (value)
+            Add(*value);
+        return *this;
+    }
+
+    template <typename T> ResultCacheKey &Add(const std::vector<T> &values)
+    {
+        Add(values.size());
+        for (const auto &value : values)
+            Add(value);
+        return *this;
+    }
+
+    ResultCacheKey &Add(const util::Coordinate coordinate);
+    ResultCacheKey &Add(const Bearing bearing);
+    ResultCacheKey &Add(const Hint &hint);
+
+    // The input location is only part of the response if it contains hints
+    ResultCacheKey &Add(const PhantomNode &phantom, const bool with_input_location);
+
+    // All options besides the coordinates and the hints, which only influence the snapping
+    ResultCacheKey &Add(const api::BaseParameters &parameters);
+
+    const std::string &Get() const { return key; }
+
+  private:
+    std::string key;
+};
+
+namespace detail
+{
+inline void appendRaw(util::json::Writer &result, const std::vector<char> &bytes)
+{
+    result.Raw(bytes.data(), bytes.size());
+}
+
+inline void appendRaw(util::binary::Writer &result, const std::vector<char> &bytes)
+{
+    result.Bytes(bytes.data(), bytes.size());
+}
+
+// Copies the response of a result into a cache entry and back
+template <typename ResultT> class ResultCapture
+{
+  public:
+    explicit ResultCapture(const ResultT &result) : begin(result.Size()) {}
+
+    void Store(const ResultT &result, ResultCache::Entry &entry) const
+    {
+        entry.bytes.assign(result.Data() + begin, result.Data() + result.Size());
+    }
+
+    static void Restore(const ResultCache::Entry &entry, ResultT &result)
+    {
+        appendRaw(result, entry.bytes);
+    }
+
+  private:
+    const std::size_t begin;
+};
+
+template <> class ResultCapture<util::json::Object>
+{
+  public:
+    explicit ResultCapture(const util::json::Object &) {}
+
+    void Store(const util::json::Object &result, ResultCache::Entry &entry) const
+    {
+        entry.object = result;
+    }
+
+    static void Restore(const ResultCache::Entry &entry, util::json::Object &result)
+    {
+        result = entry.object;
+    }
+};
+
+template <typename ResultT> std::uint8_t resultKind();
+template <> inline std::uint8_t resultKind<util::json::Object>() { return 0; }
+template <> inline std::uint8_t resultKind<util::json::Writer>() { return 1; }
+template <> inline std::uint8_t resultKind<util::binary::Writer>() { return 2; }
+}
+
+/// Answers a request from the cache or computes its response with compute and caches it.
+/// Without a cache the response is only computed.
+template <typename ResultT, typename ComputeFn>
+Status cachedResponse(ResultCache *cache, ResultCacheKey key, ResultT &result, ComputeFn compute)
+{
+    if (!cache)
+        return compute();
+
+    key.Add(detail::resultKind<ResultT>());
+    if (const auto entry = cache->Get(key.Get()))
+    {
+        detail::ResultCapture<ResultT>::Restore(*entry, result);
+        return entry->status;
+    }
+
+    // read before computing, so results of a replaced facade are rejected
+    const auto generation = cache->Generation();
+    const detail::ResultCapture<ResultT> capture(result);
+    const auto status = compute();
+
+    auto entry = std::make_shared<ResultCache::Entry>();
+    entry->status = status;
+    capture.Store(result, *entry);
+    cache->Put(key.Get(), std::move(entry), generation);
+    return status;
+}
+}
+}
+
+#endif
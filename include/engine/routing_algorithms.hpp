@@ -11,6 +11,8 @@
 #include "engine/routing_algorithms/shortest_path.hpp"
 #include "engine/routing_algorithms/tile_turns.hpp"
 
+#include "util/metrics.hpp"
+
 namespace osrm
 {
 namespace engine
@@ -132,6 +134,7 @@ template <typename Algorithm>
 InternalManyRoutesResult
 RoutingAlgorithms<Algorithm>::AlternativePathSearch(const PhantomNodes &phantom_node_pair) const
 {
+    util::metrics::StageScope search(util::metrics::Stage::Search);
     return routing_algorithms::ch::alternativePathSearch(heaps, facade, phantom_node_pair);
 }
 
@@ -140,6 +143,7 @@ InternalRouteResult RoutingAlgorithms<Algorithm>::ShortestPathSearch(
     const std::vector<PhantomNodes> &phantom_node_pair,
     const boost::optional<bool> continue_straight_at_waypoint) const
 {
+    util::metrics::StageScope search(util::metrics::Stage::Search);
     return routing_algorithms::shortestPathSearch(
         heaps, facade, phantom_node_pair, continue_straight_at_waypoint);
 }
@@ -148,6 +152,7 @@ template <typename Algorithm>
 InternalRouteResult
 RoutingAlgorithms<Algorithm>::DirectShortestPathSearch(const PhantomNodes &phantom_nodes) const
 {
+    util::metrics::StageScope search(util::metrics::Stage::Search);
     return routing_algorithms::directShortestPathSearch(heaps, facade, phantom_nodes);
 }
 
@@ -157,6 +162,7 @@ RoutingAlgorithms<Algorithm>::ManyToManySearch(const std::vector<PhantomNode> &p
                                                const std::vector<std::size_t> &source_indices,
                                                const std::vector<std::size_t> &target_indices) const
 {
+    util::metrics::StageScope search(util::metrics::Stage::Search);
     return routing_algorithms::manyToManySearch(
         heaps, facade, phantom_nodes, source_indices, target_indices);
 }
@@ -169,6 +175,7 @@ inline routing_algorithms::SubMatchingList RoutingAlgorithms<Algorithm>::MapMatc
     const std::vector<boost::optional<double>> &trace_gps_precision,
     const bool allow_splitting) const
 {
+    util::metrics::StageScope search(util::metrics::Stage::Search);
     return routing_algorithms::mapMatching(heaps,
                                            facade,
                                            candidates_list,
@@ -204,12 +211,13 @@ RoutingAlgorithms<routing_algorithms::corech::Algorithm>::ManyToManySearch(
     throw util::exception("ManyToManySearch is disabled due to performance reasons");
 }
 
-// MLD overrides for not implemented
+// MLD overrides
 template <>
-InternalManyRoutesResult inline RoutingAlgorithms<
-    routing_algorithms::mld::Algorithm>::AlternativePathSearch(const PhantomNodes &) const
+InternalManyRoutesResult inline RoutingAlgorithms<routing_algorithms::mld::Algorithm>::
+    AlternativePathSearch(const PhantomNodes &phantom_node_pair) const
 {
-    throw util::exception("AlternativePathSearch is not implemented");
+    util::metrics::StageScope search(util::metrics::Stage::Search);
+    return routing_algorithms::mld::alternativePathSearch(heaps, facade, phantom_node_pair);
 }
 }
 }
@@ -131,6 +131,35 @@ void annotatePath(const FacadeT &facade,
     BOOST_ASSERT(phantom_node_pair.target_phantom.forward_segment_id.id == target_node_id ||
                  phantom_node_pair.target_phantom.reverse_segment_id.id == target_node_id);
 
+    // The segment data of the current geometry. The vectors are reused for all geometries of
+    // the path, so copying the ranges of the facade into them only allocates while they grow.
+    std::vector<NodeID> id_vector;
+    std::vector<EdgeWeight> weight_vector;
+    std::vector<EdgeWeight> duration_vector;
+    std::vector<DatasourceID> datasource_vector;
+
+    // the node ranges are only bidirectional, assigning them would decode the nodes twice
+    const auto copy = [](auto &vector, const auto &range) {
+        vector.clear();
+        std::copy(range.begin(), range.end(), std::back_inserter(vector));
+    };
+    const auto get_segment_geometry = [&](const GeometryID geometry_index) {
+        if (geometry_index.forward)
+        {
+            copy(id_vector, facade.GetUncompressedForwardGeometry(geometry_index.id));
+            copy(weight_vector, facade.GetUncompressedForwardWeights(geometry_index.id));
+            copy(duration_vector, facade.GetUncompressedForwardDurations(geometry_index.id));
+            copy(datasource_vector, facade.GetUncompressedForwardDatasources(geometry_index.id));
+        }
+        else
+        {
+            copy(id_vector, facade.GetUncompressedReverseGeometry(geometry_index.id));
+            copy(weight_vector, facade.GetUncompressedReverseWeights(geometry_index.id));
+            copy(duration_vector, facade.GetUncompressedReverseDurations(geometry_index.id));
+            copy(datasource_vector, facade.GetUncompressedReverseDatasources(geometry_index.id));
+        }
+    };
+
     auto node_from = unpacked_nodes.begin(), node_last = std::prev(unpacked_nodes.end());
     for (auto edge = unpacked_edges.begin(); node_from != node_last; ++node_from, ++edge)
     {
@@ -141,26 +170,7 @@ void annotatePath(const FacadeT &facade,
         const auto turn_instruction = facade.GetTurnInstructionForEdgeID(turn_id);
         const extractor::TravelMode travel_mode = facade.GetTravelMode(node_id);
 
-        const auto geometry_index = facade.GetGeometryIndex(node_id);
-        std::vector<NodeID> id_vector;
-
-        std::vector<EdgeWeight> weight_vector;
-        std::vector<EdgeWeight> duration_vector;
-        std::vector<DatasourceID> datasource_vector;
-        if (geometry_index.forward)
-        {
-            id_vector = facade.GetUncompressedForwardGeometry(geometry_index.id);
-            weight_vector = facade.GetUncompressedForwardWeights(geometry_index.id);
-            duration_vector = facade.GetUncompressedForwardDurations(geometry_index.id);
-            datasource_vector = facade.GetUncompressedForwardDatasources(geometry_index.id);
-        }
-        else
-        {
-            id_vector = facade.GetUncompressedReverseGeometry(geometry_index.id);
-            weight_vector = facade.GetUncompressedReverseWeights(geometry_index.id);
-            duration_vector = facade.GetUncompressedReverseDurations(geometry_index.id);
-            datasource_vector = facade.GetUncompressedReverseDatasources(geometry_index.id);
-        }
+        get_segment_geometry(facade.GetGeometryIndex(node_id));
         BOOST_ASSERT(id_vector.size() > 0);
         BOOST_ASSERT(datasource_vector.size() > 0);
         BOOST_ASSERT(weight_vector.size() == id_vector.size() - 1);
@@ -204,21 +214,13 @@ void annotatePath(const FacadeT &facade,
     }
 
     std::size_t start_index = 0, end_index = 0;
-    std::vector<unsigned> id_vector;
-    std::vector<EdgeWeight> weight_vector;
-    std::vector<EdgeWeight> duration_vector;
-    std::vector<DatasourceID> datasource_vector;
     const auto source_geometry_id = facade.GetGeometryIndex(source_node_id).id;
     const auto target_geometry_id = facade.GetGeometryIndex(target_node_id).id;
     const auto is_local_path = source_geometry_id == target_geometry_id && unpacked_path.empty();
 
+    get_segment_geometry(GeometryID{target_geometry_id, !target_traversed_in_reverse});
     if (target_traversed_in_reverse)
     {
-        id_vector = facade.GetUncompressedReverseGeometry(target_geometry_id);
-        weight_vector = facade.GetUncompressedReverseWeights(target_geometry_id);
-        duration_vector = facade.GetUncompressedReverseDurations(target_geometry_id);
-        datasource_vector = facade.GetUncompressedReverseDatasources(target_geometry_id);
-
         if (is_local_path)
         {
             start_index =
@@ -234,11 +236,6 @@ void annotatePath(const FacadeT &facade,
             start_index = phantom_node_pair.source_phantom.fwd_segment_position;
         }
         end_index = phantom_node_pair.target_phantom.fwd_segment_position;
-
-        id_vector = facade.GetUncompressedForwardGeometry(target_geometry_id);
-        weight_vector = facade.GetUncompressedForwardWeights(target_geometry_id);
-        duration_vector = facade.GetUncompressedForwardDurations(target_geometry_id);
-        datasource_vector = facade.GetUncompressedForwardDatasources(target_geometry_id);
     }
 
     // Given the following compressed geometry:
@@ -313,6 +310,39 @@ void annotatePath(const FacadeT &facade,
     }
 }
 
+template <typename Algorithm>
+InternalRouteResult
+extractRoute(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+             const EdgeWeight weight,
+             const PhantomNodes &phantom_nodes,
+             const std::vector<NodeID> &unpacked_nodes,
+             const std::vector<EdgeID> &unpacked_edges)
+{
+    InternalRouteResult raw_route_data;
+    raw_route_data.segment_end_coordinates = {phantom_nodes};
+
+    // No path found for both target nodes?
+    if (INVALID_EDGE_WEIGHT == weight)
+    {
+        return raw_route_data;
+    }
+
+    raw_route_data.shortest_path_weight = weight;
+    raw_route_data.unpacked_path_segments.resize(1);
+    raw_route_data.source_traversed_in_reverse.push_back(
+        (unpacked_nodes.front() != phantom_nodes.source_phantom.forward_segment_id.id));
+    raw_route_data.target_traversed_in_reverse.push_back(
+        (unpacked_nodes.back() != phantom_nodes.target_phantom.forward_segment_id.id));
+
+    annotatePath(facade,
+                 phantom_nodes,
+                 unpacked_nodes,
+                 unpacked_edges,
+                 raw_route_data.unpacked_path_segments.front());
+
+    return raw_route_data;
+}
+
 template <typename Algorithm>
 double getPathDistance(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
                        const std::vector<PathData> unpacked_path,
@@ -6,6 +6,7 @@
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
 
+#include "util/metrics.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
@@ -123,6 +124,7 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
                  const bool force_loop_reverse)
 {
     const NodeID node = forward_heap.DeleteMin();
+    util::metrics::countSettledNode();
     const EdgeWeight weight = forward_heap.GetKey(node);
 
     if (reverse_heap.WasInserted(node))
@@ -6,10 +6,16 @@
 #include "engine/routing_algorithms/routing_base.hpp"
 #include "engine/search_engine_data.hpp"
 
+#include "util/metrics.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/assert.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
 namespace osrm
 {
 namespace engine
@@ -74,6 +80,7 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
     const auto &cells = facade.GetCellStorage();
 
     const auto node = forward_heap.DeleteMin();
+    util::metrics::countSettledNode();
     const auto weight = forward_heap.GetKey(node);
 
     // Upper bound for the path source -> target with
@@ -179,6 +186,128 @@ void routingStep(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
     }
 }
 
+// Packed path edges {from node ID, to node ID, is an overlay edge}
+using PackedEdge = std::tuple<NodeID, NodeID, bool>;
+using PackedPath = std::vector<PackedEdge>;
+
+// Appends the packed edges from the search root of heap to middle, in the order of the parent
+// links. The edges from a reverse heap point to the root.
+template <bool DIRECTION, typename OutIter>
+inline void retrievePackedPathFromSingleHeap(const SearchEngineData<Algorithm>::QueryHeap &heap,
+                                             const NodeID middle,
+                                             OutIter out)
+{
+    NodeID current_node = middle, parent_node = heap.GetData(middle).parent;
+    while (parent_node != current_node)
+    {
+        const auto &data = heap.GetData(current_node);
+        if (DIRECTION == FORWARD_DIRECTION)
+            *out++ = std::make_tuple(parent_node, current_node, data.from_clique_arc);
+        else
+            *out++ = std::make_tuple(current_node, parent_node, data.from_clique_arc);
+        current_node = parent_node;
+        parent_node = heap.GetData(parent_node).parent;
+    }
+}
+
+// The packed path source -> middle -> target
+inline PackedPath
+retrievePackedPathFromHeap(const SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                           const SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                           const NodeID middle)
+{
+    PackedPath packed_path;
+    retrievePackedPathFromSingleHeap<FORWARD_DIRECTION>(
+        forward_heap, middle, std::back_inserter(packed_path));
+    std::reverse(std::begin(packed_path), std::end(packed_path));
+    retrievePackedPathFromSingleHeap<REVERSE_DIRECTION>(
+        reverse_heap, middle, std::back_inserter(packed_path));
+    return packed_path;
+}
+
+template <typename... Args>
+std::tuple<EdgeWeight, std::vector<NodeID>, std::vector<EdgeID>>
+search(SearchEngineData<Algorithm> &engine_working_data,
+       const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+       SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+       SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+       const bool force_loop_forward,
+       const bool force_loop_reverse,
+       EdgeWeight weight_upper_bound,
+       Args... args);
+
+// Unpacks the overlay edges of a packed path that starts at source_node with searches
+// restricted to the cells of the edges. The heaps are cleared and reused by the searches.
+template <typename... Args>
+void unpackPath(SearchEngineData<Algorithm> &engine_working_data,
+                const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+                SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+                const bool force_loop_forward,
+                const bool force_loop_reverse,
+                const NodeID source_node,
+                const PackedPath &packed_path,
+                std::vector<NodeID> &unpacked_nodes,
+                std::vector<EdgeID> &unpacked_edges,
+                Args... args)
+{
+    const auto &partition = facade.GetMultiLevelPartition();
+
+    unpacked_nodes.clear();
+    unpacked_edges.clear();
+    unpacked_nodes.reserve(packed_path.size());
+    unpacked_edges.reserve(packed_path.size());
+
+    unpacked_nodes.push_back(source_node);
+    for (auto const &packed_edge : packed_path)
+    {
+        NodeID source, target;
+        bool overlay_edge;
+        std::tie(source, target, overlay_edge) = packed_edge;
+        if (!overlay_edge)
+        { // a base graph edge
+            unpacked_nodes.push_back(target);
+            unpacked_edges.push_back(facade.FindEdge(source, target));
+        }
+        else
+        { // an overlay graph edge
+            LevelID level = getNodeQureyLevel(partition, source, args...);
+            CellID parent_cell_id = partition.GetCell(level, source);
+            BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
+
+            LevelID sublevel = level - 1;
+
+            // Here heaps can be reused, let's go deeper!
+            forward_heap.Clear();
+            reverse_heap.Clear();
+            forward_heap.Insert(source, 0, {source});
+            reverse_heap.Insert(target, 0, {target});
+
+            // TODO: when structured bindings will be allowed change to
+            // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
+            EdgeWeight subpath_weight;
+            std::vector<NodeID> subpath_nodes;
+            std::vector<EdgeID> subpath_edges;
+            std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(engine_working_data,
+                                                                            facade,
+                                                                            forward_heap,
+                                                                            reverse_heap,
+                                                                            force_loop_forward,
+                                                                            force_loop_reverse,
+                                                                            INVALID_EDGE_WEIGHT,
+                                                                            sublevel,
+                                                                            parent_cell_id);
+            BOOST_ASSERT(!subpath_edges.empty());
+            BOOST_ASSERT(subpath_nodes.size() > 1);
+            BOOST_ASSERT(subpath_nodes.front() == source);
+            BOOST_ASSERT(subpath_nodes.back() == target);
+            unpacked_nodes.insert(
+                unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
+            unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
+        }
+    }
+}
+
 template <typename... Args>
 std::tuple<EdgeWeight, std::vector<NodeID>, std::vector<EdgeID>>
 search(SearchEngineData<Algorithm> &engine_working_data,
@@ -195,8 +324,6 @@ search(SearchEngineData<Algorithm> &engine_working_data,
         return std::make_tuple(INVALID_EDGE_WEIGHT, std::vector<NodeID>(), std::vector<EdgeID>());
     }
 
-    const auto &partition = facade.GetMultiLevelPartition();
-
     BOOST_ASSERT(!forward_heap.Empty() && forward_heap.MinKey() < INVALID_EDGE_WEIGHT);
     BOOST_ASSERT(!reverse_heap.Empty() && reverse_heap.MinKey() < INVALID_EDGE_WEIGHT);
 
@@ -242,82 +369,22 @@ search(SearchEngineData<Algorithm> &engine_working_data,
         return std::make_tuple(INVALID_EDGE_WEIGHT, std::vector<NodeID>(), std::vector<EdgeID>());
     }
 
-    // Get packed path as edges {from node ID, to node ID, edge ID}
-    std::vector<std::tuple<NodeID, NodeID, bool>> packed_path;
-    NodeID current_node = middle, parent_node = forward_heap.GetData(middle).parent;
-    while (parent_node != current_node)
-    {
-        const auto &data = forward_heap.GetData(current_node);
-        packed_path.push_back(std::make_tuple(parent_node, current_node, data.from_clique_arc));
-        current_node = parent_node;
-        parent_node = forward_heap.GetData(parent_node).parent;
-    }
-    std::reverse(std::begin(packed_path), std::end(packed_path));
-    const NodeID source_node = current_node;
-
-    current_node = middle, parent_node = reverse_heap.GetData(middle).parent;
-    while (parent_node != current_node)
-    {
-        const auto &data = reverse_heap.GetData(current_node);
-        packed_path.push_back(std::make_tuple(current_node, parent_node, data.from_clique_arc));
-        current_node = parent_node;
-        parent_node = reverse_heap.GetData(parent_node).parent;
-    }
+    const auto packed_path = retrievePackedPathFromHeap(forward_heap, reverse_heap, middle);
+    const NodeID source_node = packed_path.empty() ? middle : std::get<0>(packed_path.front());
 
-    // Unpack path
     std::vector<NodeID> unpacked_nodes;
     std::vector<EdgeID> unpacked_edges;
-    unpacked_nodes.reserve(packed_path.size());
-    unpacked_edges.reserve(packed_path.size());
-
-    unpacked_nodes.push_back(source_node);
-    for (auto const &packed_edge : packed_path)
-    {
-        NodeID source, target;
-        bool overlay_edge;
-        std::tie(source, target, overlay_edge) = packed_edge;
-        if (!overlay_edge)
-        { // a base graph edge
-            unpacked_nodes.push_back(target);
-            unpacked_edges.push_back(facade.FindEdge(source, target));
-        }
-        else
-        { // an overlay graph edge
-            LevelID level = getNodeQureyLevel(partition, source, args...);
-            CellID parent_cell_id = partition.GetCell(level, source);
-            BOOST_ASSERT(parent_cell_id == partition.GetCell(level, target));
-
-            LevelID sublevel = level - 1;
-
-            // Here heaps can be reused, let's go deeper!
-            forward_heap.Clear();
-            reverse_heap.Clear();
-            forward_heap.Insert(source, 0, {source});
-            reverse_heap.Insert(target, 0, {target});
-
-            // TODO: when structured bindings will be allowed change to
-            // auto [subpath_weight, subpath_source, subpath_target, subpath] = ...
-            EdgeWeight subpath_weight;
-            std::vector<NodeID> subpath_nodes;
-            std::vector<EdgeID> subpath_edges;
-            std::tie(subpath_weight, subpath_nodes, subpath_edges) = search(engine_working_data,
-                                                                            facade,
-                                                                            forward_heap,
-                                                                            reverse_heap,
-                                                                            force_loop_forward,
-                                                                            force_loop_reverse,
-                                                                            INVALID_EDGE_WEIGHT,
-                                                                            sublevel,
-                                                                            parent_cell_id);
-            BOOST_ASSERT(!subpath_edges.empty());
-            BOOST_ASSERT(subpath_nodes.size() > 1);
-            BOOST_ASSERT(subpath_nodes.front() == source);
-            BOOST_ASSERT(subpath_nodes.back() == target);
-            unpacked_nodes.insert(
-                unpacked_nodes.end(), std::next(subpath_nodes.begin()), subpath_nodes.end());
-            unpacked_edges.insert(unpacked_edges.end(), subpath_edges.begin(), subpath_edges.end());
-        }
-    }
+    unpackPath(engine_working_data,
+               facade,
+               forward_heap,
+               reverse_heap,
+               force_loop_forward,
+               force_loop_reverse,
+               source_node,
+               packed_path,
+               unpacked_nodes,
+               unpacked_edges,
+               args...);
 
     return std::make_tuple(weight, std::move(unpacked_nodes), std::move(unpacked_edges));
 }
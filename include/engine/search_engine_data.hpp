@@ -7,6 +7,9 @@
 #include "util/query_heap.hpp"
 #include "util/typedefs.hpp"
 
+#include <cstddef>
+#include <limits>
+
 namespace osrm
 {
 namespace engine
@@ -21,12 +24,24 @@ template <typename Algorithm> struct SearchEngineData
 {
 };
 
+// Heaps index their nodes in a generation array if it fits into the memory budget,
+// otherwise they fall back to a hash map (see util::AdaptiveStorage)
+using HeapIndexStorage = util::AdaptiveStorage<NodeID, int>;
+
 struct HeapData
 {
     NodeID parent;
     /* explicit */ HeapData(NodeID p) : parent(p) {}
 };
 
+// The alternative path search keeps the weight a node shares with the shortest path next to its
+// parent. It fits into the padding of the heap nodes, so all CH query heaps use it.
+struct SharingHeapData : HeapData
+{
+    EdgeWeight sharing;
+    /* explicit */ SharingHeapData(NodeID p) : HeapData(p), sharing(0) {}
+};
+
 struct ManyToManyHeapData : HeapData
 {
     EdgeWeight duration;
@@ -35,15 +50,15 @@ struct ManyToManyHeapData : HeapData
 
 template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
 {
-    using QueryHeap = util::
-        QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, util::UnorderedMapStorage<NodeID, int>>;
+    using QueryHeap =
+        util::QueryHeap<NodeID, NodeID, EdgeWeight, SharingHeapData, HeapIndexStorage>;
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
 
     using ManyToManyQueryHeap = util::QueryHeap<NodeID,
                                                 NodeID,
                                                 EdgeWeight,
                                                 ManyToManyHeapData,
-                                                util::UnorderedMapStorage<NodeID, int>>;
+                                                HeapIndexStorage>;
 
     using ManyToManyHeapPtr = boost::thread_specific_ptr<ManyToManyQueryHeap>;
 
@@ -51,16 +66,25 @@ template <> struct SearchEngineData<routing_algorithms::ch::Algorithm>
     static SearchEngineHeapPtr reverse_heap_1;
     static SearchEngineHeapPtr forward_heap_2;
     static SearchEngineHeapPtr reverse_heap_2;
-    static SearchEngineHeapPtr forward_heap_3;
-    static SearchEngineHeapPtr reverse_heap_3;
     static ManyToManyHeapPtr many_to_many_heap;
 
+    // Maximal size in bytes of the node index of a single thread-local heap
+    const std::size_t max_heap_index_memory;
+    // Maximal number of threads a single many-to-many search may use (-1 for all)
+    const int max_many_to_many_threads;
+
+    explicit SearchEngineData(
+        std::size_t max_heap_index_memory = std::numeric_limits<std::size_t>::max(),
+        int max_many_to_many_threads = 1)
+        : max_heap_index_memory(max_heap_index_memory),
+          max_many_to_many_threads(max_many_to_many_threads)
+    {
+    }
+
     void InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes);
 
     void InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes);
 
-    void InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes);
-
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes);
 };
 
@@ -68,6 +92,7 @@ template <>
 struct SearchEngineData<routing_algorithms::corech::Algorithm>
     : public SearchEngineData<routing_algorithms::ch::Algorithm>
 {
+    using SearchEngineData<routing_algorithms::ch::Algorithm>::SearchEngineData;
 };
 
 struct MultiLayerDijkstraHeapData
@@ -97,13 +122,13 @@ template <> struct SearchEngineData<routing_algorithms::mld::Algorithm>
                                       NodeID,
                                       EdgeWeight,
                                       MultiLayerDijkstraHeapData,
-                                      util::UnorderedMapStorage<NodeID, int>>;
+                                      HeapIndexStorage>;
 
     using ManyToManyQueryHeap = util::QueryHeap<NodeID,
                                                 NodeID,
                                                 EdgeWeight,
                                                 ManyToManyMultiLayerDijkstraHeapData,
-                                                util::UnorderedMapStorage<NodeID, int>>;
+                                                HeapIndexStorage>;
 
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
 
@@ -111,10 +136,27 @@ template <> struct SearchEngineData<routing_algorithms::mld::Algorithm>
 
     static SearchEngineHeapPtr forward_heap_1;
     static SearchEngineHeapPtr reverse_heap_1;
+    static SearchEngineHeapPtr forward_heap_2;
+    static SearchEngineHeapPtr reverse_heap_2;
     static ManyToManyHeapPtr many_to_many_heap;
 
+    // Maximal size in bytes of the node index of a single thread-local heap
+    const std::size_t max_heap_index_memory;
+    // Maximal number of threads a single many-to-many search may use (-1 for all)
+    const int max_many_to_many_threads;
+
+    explicit SearchEngineData(
+        std::size_t max_heap_index_memory = std::numeric_limits<std::size_t>::max(),
+        int max_many_to_many_threads = 1)
+        : max_heap_index_memory(max_heap_index_memory),
+          max_many_to_many_threads(max_many_to_many_threads)
+    {
+    }
+
     void InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes);
 
+    void InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes);
+
     void InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes);
 };
 }
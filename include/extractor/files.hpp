@@ -184,6 +184,17 @@ inline void readSegmentData(const boost::filesystem::path &path, SegmentDataT &s
     serialization::read(reader, segment_data);
 }
 
+// reads .osrm.geometry with the node lists packed by the encoder
+inline void readSegmentData(const boost::filesystem::path &path,
+                            SegmentDataView &segment_data,
+                            PackedGeometryEncoder &encoder)
+{
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    serialization::read(reader, segment_data, encoder);
+}
+
 // writes .osrm.geometry
 template <typename SegmentDataT>
 inline void writeSegmentData(const boost::filesystem::path &path, const SegmentDataT &segment_data)
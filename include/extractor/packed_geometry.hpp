@@ -0,0 +1,336 @@
+#ifndef OSRM_EXTRACTOR_PACKED_GEOMETRY_HPP_
+#define OSRM_EXTRACTOR_PACKED_GEOMETRY_HPP_
+
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include "storage/shared_memory_ownership.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * The geometry node lists of the SegmentDataContainer in compressed form.
+ *
+ * The first node of every geometry is stored as is. Every other node is stored as the zig-zag
+ * encoded difference to its predecessor, since the nodes of a way are numbered close to each
+ * other. The differences are bit-packed in blocks of BLOCK_SIZE node positions, with the width
+ * of the largest difference of the block. The slot of the first node of a geometry stays
+ * unused, so the node positions are the same as in the SegmentDataContainer index.
+ */
+struct PackedGeometryBlock
+{
+    std::uint64_t bit_offset : 58;
+    std::uint64_t bits : 6;
+};
+static_assert(sizeof(PackedGeometryBlock) == 8, "block header must fit into 64 bits");
+
+namespace detail
+{
+const constexpr std::size_t PACKED_GEOMETRY_BLOCK_SIZE = 64;
+
+inline std::uint32_t zigzagEncode(const NodeID node, const NodeID previous)
+{
+    // modular difference, interpreted as signed value
+    const auto difference = static_cast<std::int32_t>(node - previous);
+    return (static_cast<std::uint32_t>(difference) << 1) ^
+           static_cast<std::uint32_t>(difference >> 31);
+}
+
+inline NodeID zigzagDecode(const std::uint32_t delta, const NodeID previous)
+{
+    return previous + ((delta >> 1) ^ (0u - (delta & 1u)));
+}
+
+// Inverse of zigzagDecode: the node before node
+inline NodeID zigzagUndo(const std::uint32_t delta, const NodeID node)
+{
+    return node - ((delta >> 1) ^ (0u - (delta & 1u)));
+}
+
+template <storage::Ownership Ownership> class PackedGeometryImpl
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+  public:
+    using WordT = std::uint64_t;
+    static constexpr std::size_t BLOCK_SIZE = PACKED_GEOMETRY_BLOCK_SIZE;
+
+    PackedGeometryImpl() = default;
+
+    PackedGeometryImpl(Vector<NodeID> first_nodes_,
+                       Vector<PackedGeometryBlock> blocks_,
+                       Vector<WordT> words_)
+        : first_nodes(std::move(first_nodes_)), blocks(std::move(blocks_)),
+          words(std::move(words_))
+    {
+    }
+
+    bool empty() const { return first_nodes.empty(); }
+
+    // Writes the nodes of geometry id, which has the node positions [begin, end)
+    template <typename OutputIter>
+    OutputIter Decode(const std::uint32_t id,
+                      const std::uint32_t begin,
+                      const std::uint32_t end,
+                      OutputIter out) const
+    {
+        if (begin == end)
+            return out;
+
+        auto node = first_nodes[id];
+        *out++ = node;
+        for (auto position = begin + 1; position < end; ++position)
+        {
+            node = zigzagDecode(GetDelta(position), node);
+            *out++ = node;
+        }
+        return out;
+    }
+
+    // The last node of geometry id, which has the node positions [begin, end)
+    NodeID GetLastNode(const std::uint32_t id,
+                       const std::uint32_t begin,
+                       const std::uint32_t end) const
+    {
+        BOOST_ASSERT(begin < end);
+        auto node = first_nodes[id];
+        for (auto position = begin + 1; position < end; ++position)
+            node = zigzagDecode(GetDelta(position), node);
+        return node;
+    }
+
+    NodeID GetFirstNode(const std::uint32_t id) const { return first_nodes[id]; }
+
+    // The zig-zag encoded difference of the node at position to its predecessor, 0 for the
+    // first node of a geometry
+    std::uint32_t GetDelta(const std::uint32_t position) const
+    {
+        const auto block = blocks[position / BLOCK_SIZE];
+        const std::uint64_t bit = block.bit_offset + (position % BLOCK_SIZE) * block.bits;
+        const auto word = bit / 64;
+        const auto offset = bit % 64;
+        // There is always a padding word at the end. Shifting twice avoids shifting by 64 bits
+        // if the value lies in one word, so no branch is needed.
+        const WordT value = (words[word] >> offset) | ((words[word + 1] << 1) << (63 - offset));
+        const WordT mask = (WordT{1} << block.bits) - 1;
+        return static_cast<std::uint32_t>(value & mask);
+    }
+
+  private:
+    Vector<NodeID> first_nodes;
+    Vector<PackedGeometryBlock> blocks;
+    Vector<WordT> words;
+};
+}
+
+/**
+ * Packs the node lists in one pass over the nodes in order.
+ *
+ * Without output pointers it only counts the blocks and words of the packed form, so memory
+ * of the right size can be allocated before packing into it.
+ */
+class PackedGeometryEncoder
+{
+  public:
+    using WordT = std::uint64_t;
+    static constexpr std::size_t BLOCK_SIZE = detail::PACKED_GEOMETRY_BLOCK_SIZE;
+
+    // index has one more entry than there are geometries, like the SegmentDataContainer index
+    PackedGeometryEncoder(const std::uint32_t *index,
+                          const std::size_t index_size,
+                          NodeID *first_nodes = nullptr,
+                          PackedGeometryBlock *blocks = nullptr,
+                          WordT *words = nullptr)
+        : index(index), number_of_geometries(index_size > 0 ? index_size - 1 : 0),
+          first_nodes(first_nodes), blocks(blocks), words(words)
+    {
+    }
+
+    void Push(const NodeID node)
+    {
+        bool is_first = false;
+        while (next_geometry < number_of_geometries && index[next_geometry] == position)
+        {
+            if (first_nodes)
+                first_nodes[next_geometry] = node;
+            ++next_geometry;
+            is_first = true;
+        }
+
+        deltas[position % BLOCK_SIZE] = is_first ? 0 : detail::zigzagEncode(node, previous);
+        previous = node;
+        ++position;
+
+        if (position % BLOCK_SIZE == 0)
+            FlushBlock(BLOCK_SIZE);
+    }
+
+    template <typename Iter> void Push(Iter begin, const Iter end)
+    {
+        std::for_each(begin, end, [this](const NodeID node) { Push(node); });
+    }
+
+    void Finish()
+    {
+        // trailing geometries without nodes
+        for (; next_geometry < number_of_geometries; ++next_geometry)
+        {
+            if (first_nodes)
+                first_nodes[next_geometry] = SPECIAL_NODEID;
+        }
+
+        if (position % BLOCK_SIZE != 0)
+            FlushBlock(position % BLOCK_SIZE);
+
+        if (words)
+        {
+            const auto used_words = (bit_offset + 63) / 64;
+            std::fill(words + used_words, words + GetNumberOfWords(), 0);
+        }
+    }
+
+    std::size_t GetNumberOfGeometries() const { return number_of_geometries; }
+    std::size_t GetNumberOfNodes() const { return position; }
+    std::size_t GetNumberOfBlocks() const { return number_of_blocks; }
+    // includes the padding word the decoder may read
+    std::size_t GetNumberOfWords() const { return (bit_offset + 63) / 64 + 1; }
+
+  private:
+    void FlushBlock(const std::size_t count)
+    {
+        std::uint32_t max_delta = 0;
+        for (std::size_t index = 0; index < count; ++index)
+            max_delta = std::max(max_delta, deltas[index]);
+
+        std::uint64_t bits = 0;
+        while (bits < 32 && (max_delta >> bits) != 0)
+            ++bits;
+
+        if (blocks)
+        {
+            blocks[number_of_blocks].bit_offset = bit_offset;
+            blocks[number_of_blocks].bits = bits;
+        }
+
+        if (words && bits > 0)
+        {
+            for (std::size_t index = 0; index < count; ++index)
+            {
+                const auto word = bit_offset / 64;
+                const auto offset = bit_offset % 64;
+                const WordT value = deltas[index];
+                // words are written in order, so the first write to a word assigns it
+                words[word] = offset == 0 ? value : words[word] | (value << offset);
+                if (offset + bits > 64)
+                    words[word + 1] = value >> (64 - offset);
+                bit_offset += bits;
+            }
+        }
+        else
+        {
+            bit_offset += count * bits;
+        }
+
+        ++number_of_blocks;
+    }
+
+    const std::uint32_t *index;
+    const std::size_t number_of_geometries;
+    NodeID *first_nodes;
+    PackedGeometryBlock *blocks;
+    WordT *words;
+
+    std::array<std::uint32_t, BLOCK_SIZE> deltas;
+    std::size_t next_geometry = 0;
+    std::uint32_t position = 0;
+    NodeID previous = 0;
+    std::size_t number_of_blocks = 0;
+    std::uint64_t bit_offset = 0;
+};
+
+using PackedGeometryView = detail::PackedGeometryImpl<storage::Ownership::View>;
+using PackedGeometry = detail::PackedGeometryImpl<storage::Ownership::Container>;
+
+/**
+ * Iterates over the nodes of a geometry, either in a plain node list or in a PackedGeometryView.
+ *
+ * Packed nodes are decoded on the fly, the iterator keeps the node before its position. Moving
+ * it by n positions takes n steps, so it is only a bidirectional iterator.
+ */
+class GeometryIterator : public boost::iterator_facade<GeometryIterator,
+                                                       const NodeID,
+                                                       boost::bidirectional_traversal_tag,
+                                                       NodeID>
+{
+  public:
+    // the nodes are returned by value, but all operations of a bidirectional iterator exist
+    typedef std::bidirectional_iterator_tag iterator_category;
+
+    GeometryIterator() = default;
+
+    explicit GeometryIterator(const NodeID *node) : node(node) {}
+
+    // previous is the node before position, or the first node if position is the first one
+    GeometryIterator(const PackedGeometryView *packed,
+                     const std::uint32_t position,
+                     const NodeID previous)
+        : packed(packed), position(position), previous(previous)
+    {
+    }
+
+  private:
+    friend class boost::iterator_core_access;
+
+    NodeID dereference() const
+    {
+        return node ? *node : detail::zigzagDecode(packed->GetDelta(position), previous);
+    }
+
+    bool equal(const GeometryIterator &other) const
+    {
+        return node == other.node && position == other.position;
+    }
+
+    void increment()
+    {
+        if (node)
+        {
+            ++node;
+            return;
+        }
+        previous = dereference();
+        ++position;
+    }
+
+    void decrement()
+    {
+        if (node)
+        {
+            --node;
+            return;
+        }
+        --position;
+        previous = detail::zigzagUndo(packed->GetDelta(position), previous);
+    }
+
+    const NodeID *node = nullptr;
+    const PackedGeometryView *packed = nullptr;
+    std::uint32_t position = 0;
+    NodeID previous = SPECIAL_NODEID;
+};
+}
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef OSRM_EXTRACTOR_RENUMBER_HPP
+#define OSRM_EXTRACTOR_RENUMBER_HPP
+
+#include "extractor/edge_based_edge.hpp"
+#include "extractor/edge_based_node_segment.hpp"
+#include "extractor/files.hpp"
+#include "extractor/nbg_to_ebg.hpp"
+#include "extractor/node_data_container.hpp"
+
+#include "util/mmap_file.hpp"
+#include "util/typedefs.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <tbb/parallel_sort.h>
+
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+// Renumbering of the edge-based node IDs stored in the files of osrm-extract, used by
+// osrm-partition and osrm-contract --renumber-nodes. The permutation maps old to new IDs.
+
+inline void renumber(EdgeBasedNodeDataContainer &node_data_container,
+                     const std::vector<NodeID> &permutation)
+{
+    node_data_container.Renumber(permutation);
+}
+
+inline void renumber(util::vector_view<EdgeBasedNodeSegment> &segments,
+                     const std::vector<NodeID> &permutation)
+{
+    for (auto &segment : segments)
+    {
+        BOOST_ASSERT(segment.forward_segment_id.enabled);
+        segment.forward_segment_id.id = permutation[segment.forward_segment_id.id];
+        if (segment.reverse_segment_id.enabled)
+            segment.reverse_segment_id.id = permutation[segment.reverse_segment_id.id];
+    }
+}
+
+inline void renumber(std::vector<EdgeBasedEdge> &edges, const std::vector<NodeID> &permutation)
+{
+    for (auto &edge : edges)
+    {
+        edge.source = permutation[edge.source];
+        edge.target = permutation[edge.target];
+    }
+    tbb::parallel_sort(edges.begin(), edges.end(), [](const auto &lhs, const auto &rhs) {
+        return std::tie(lhs.source, lhs.target) < std::tie(rhs.source, rhs.target);
+    });
+}
+
+inline void renumber(std::vector<NBGToEBG> &mapping, const std::vector<NodeID> &permutation)
+{
+    for (auto &entry : mapping)
+    {
+        entry.forward_ebg_node = permutation[entry.forward_ebg_node];
+        if (entry.backward_ebg_node != SPECIAL_NODEID)
+            entry.backward_ebg_node = permutation[entry.backward_ebg_node];
+    }
+}
+
+// Rewrites the segments of the .fileIndex in place and the .ebg_nodes file
+inline void renumberNodeFiles(const boost::filesystem::path &file_index_path,
+                              const boost::filesystem::path &node_data_path,
+                              const std::vector<NodeID> &permutation)
+{
+    {
+        boost::iostreams::mapped_file segment_region;
+        auto segments = util::mmapFile<EdgeBasedNodeSegment>(file_index_path, segment_region);
+        renumber(segments, permutation);
+    }
+    {
+        EdgeBasedNodeDataContainer node_data;
+        files::readNodeData(node_data_path, node_data);
+        renumber(node_data, permutation);
+        files::writeNodeData(node_data_path, node_data);
+    }
+}
+}
+}
+
+#endif
@@ -29,12 +29,18 @@ namespace detail
 template <storage::Ownership Ownership> class SegmentDataContainerImpl;
 }
 
+class PackedGeometryEncoder;
+
 namespace serialization
 {
 template <storage::Ownership Ownership>
 inline void read(storage::io::FileReader &reader,
                  detail::SegmentDataContainerImpl<Ownership> &segment_data);
 template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader,
+                 detail::SegmentDataContainerImpl<Ownership> &segment_data,
+                 PackedGeometryEncoder &encoder);
+template <storage::Ownership Ownership>
 inline void write(storage::io::FileWriter &writer,
                   const detail::SegmentDataContainerImpl<Ownership> &segment_data);
 }
@@ -199,6 +205,10 @@ template <storage::Ownership Ownership> class SegmentDataContainerImpl
     friend void
     serialization::read<Ownership>(storage::io::FileReader &reader,
                                    detail::SegmentDataContainerImpl<Ownership> &segment_data);
+    friend void
+    serialization::read<Ownership>(storage::io::FileReader &reader,
+                                   detail::SegmentDataContainerImpl<Ownership> &segment_data,
+                                   PackedGeometryEncoder &encoder);
     friend void serialization::write<Ownership>(
         storage::io::FileWriter &writer,
         const detail::SegmentDataContainerImpl<Ownership> &segment_data);
@@ -5,6 +5,7 @@
 #include "extractor/intersection_bearings_container.hpp"
 #include "extractor/nbg_to_ebg.hpp"
 #include "extractor/node_data_container.hpp"
+#include "extractor/packed_geometry.hpp"
 #include "extractor/profile_properties.hpp"
 #include "extractor/restriction.hpp"
 #include "extractor/segment_data_container.hpp"
@@ -15,6 +16,9 @@
 
 #include <boost/assert.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace osrm
 {
 namespace extractor
@@ -90,6 +94,39 @@ inline void write(storage::io::FileWriter &writer,
     storage::serialization::write(writer, segment_data.datasources);
 }
 
+// Passes a node list as written by storage::serialization::write to the encoder in chunks,
+// so it is never loaded as a whole
+inline void readPackedNodes(storage::io::FileReader &reader, PackedGeometryEncoder &encoder)
+{
+    const std::uint64_t CHUNK_SIZE = 1 << 20;
+
+    auto count = reader.ReadElementCount64();
+    std::vector<NodeID> chunk(std::min(count, CHUNK_SIZE));
+    while (count > 0)
+    {
+        const auto chunk_size = std::min(count, CHUNK_SIZE);
+        reader.ReadInto(chunk.data(), chunk_size);
+        encoder.Push(chunk.begin(), chunk.begin() + chunk_size);
+        count -= chunk_size;
+    }
+    encoder.Finish();
+}
+
+// Reads the segment data but packs the node lists with the encoder instead of storing them
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader,
+                 detail::SegmentDataContainerImpl<Ownership> &segment_data,
+                 PackedGeometryEncoder &encoder)
+{
+    storage::serialization::read(reader, segment_data.index);
+    readPackedNodes(reader, encoder);
+    util::serialization::read(reader, segment_data.fwd_weights);
+    util::serialization::read(reader, segment_data.rev_weights);
+    util::serialization::read(reader, segment_data.fwd_durations);
+    util::serialization::read(reader, segment_data.rev_durations);
+    storage::serialization::read(reader, segment_data.datasources);
+}
+
 // read/write for turn data file
 template <storage::Ownership Ownership>
 inline void read(storage::io::FileReader &reader,
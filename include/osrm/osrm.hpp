@@ -37,6 +37,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace osrm
 {
 namespace json = util::json;
+namespace binary = util::binary;
 using engine::EngineConfig;
 using engine::api::RouteParameters;
 using engine::api::TableParameters;
@@ -85,6 +86,17 @@ class OSRM final
      */
     Status Route(const RouteParameters &parameters, json::Object &result) const;
 
+    /**
+     * Shortest path queries for coordinates in the binary response format.
+     *
+     * Contains the waypoints and the summary and overview geometry of each route.
+     *
+     * \param parameters route query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, RouteParameters and binary::Writer
+     */
+    Status Route(const RouteParameters &parameters, binary::Writer &result) const;
+
     /**
      * Distance tables for coordinates.
      *
@@ -94,6 +106,28 @@ class OSRM final
      */
     Status Table(const TableParameters &parameters, json::Object &result) const;
 
+    /**
+     * Distance tables for coordinates, written directly as JSON.
+     *
+     * Large tables are rendered without building a json::Object first.
+     *
+     * \param parameters table query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, TableParameters and json::Writer
+     */
+    Status Table(const TableParameters &parameters, json::Writer &result) const;
+
+    /**
+     * Distance tables for coordinates in the binary response format.
+     *
+     * The durations are a contiguous array of floats without any JSON encoding.
+     *
+     * \param parameters table query specific parameters
+     * \return Status indicating success for the query or failure
+     * \see Status, TableParameters and binary::Writer
+     */
+    Status Table(const TableParameters &parameters, binary::Writer &result) const;
+
     /**
      * Nearest street segment for coordinate.
      *
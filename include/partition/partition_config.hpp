@@ -41,6 +41,7 @@ struct PartitionConfig
         file_index_path = basepath + ".osrm.fileIndex";
         partition_path = basepath + ".osrm.partition";
         storage_path = basepath + ".osrm.cells";
+        cell_updates_path = basepath + ".osrm.cell_updates";
         node_data_path = basepath + ".osrm.ebg_nodes";
         hsgr_path = basepath + ".osrm.hsgr";
     }
@@ -53,6 +54,7 @@ struct PartitionConfig
     boost::filesystem::path partition_path;
     boost::filesystem::path file_index_path;
     boost::filesystem::path storage_path;
+    boost::filesystem::path cell_updates_path;
     boost::filesystem::path node_data_path;
     boost::filesystem::path hsgr_path;
 
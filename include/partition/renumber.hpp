@@ -1,8 +1,7 @@
 #ifndef OSRM_PARTITION_RENUMBER_HPP
 #define OSRM_PARTITION_RENUMBER_HPP
 
-#include "extractor/edge_based_node_segment.hpp"
-#include "extractor/node_data_container.hpp"
+#include "extractor/renumber.hpp"
 
 #include "partition/bisection_to_partition.hpp"
 #include "partition/edge_based_graph.hpp"
@@ -14,6 +13,9 @@ namespace osrm
 {
 namespace partition
 {
+
+using extractor::renumber;
+
 std::vector<std::uint32_t> makePermutation(const DynamicEdgeBasedGraph &graph,
                                            const std::vector<Partition> &partitions);
 
@@ -33,12 +35,6 @@ inline void renumber(util::StaticGraph<EdgeDataT> &graph,
     graph.Renumber(permutation);
 }
 
-inline void renumber(extractor::EdgeBasedNodeDataContainer &node_data_container,
-                     const std::vector<std::uint32_t> &permutation)
-{
-    node_data_container.Renumber(permutation);
-}
-
 inline void renumber(std::vector<Partition> &partitions,
                      const std::vector<std::uint32_t> &permutation)
 {
@@ -47,18 +43,6 @@ inline void renumber(std::vector<Partition> &partitions,
         util::inplacePermutation(partition.begin(), partition.end(), permutation);
     }
 }
-
-inline void renumber(util::vector_view<extractor::EdgeBasedNodeSegment> &segments,
-                     const std::vector<std::uint32_t> &permutation)
-{
-    for (auto &segment : segments)
-    {
-        BOOST_ASSERT(segment.forward_segment_id.enabled);
-        segment.forward_segment_id.id = permutation[segment.forward_segment_id.id];
-        if (segment.reverse_segment_id.enabled)
-            segment.reverse_segment_id.id = permutation[segment.reverse_segment_id.id];
-    }
-}
 }
 }
 
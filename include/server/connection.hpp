@@ -32,12 +32,26 @@ namespace server
 {
 
 class RequestHandler;
+class RequestExecutor;
 
-/// Represents a single connection from a client.
+struct ConnectionConfig
+{
+    // Seconds to wait for the next request on a persistent connection (0 disables keep-alive)
+    unsigned keepalive_timeout = 5;
+    // Number of requests served on one connection before it is closed
+    unsigned keepalive_max_requests = 512;
+};
+
+/// Represents a single connection from a client. HTTP/1.1 connections (and HTTP/1.0
+/// connections asking for it) are kept open for further requests, including requests
+/// pipelined behind the current one. Replies are written in the order of the requests.
 class Connection : public std::enable_shared_from_this<Connection>
 {
   public:
-    explicit Connection(boost::asio::io_service &io_service, RequestHandler &handler);
+    explicit Connection(boost::asio::io_service &io_service,
+                        RequestHandler &handler,
+                        RequestExecutor &executor,
+                        const ConnectionConfig &config);
     Connection(const Connection &) = delete;
     Connection &operator=(const Connection &) = delete;
 
@@ -47,19 +61,41 @@ class Connection : public std::enable_shared_from_this<Connection>
     void start();
 
   private:
+    /// Waits for (the rest of) a request, closing the connection if it stays idle too long.
+    void read_request();
+
     void handle_read(const boost::system::error_code &e, std::size_t bytes_transferred);
 
+    void handle_timeout(const boost::system::error_code &e);
+
+    /// Parses the received data and dispatches the request once it is complete.
+    void process_data(char *begin, char *end);
+
+    /// Runs the query and prepares the reply, called on a compute thread of the executor.
+    void handle_request(const http::compression_type compression_type);
+
+    /// Writes the prepared reply to the socket.
+    void write_reply();
+
     /// Handle completion of a write operation.
     void handle_write(const boost::system::error_code &e);
 
     std::vector<char> compress_buffers(const std::vector<char> &uncompressed_data,
                                        const http::compression_type compression_type);
 
+    const ConnectionConfig config;
     boost::asio::io_service::strand strand;
     boost::asio::ip::tcp::socket TCP_socket;
+    boost::asio::deadline_timer timer;
     RequestHandler &request_handler;
+    RequestExecutor &request_executor;
     RequestParser request_parser;
     boost::array<char, 8192> incoming_data_buffer;
+    // received data following the current request, i.e. pipelined requests
+    char *unparsed_begin;
+    char *unparsed_end;
+    unsigned processed_requests;
+    bool keep_alive;
     http::request current_request;
     http::reply current_reply;
     std::vector<char> compressed_output;
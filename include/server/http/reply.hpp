@@ -21,9 +21,12 @@ class reply
     {
         ok = 200,
         bad_request = 400,
-        internal_server_error = 500
+        internal_server_error = 500,
+        service_unavailable = 503
     } status;
 
+    // answer with HTTP/1.1 instead of HTTP/1.0 status lines
+    bool http_1_1;
     std::vector<header> headers;
     std::vector<boost::asio::const_buffer> to_buffers();
     std::vector<boost::asio::const_buffer> headers_to_buffers();
@@ -31,6 +34,7 @@ class reply
     static reply stock_reply(const status_type status);
     void set_size(const std::size_t size);
     void set_uncompressed_size();
+    void set_keep_alive(const bool keep_alive);
 
     reply();
 
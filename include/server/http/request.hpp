@@ -17,6 +17,9 @@ struct request
     std::string uri;
     std::string referrer;
     std::string agent;
+    std::string connection;
+    unsigned http_version_major = 0;
+    unsigned http_version_minor = 0;
     boost::asio::ip::address endpoint;
 };
 }
@@ -0,0 +1,111 @@
+#ifndef REQUEST_EXECUTOR_HPP
+#define REQUEST_EXECUTOR_HPP
+
+#include "util/metrics.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace server
+{
+
+struct RequestExecutorConfig
+{
+    // Number of threads executing queries
+    unsigned num_threads = 1;
+    // Requests are rejected if this many requests are waiting already (-1 for unlimited)
+    int max_queue_size = -1;
+    // Services with their own queue and statistics, requests to other URIs share one queue
+    std::vector<std::string> services = {"route", "table", "nearest", "trip", "match", "tile"};
+    // Number of requests per service (e.g. "table") that may run at the same time
+    std::unordered_map<std::string, unsigned> max_concurrent_requests;
+    // Spreads the threads over the NUMA nodes and pins each thread to its node
+    bool pin_numa_nodes = false;
+};
+
+/// Executes requests on a bounded pool of compute threads, so the I/O threads of the
+/// server never block on expensive queries. Requests wait in a queue per service and
+/// are started in arrival order as long as their service is below its concurrency limit.
+/// The queue sizes, rejections and queue wait times are also exported by util::metrics.
+class RequestExecutor
+{
+  public:
+    using Task = std::function<void()>;
+
+    struct Statistics
+    {
+        std::uint64_t executed = 0;
+        std::uint64_t rejected = 0;
+        // Time in microseconds the executed requests waited in the queue
+        util::metrics::Histogram wait_us;
+    };
+
+    explicit RequestExecutor(RequestExecutorConfig config);
+    ~RequestExecutor();
+
+    RequestExecutor(const RequestExecutor &) = delete;
+    RequestExecutor &operator=(const RequestExecutor &) = delete;
+
+    /// Queues the task for the service the URI belongs to.
+    /// Returns false if the request was rejected because the queue is full.
+    bool Post(const std::string &uri, Task task);
+
+    /// Waits for all running tasks and stops the compute threads. Queued tasks are dropped.
+    void Stop();
+
+    /// Number of tasks waiting for execution
+    std::size_t QueueSize() const;
+
+    /// Statistics per service name
+    std::vector<std::pair<std::string, Statistics>> GetStatistics() const;
+
+    /// Extracts the service name from an URI like /route/v1/driving/...
+    static std::string ServiceName(const std::string &uri);
+
+  private:
+    struct QueuedTask
+    {
+        Task task;
+        std::chrono::steady_clock::time_point enqueued;
+    };
+
+    struct ServiceQueue
+    {
+        std::deque<QueuedTask> tasks;
+        unsigned running = 0;
+        unsigned max_running = 0;
+        util::metrics::Endpoint endpoint = util::metrics::Endpoint::Other;
+        Statistics statistics;
+    };
+
+    using ServiceQueues = std::unordered_map<std::string, ServiceQueue>;
+
+    void Work();
+    ServiceQueues::iterator NextRunnableQueue();
+    ServiceQueue &GetQueue(const std::string &service);
+
+    const RequestExecutorConfig config;
+
+    mutable std::mutex mutex;
+    std::condition_variable task_available;
+    ServiceQueues queues;
+    std::size_t queued_tasks;
+    bool stopped;
+
+    std::vector<std::thread> threads;
+};
+}
+}
+
+#endif // REQUEST_EXECUTOR_HPP
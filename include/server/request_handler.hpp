@@ -28,7 +28,12 @@ class RequestHandler
 
     void HandleRequest(const http::request &current_request, http::reply &current_reply);
 
+    // Engine metrics in the Prometheus text format are served on this path
+    static constexpr const char *METRICS_PATH = "/metrics";
+
   private:
+    void HandleMetricsRequest(http::reply &current_reply);
+
     std::unique_ptr<ServiceHandlerInterface> service_handler;
 };
 }
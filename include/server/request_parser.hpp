@@ -28,7 +28,9 @@ class RequestParser
         indeterminate
     };
 
-    std::tuple<RequestStatus, http::compression_type>
+    /// Parses until a request is complete. The returned pointer marks the first character
+    /// that was not consumed, which is the start of the next pipelined request if any.
+    std::tuple<RequestStatus, http::compression_type, char *>
     parse(http::request &current_request, char *begin, char *end);
 
   private:
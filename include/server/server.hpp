@@ -2,6 +2,7 @@
 #define SERVER_HPP
 
 #include "server/connection.hpp"
+#include "server/request_executor.hpp"
 #include "server/request_handler.hpp"
 #include "server/service_handler.hpp"
 
@@ -33,18 +34,37 @@ class Server
 {
   public:
     // Note: returns a shared instead of a unique ptr as it is captured in a lambda somewhere else
-    static std::shared_ptr<Server>
-    CreateServer(std::string &ip_address, int ip_port, unsigned requested_num_threads)
+    // Queries run on requested_num_threads compute threads, while requested_num_io_threads
+    // threads accept connections, parse requests and write replies.
+    static std::shared_ptr<Server> CreateServer(std::string &ip_address,
+                                                int ip_port,
+                                                unsigned requested_num_threads,
+                                                unsigned requested_num_io_threads,
+                                                RequestExecutorConfig executor_config,
+                                                const ConnectionConfig &connection_config)
     {
         util::Log() << "http 1.1 compression handled by zlib version " << zlibVersion();
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
-        const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads);
+        executor_config.num_threads = std::min(hardware_threads, requested_num_threads);
+        const unsigned real_num_io_threads =
+            std::max(1u, std::min(hardware_threads, requested_num_io_threads));
+        return std::make_shared<Server>(ip_address,
+                                        ip_port,
+                                        real_num_io_threads,
+                                        std::move(executor_config),
+                                        connection_config);
     }
 
-    explicit Server(const std::string &address, const int port, const unsigned thread_pool_size)
-        : thread_pool_size(thread_pool_size), acceptor(io_service),
-          new_connection(std::make_shared<Connection>(io_service, request_handler))
+    explicit Server(const std::string &address,
+                    const int port,
+                    const unsigned thread_pool_size,
+                    RequestExecutorConfig executor_config,
+                    const ConnectionConfig &connection_config)
+        : thread_pool_size(thread_pool_size), connection_config(connection_config),
+          acceptor(io_service),
+          new_connection(std::make_shared<Connection>(
+              io_service, request_handler, request_executor, connection_config)),
+          request_executor(std::move(executor_config))
     {
         const auto port_string = std::to_string(port);
 
@@ -83,7 +103,11 @@ class Server
         }
     }
 
-    void Stop() { io_service.stop(); }
+    void Stop()
+    {
+        io_service.stop();
+        request_executor.Stop();
+    }
 
     void RegisterServiceHandler(std::unique_ptr<ServiceHandlerInterface> service_handler_)
     {
@@ -96,7 +120,8 @@ class Server
         if (!e)
         {
             new_connection->start();
-            new_connection = std::make_shared<Connection>(io_service, request_handler);
+            new_connection = std::make_shared<Connection>(
+                io_service, request_handler, request_executor, connection_config);
             acceptor.async_accept(
                 new_connection->socket(),
                 boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
@@ -104,10 +129,13 @@ class Server
     }
 
     unsigned thread_pool_size;
+    const ConnectionConfig connection_config;
     boost::asio::io_service io_service;
     boost::asio::ip::tcp::acceptor acceptor;
     std::shared_ptr<Connection> new_connection;
     RequestHandler request_handler;
+    // declared last so that running queries finish before the handler is destroyed
+    RequestExecutor request_executor;
 };
 }
 }
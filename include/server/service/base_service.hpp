@@ -17,10 +17,21 @@ namespace server
 namespace service
 {
 
+// A response that was written while running the query, e.g. streamed JSON or the binary format
+struct EncodedResult
+{
+    std::string content_type;
+    std::vector<char> content;
+};
+
+const constexpr char JSON_CONTENT_TYPE[] = "application/json; charset=UTF-8";
+const constexpr char BINARY_CONTENT_TYPE[] = "application/x-osrm-binary";
+
 class BaseService
 {
   public:
-    using ResultT = mapbox::util::variant<util::json::Object, std::string>;
+    // A JSON object, a protobuf vector tile or an already encoded response
+    using ResultT = mapbox::util::variant<util::json::Object, std::string, EncodedResult>;
 
     BaseService(OSRM &routing_machine) : routing_machine(routing_machine) {}
     virtual ~BaseService() = default;
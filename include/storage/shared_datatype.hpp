@@ -31,8 +31,12 @@ const constexpr char *block_id_to_name[] = {"NAME_CHAR_DATA",
                                             "ENTRY_CLASSID",
                                             "R_SEARCH_TREE",
                                             "R_SEARCH_TREE_LEVELS",
+                                            "R_SEARCH_TREE_PROJECTED_LEAVES",
                                             "GEOMETRIES_INDEX",
                                             "GEOMETRIES_NODE_LIST",
+                                            "GEOMETRIES_PACKED_FIRST_NODES",
+                                            "GEOMETRIES_PACKED_BLOCKS",
+                                            "GEOMETRIES_PACKED_WORDS",
                                             "GEOMETRIES_FWD_WEIGHT_LIST",
                                             "GEOMETRIES_REV_WEIGHT_LIST",
                                             "GEOMETRIES_FWD_DURATION_LIST",
@@ -68,7 +72,8 @@ const constexpr char *block_id_to_name[] = {"NAME_CHAR_DATA",
                                             "MLD_CELL_LEVEL_OFFSETS",
                                             "MLD_GRAPH_NODE_LIST",
                                             "MLD_GRAPH_EDGE_LIST",
-                                            "MLD_GRAPH_NODE_TO_OFFSET"};
+                                            "MLD_GRAPH_NODE_TO_OFFSET",
+                                            "STATIC_DATA_FINGERPRINT"};
 
 struct DataLayout
 {
@@ -87,8 +92,12 @@ struct DataLayout
         ENTRY_CLASSID,
         R_SEARCH_TREE,
         R_SEARCH_TREE_LEVELS,
+        R_SEARCH_TREE_PROJECTED_LEAVES,
         GEOMETRIES_INDEX,
         GEOMETRIES_NODE_LIST,
+        GEOMETRIES_PACKED_FIRST_NODES,
+        GEOMETRIES_PACKED_BLOCKS,
+        GEOMETRIES_PACKED_WORDS,
         GEOMETRIES_FWD_WEIGHT_LIST,
         GEOMETRIES_REV_WEIGHT_LIST,
         GEOMETRIES_FWD_DURATION_LIST,
@@ -125,6 +134,7 @@ struct DataLayout
         MLD_GRAPH_NODE_LIST,
         MLD_GRAPH_EDGE_LIST,
         MLD_GRAPH_NODE_TO_OFFSET,
+        STATIC_DATA_FINGERPRINT,
         NUM_BLOCKS
     };
 
@@ -144,6 +154,58 @@ struct DataLayout
 
     inline uint64_t GetBlockEntries(BlockID bid) const { return num_entries[bid]; }
 
+    // Blocks of the files osrm-customize and osrm-contract write when the weights change.
+    // osrm-datastore keeps them in a separate region to update them without the rest.
+    static bool IsMetricBlock(BlockID bid)
+    {
+        switch (bid)
+        {
+        case HSGR_CHECKSUM:
+        case CH_GRAPH_NODE_LIST:
+        case CH_GRAPH_EDGE_LIST:
+        case CH_CORE_MARKER:
+        case GEOMETRIES_INDEX:
+        case GEOMETRIES_NODE_LIST:
+        case GEOMETRIES_PACKED_FIRST_NODES:
+        case GEOMETRIES_PACKED_BLOCKS:
+        case GEOMETRIES_PACKED_WORDS:
+        case GEOMETRIES_FWD_WEIGHT_LIST:
+        case GEOMETRIES_REV_WEIGHT_LIST:
+        case GEOMETRIES_FWD_DURATION_LIST:
+        case GEOMETRIES_REV_DURATION_LIST:
+        case DATASOURCES_LIST:
+        case DATASOURCES_NAMES:
+        case TURN_WEIGHT_PENALTIES:
+        case TURN_DURATION_PENALTIES:
+        case MLD_CELL_WEIGHTS:
+        case MLD_CELL_DURATIONS:
+        case MLD_CELL_SOURCE_BOUNDARY:
+        case MLD_CELL_DESTINATION_BOUNDARY:
+        case MLD_CELLS:
+        case MLD_CELL_LEVEL_OFFSETS:
+        case MLD_GRAPH_NODE_LIST:
+        case MLD_GRAPH_EDGE_LIST:
+        case MLD_GRAPH_NODE_TO_OFFSET:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Copy of the layout with only the metric blocks or only the other blocks
+    DataLayout GetSegmentLayout(const bool metric) const
+    {
+        DataLayout segment_layout = *this;
+        for (auto i = 0; i < NUM_BLOCKS; i++)
+        {
+            if (IsMetricBlock(static_cast<BlockID>(i)) != metric)
+            {
+                segment_layout.num_entries[i] = 0;
+            }
+        }
+        return segment_layout;
+    }
+
     inline uint64_t GetBlockSize(BlockID bid) const
     {
         // special bit encoding
@@ -230,24 +292,32 @@ struct DataLayout
     }
 };
 
+// REGION_1 and REGION_2 alternately hold the static data, the metric blocks are stored in
+// METRIC_REGION_1 and METRIC_REGION_2.
 enum SharedDataType
 {
     REGION_NONE,
     REGION_1,
-    REGION_2
+    REGION_2,
+    METRIC_REGION_1,
+    METRIC_REGION_2
 };
 
 struct SharedDataTimestamp
 {
-    explicit SharedDataTimestamp(SharedDataType region, unsigned timestamp)
-        : region(region), timestamp(timestamp)
+    explicit SharedDataTimestamp(SharedDataType region,
+                                 SharedDataType metric_region,
+                                 unsigned timestamp)
+        : region(region), metric_region(metric_region), timestamp(timestamp)
     {
     }
 
     SharedDataType region;
+    SharedDataType metric_region;
     unsigned timestamp;
 
-    static constexpr const char *name = "osrm-region";
+    // Versioned since the metric region was added, older processes must not attach to it
+    static constexpr const char *name = "osrm-region-v2";
 };
 
 inline std::string regionToString(const SharedDataType region)
@@ -258,6 +328,10 @@ inline std::string regionToString(const SharedDataType region)
         return "REGION_1";
     case REGION_2:
         return "REGION_2";
+    case METRIC_REGION_1:
+        return "METRIC_REGION_1";
+    case METRIC_REGION_2:
+        return "METRIC_REGION_2";
     case REGION_NONE:
         return "REGION_NONE";
     default:
@@ -20,6 +20,7 @@
 #endif
 
 #include <cstdint>
+#include <cstring>
 
 #include <algorithm>
 #include <exception>
@@ -51,10 +52,13 @@ class SharedMemory
     SharedMemory(const SharedMemory &) = delete;
     SharedMemory &operator=(const SharedMemory &) = delete;
 
+    // With huge_pages set a new region is backed by huge pages if the system has enough of
+    // them reserved (see /proc/sys/vm/nr_hugepages), otherwise it falls back to normal pages.
     template <typename IdentifierT>
     SharedMemory(const boost::filesystem::path &lock_file,
                  const IdentifierT id,
-                 const uint64_t size = 0)
+                 const uint64_t size = 0,
+                 const bool huge_pages = false)
         : key(lock_file.string().c_str(), id)
     {
         // open only
@@ -69,6 +73,10 @@ class SharedMemory
         // open or create
         else
         {
+            if (huge_pages)
+            {
+                CreateWithHugePages(size);
+            }
             shm = boost::interprocess::xsi_shared_memory(
                 boost::interprocess::open_or_create, key, size);
             util::Log(logDEBUG) << "opening/creating " << shm.get_shmid() << " from id " << id
@@ -161,6 +169,30 @@ class SharedMemory
 #endif
 
   private:
+#ifdef __linux__
+    void CreateWithHugePages(const uint64_t size)
+    {
+        const uint64_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+        const auto rounded_size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        // the region is opened by boost afterwards, it only sees an existing region
+        const auto shmid = ::shmget(key.get_key(), rounded_size, IPC_CREAT | SHM_HUGETLB | 0644);
+        if (shmid == -1)
+        {
+            util::Log(logWARNING) << "could not allocate shared memory with huge pages ("
+                                  << std::strerror(errno) << "), using normal pages";
+        }
+        else
+        {
+            util::Log() << "allocated shared memory with huge pages";
+        }
+    }
+#else
+    void CreateWithHugePages(const uint64_t)
+    {
+        util::Log(logWARNING) << "huge pages are only supported on Linux, using normal pages";
+    }
+#endif
+
     static bool RegionExists(const boost::interprocess::xsi_key &key)
     {
         bool result = true;
@@ -201,9 +233,16 @@ class SharedMemory
   public:
     void *Ptr() const { return region.get_address(); }
 
-    SharedMemory(const boost::filesystem::path &lock_file, const int id, const uint64_t size = 0)
+    SharedMemory(const boost::filesystem::path &lock_file,
+                 const int id,
+                 const uint64_t size = 0,
+                 const bool huge_pages = false)
     {
         sprintf(key, "%s.%d", "osrm.lock", id);
+        if (huge_pages)
+        {
+            util::Log(logWARNING) << "huge pages are only supported on Linux, using normal pages";
+        }
         if (0 == size)
         { // read_only
             shm = boost::interprocess::shared_memory_object(
@@ -283,7 +322,8 @@ class SharedMemory
 #endif
 
 template <typename IdentifierT, typename LockFileT = OSRMLockFile>
-std::unique_ptr<SharedMemory> makeSharedMemory(const IdentifierT &id, const uint64_t size = 0)
+std::unique_ptr<SharedMemory>
+makeSharedMemory(const IdentifierT &id, const uint64_t size = 0, const bool huge_pages = false)
 {
     try
     {
@@ -299,7 +339,7 @@ std::unique_ptr<SharedMemory> makeSharedMemory(const IdentifierT &id, const uint
                 boost::filesystem::ofstream ofs(lock_file());
             }
         }
-        return std::make_unique<SharedMemory>(lock_file(), id, size);
+        return std::make_unique<SharedMemory>(lock_file(), id, size, huge_pages);
     }
     catch (const boost::interprocess::interprocess_exception &e)
     {
@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/filesystem/path.hpp>
 
+#include <cstdint>
 #include <string>
 
 namespace osrm
@@ -44,12 +45,27 @@ class Storage
   public:
     Storage(StorageConfig config);
 
-    int Run(int max_wait);
+    // With only_metric set the static data of the current region is kept and only the
+    // metric segment is reloaded, e.g. after osrm-customize or osrm-contract ran again.
+    // With huge_pages set the regions are allocated with huge pages if possible.
+    int Run(int max_wait, bool only_metric = false, bool huge_pages = false);
 
     void PopulateLayout(DataLayout &layout);
     void PopulateData(const DataLayout &layout, char *memory_ptr);
+    // Load only the blocks of one segment, see DataLayout::IsMetricBlock
+    void PopulateStaticData(const DataLayout &layout, char *memory_ptr);
+    void PopulateMetricData(const DataLayout &layout, char *memory_ptr);
+
+    // Hash of the paths, sizes and modification times of the files the static blocks are
+    // loaded from. A metric update only reuses static data with the same fingerprint.
+    std::uint64_t GetStaticDataFingerprint() const;
 
   private:
+    void PopulateData(const DataLayout &layout,
+                      char *memory_ptr,
+                      const bool load_static,
+                      const bool load_metric);
+
     StorageConfig config;
 };
 }
@@ -73,6 +73,10 @@ struct StorageConfig final
     boost::filesystem::path mld_partition_path;
     boost::filesystem::path mld_storage_path;
     boost::filesystem::path mld_graph_path;
+    boost::filesystem::path memory_image_path;
+
+    // Stores the geometry node lists delta encoded and bit-packed, see PackedGeometryEncoder
+    bool compress_geometry = false;
 };
 }
 }
@@ -0,0 +1,25 @@
+#ifndef OSRM_STORAGE_WARM_UP_HPP
+#define OSRM_STORAGE_WARM_UP_HPP
+
+#include "storage/shared_datatype.hpp"
+
+#include <cstdint>
+
+namespace osrm
+{
+namespace storage
+{
+
+/**
+ * Touches every page of the data blocks so that the page tables of the calling process are
+ * populated before the first query arrives.
+ *
+ * The blocks are visited in the order a typical query accesses them: snapping (R-tree and
+ * coordinates), the search graphs, path unpacking and finally guidance and names.
+ * Returns the number of bytes that were touched.
+ */
+std::uint64_t warmUp(const DataLayout &layout, const char *memory);
+}
+}
+
+#endif
@@ -24,6 +24,12 @@ class Updater
     LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list,
                                    std::vector<EdgeWeight> &node_weights) const;
 
+    // Also returns the edge-based nodes whose outgoing edges got new weights
+    EdgeID
+    LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                                   std::vector<EdgeWeight> &node_weights,
+                                   std::vector<NodeID> &updated_nodes) const;
+
   private:
     UpdaterConfig config;
 };
@@ -0,0 +1,67 @@
+#ifndef BINARY_WRITER_HPP
+#define BINARY_WRITER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace binary
+{
+
+/// Appends fixed-size little-endian values to a character buffer.
+///
+/// The byte order does not depend on the host, so responses can be read on any platform
+/// by copying the arrays (or mapping them directly on little-endian machines).
+class Writer
+{
+  public:
+    explicit Writer(std::vector<char> &out_) : out(out_) {}
+
+    void UInt32(const std::uint32_t value)
+    {
+        const char bytes[] = {static_cast<char>(value & 0xff),
+                              static_cast<char>((value >> 8) & 0xff),
+                              static_cast<char>((value >> 16) & 0xff),
+                              static_cast<char>((value >> 24) & 0xff)};
+        out.insert(out.end(), bytes, bytes + sizeof(bytes));
+    }
+
+    void Int32(const std::int32_t value) { UInt32(static_cast<std::uint32_t>(value)); }
+
+    void Float(const float value)
+    {
+        static_assert(sizeof(float) == sizeof(std::uint32_t), "IEEE 754 single precision required");
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        UInt32(bits);
+    }
+
+    // Length prefixed, not null terminated
+    void String(const std::string &value)
+    {
+        UInt32(static_cast<std::uint32_t>(value.size()));
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    void Bytes(const char *data, const std::size_t size)
+    {
+        out.insert(out.end(), data, data + size);
+    }
+
+    std::size_t Size() const { return out.size(); }
+    const char *Data() const { return out.data(); }
+
+  private:
+    std::vector<char> &out;
+};
+
+} // namespace binary
+} // namespace util
+} // namespace osrm
+
+#endif // BINARY_WRITER_HPP
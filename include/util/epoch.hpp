@@ -0,0 +1,143 @@
+#ifndef OSRM_UTIL_EPOCH_HPP
+#define OSRM_UTIL_EPOCH_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Epoch based reclamation of objects that are read by many threads and replaced by one.
+ *
+ * Every reading thread owns a counter on its own cache line. While it reads, the counter holds
+ * the global epoch it started in, and 0 otherwise. A writer replaces the object, advances the
+ * global epoch and waits until no thread is still reading in an older epoch before it deletes
+ * the old object. Readers never write to memory shared with other threads, unlike the
+ * reference count of a std::shared_ptr.
+ */
+namespace epoch
+{
+namespace detail
+{
+// Padded to a cache line, so the counters of two threads never share one
+struct ThreadEpoch
+{
+    std::atomic<std::uint64_t> epoch{0};
+    char padding[64 - sizeof(std::atomic<std::uint64_t>)];
+};
+
+extern std::atomic<std::uint64_t> global_epoch;
+extern thread_local ThreadEpoch *local_epoch;
+
+ThreadEpoch &registerThread();
+
+// The counter of the calling thread, registered on first use
+inline ThreadEpoch &localEpoch() { return local_epoch ? *local_epoch : registerThread(); }
+}
+
+// Waits until all threads that were reading when it was called finished reading
+void synchronize();
+
+// Marks the calling thread as reading until destruction. Guards nested in a guard of the same
+// thread do nothing, the outermost guard counts.
+class ReadGuard
+{
+  public:
+    ReadGuard() : thread_epoch(&detail::localEpoch())
+    {
+        if (thread_epoch->epoch.load(std::memory_order_relaxed) != 0)
+        {
+            thread_epoch = nullptr;
+            return;
+        }
+        // The store has to be visible before the protected pointer is read, see synchronize()
+        thread_epoch->epoch.store(detail::global_epoch.load(std::memory_order_relaxed),
+                                  std::memory_order_seq_cst);
+    }
+
+    ~ReadGuard()
+    {
+        if (thread_epoch)
+            thread_epoch->epoch.store(0, std::memory_order_release);
+    }
+
+    ReadGuard(ReadGuard &&other) noexcept : thread_epoch(other.thread_epoch)
+    {
+        other.thread_epoch = nullptr;
+    }
+    ReadGuard(const ReadGuard &) = delete;
+    ReadGuard &operator=(const ReadGuard &) = delete;
+    ReadGuard &operator=(ReadGuard &&) = delete;
+
+    // A guard that does not mark the thread, for objects that are never replaced
+    static ReadGuard Unguarded() { return ReadGuard(nullptr); }
+
+  private:
+    explicit ReadGuard(detail::ThreadEpoch *thread_epoch) : thread_epoch(thread_epoch) {}
+
+    detail::ThreadEpoch *thread_epoch;
+};
+}
+
+/// Keeps a pointer into an object that is protected by an epoch::ReadGuard, or to an object
+/// that is never replaced if it has no guard. Must not leave the thread that created it.
+template <typename T> class EpochHandle
+{
+  public:
+    explicit EpochHandle(T *pointer) : pointer(pointer), guard(epoch::ReadGuard::Unguarded())
+    {
+    }
+    EpochHandle(T *pointer, epoch::ReadGuard guard) : pointer(pointer), guard(std::move(guard)) {}
+
+    T &operator*() const { return *pointer; }
+    T *operator->() const { return pointer; }
+    T *get() const { return pointer; }
+
+  private:
+    T *pointer;
+    epoch::ReadGuard guard;
+};
+
+/// Owns an object that many threads read and a single thread replaces.
+/// Reading costs a store to a thread local cache line and two loads.
+template <typename T> class EpochPointer
+{
+  public:
+    EpochPointer() : current(nullptr) {}
+    explicit EpochPointer(std::unique_ptr<T> value) : current(value.release()) {}
+    ~EpochPointer() { delete current.load(); }
+
+    EpochPointer(const EpochPointer &) = delete;
+    EpochPointer &operator=(const EpochPointer &) = delete;
+
+    /// The caller has to hold a ReadGuard as long as it uses the returned pointer
+    T *Load() const { return current.load(std::memory_order_seq_cst); }
+
+    EpochHandle<T> Acquire() const
+    {
+        // the thread has to be marked before the pointer is read
+        epoch::ReadGuard guard;
+        const auto pointer = Load();
+        return EpochHandle<T>(pointer, std::move(guard));
+    }
+
+    /// Replaces the object and deletes the previous one once no thread reads it anymore.
+    /// Blocks until then, so it must not be called while holding a ReadGuard.
+    void Update(std::unique_ptr<T> value)
+    {
+        std::unique_ptr<T> previous(current.exchange(value.release(), std::memory_order_seq_cst));
+        epoch::synchronize();
+    }
+
+  private:
+    std::atomic<T *> current;
+};
+}
+}
+
+#endif
@@ -5,6 +5,7 @@
 #define JSON_RENDERER_HPP
 
 #include "util/cast.hpp"
+#include "util/json_writer.hpp"
 #include "util/string_util.hpp"
 
 #include "osrm/json_container.hpp"
@@ -77,73 +78,15 @@ struct Renderer
     std::ostream &out;
 };
 
+// Renders into a character buffer, see json::Writer
 struct ArrayRenderer
 {
     explicit ArrayRenderer(std::vector<char> &_out) : out(_out) {}
 
-    void operator()(const String &string) const
-    {
-        out.push_back('\"');
-        const auto string_to_insert = escape_JSON(string.value);
-        out.insert(std::end(out), std::begin(string_to_insert), std::end(string_to_insert));
-        out.push_back('\"');
-    }
-
-    void operator()(const Number &number) const
-    {
-        const std::string number_string = cast::to_string_with_precision(number.value);
-        out.insert(out.end(), number_string.begin(), number_string.end());
-    }
-
-    void operator()(const Object &object) const
-    {
-        out.push_back('{');
-        for (auto it = object.values.begin(), end = object.values.end(); it != end;)
-        {
-            out.push_back('\"');
-            out.insert(out.end(), it->first.begin(), it->first.end());
-            out.push_back('\"');
-            out.push_back(':');
-
-            mapbox::util::apply_visitor(ArrayRenderer(out), it->second);
-            if (++it != end)
-            {
-                out.push_back(',');
-            }
-        }
-        out.push_back('}');
-    }
-
-    void operator()(const Array &array) const
-    {
-        out.push_back('[');
-        for (auto it = array.values.cbegin(), end = array.values.cend(); it != end;)
-        {
-            mapbox::util::apply_visitor(ArrayRenderer(out), *it);
-            if (++it != end)
-            {
-                out.push_back(',');
-            }
-        }
-        out.push_back(']');
-    }
-
-    void operator()(const True &) const
-    {
-        const std::string temp("true");
-        out.insert(out.end(), temp.begin(), temp.end());
-    }
-
-    void operator()(const False &) const
+    template <typename T> void operator()(const T &value) const
     {
-        const std::string temp("false");
-        out.insert(out.end(), temp.begin(), temp.end());
-    }
-
-    void operator()(const Null &) const
-    {
-        const std::string temp("null");
-        out.insert(out.end(), temp.begin(), temp.end());
+        Writer writer(out);
+        writer.Value(value);
     }
 
   private:
@@ -158,8 +101,8 @@ inline void render(std::ostream &out, const Object &object)
 
 inline void render(std::vector<char> &out, const Object &object)
 {
-    Value value = object;
-    mapbox::util::apply_visitor(ArrayRenderer(out), value);
+    Writer writer(out);
+    writer.Value(object);
 }
 
 } // namespace json
@@ -0,0 +1,263 @@
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+
+#include "util/cast.hpp"
+
+#include "osrm/json_container.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace json
+{
+
+/// Streaming JSON writer appending directly to a character buffer.
+///
+/// Responses can be written value by value without building a tree of json::Value
+/// nodes first. Separators between values are inserted automatically:
+///
+///   Writer writer(buffer);
+///   writer.StartObject();
+///   writer.Key("code");
+///   writer.String("Ok");
+///   writer.EndObject();
+///
+/// Apart from growing the buffer no memory is allocated. Numbers are formatted exactly
+/// like the tree renderer does: fixed with six digits, with trailing zeros removed.
+class Writer
+{
+  public:
+    explicit Writer(std::vector<char> &out_) : out(out_), needs_separator(false) {}
+
+    void StartObject()
+    {
+        Separate();
+        out.push_back('{');
+        needs_separator = false;
+    }
+
+    void EndObject()
+    {
+        out.push_back('}');
+        needs_separator = true;
+    }
+
+    void StartArray()
+    {
+        Separate();
+        out.push_back('[');
+        needs_separator = false;
+    }
+
+    void EndArray()
+    {
+        out.push_back(']');
+        needs_separator = true;
+    }
+
+    // Keys are written verbatim, they are never user supplied
+    void Key(const char *key) { Key(key, std::strlen(key)); }
+    void Key(const std::string &key) { Key(key.data(), key.size()); }
+
+    void String(const char *string) { String(string, std::strlen(string)); }
+    void String(const std::string &string) { String(string.data(), string.size()); }
+
+    void Number(const double value)
+    {
+        Separate();
+        // integral values are the common case (durations, distances, indices) and skip printf
+        if (std::abs(value) < 1e15 && value == std::trunc(value) &&
+            !(value == 0 && std::signbit(value)))
+        {
+            Integer(static_cast<std::int64_t>(value));
+        }
+        else if (std::abs(value) < 1e15)
+        {
+            char buffer[32];
+            const auto length = std::snprintf(buffer, sizeof(buffer), "%.6f", value);
+            Append(buffer, TrimmedLength(buffer, length));
+        }
+        else
+        {
+            // huge numbers, infinity and NaN are rare enough to go through the slow path
+            const auto number = cast::to_string_with_precision(value);
+            Append(number.data(), number.size());
+        }
+        needs_separator = true;
+    }
+
+    void Bool(const bool value) { Literal(value ? "true" : "false"); }
+
+    void Null() { Literal("null"); }
+
+    /// Writes a json::Value tree, e.g. for small parts of a response
+    void Value(const json::Value &value) { mapbox::util::apply_visitor(ValueWriter{*this}, value); }
+    template <typename T> void Value(const T &value) { ValueWriter{*this}(value); }
+
+    /// Writes a complete value that was already serialized, e.g. by another writer
+    void Raw(const char *value, const std::size_t size)
+    {
+        Separate();
+        Append(value, size);
+        needs_separator = true;
+    }
+
+    std::size_t Size() const { return out.size(); }
+    const char *Data() const { return out.data(); }
+
+  private:
+    struct ValueWriter
+    {
+        void operator()(const json::String &string) const { writer.String(string.value); }
+        void operator()(const json::Number &number) const { writer.Number(number.value); }
+        void operator()(const json::Object &object) const
+        {
+            writer.StartObject();
+            for (const auto &entry : object.values)
+            {
+                writer.Key(entry.first);
+                mapbox::util::apply_visitor(*this, entry.second);
+            }
+            writer.EndObject();
+        }
+        void operator()(const json::Array &array) const
+        {
+            writer.StartArray();
+            for (const auto &value : array.values)
+            {
+                mapbox::util::apply_visitor(*this, value);
+            }
+            writer.EndArray();
+        }
+        void operator()(const json::True &) const { writer.Bool(true); }
+        void operator()(const json::False &) const { writer.Bool(false); }
+        void operator()(const json::Null &) const { writer.Null(); }
+
+        Writer &writer;
+    };
+
+    void Separate()
+    {
+        if (needs_separator)
+        {
+            out.push_back(',');
+        }
+    }
+
+    void Key(const char *key, const std::size_t length)
+    {
+        Separate();
+        out.push_back('"');
+        Append(key, length);
+        out.push_back('"');
+        out.push_back(':');
+        needs_separator = false;
+    }
+
+    void String(const char *string, const std::size_t length)
+    {
+        Separate();
+        out.push_back('"');
+        for (const char *letter = string; letter != string + length; ++letter)
+        {
+            switch (*letter)
+            {
+            case '\\':
+                Append("\\\\", 2);
+                break;
+            case '"':
+                Append("\\\"", 2);
+                break;
+            case '/':
+                Append("\\/", 2);
+                break;
+            case '\b':
+                Append("\\b", 2);
+                break;
+            case '\f':
+                Append("\\f", 2);
+                break;
+            case '\n':
+                Append("\\n", 2);
+                break;
+            case '\r':
+                Append("\\r", 2);
+                break;
+            case '\t':
+                Append("\\t", 2);
+                break;
+            default:
+                out.push_back(*letter);
+                break;
+            }
+        }
+        out.push_back('"');
+        needs_separator = true;
+    }
+
+    void Integer(std::int64_t value)
+    {
+        char buffer[24];
+        char *begin = buffer + sizeof(buffer);
+        const bool negative = value < 0;
+        std::uint64_t magnitude =
+            negative ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+        do
+        {
+            *--begin = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (negative)
+        {
+            *--begin = '-';
+        }
+        Append(begin, buffer + sizeof(buffer) - begin);
+    }
+
+    void Literal(const char *literal)
+    {
+        Separate();
+        Append(literal, std::strlen(literal));
+        needs_separator = true;
+    }
+
+    void Append(const char *data, const std::size_t length)
+    {
+        out.insert(out.end(), data, data + length);
+    }
+
+    // X.Y000 -> X.Y and X.000 -> X, see cast::to_string_with_precision
+    static std::size_t TrimmedLength(const char *number, int length)
+    {
+        if (std::memchr(number, '.', length) == nullptr)
+        {
+            return length;
+        }
+        while (length > 0 && number[length - 1] == '0')
+        {
+            --length;
+        }
+        while (length > 0 && number[length - 1] == '.')
+        {
+            --length;
+        }
+        return length;
+    }
+
+    std::vector<char> &out;
+    bool needs_separator;
+};
+
+} // namespace json
+} // namespace util
+} // namespace osrm
+
+#endif // JSON_WRITER_HPP
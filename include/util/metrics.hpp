@@ -0,0 +1,187 @@
+#ifndef OSRM_UTIL_METRICS_HPP
+#define OSRM_UTIL_METRICS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace osrm
+{
+namespace util
+{
+namespace metrics
+{
+
+/**
+ * Latency and search space instrumentation of the engine.
+ *
+ * A RequestScope marks the time a thread spends on a request of an endpoint. Nested
+ * StageScopes attribute parts of it to the stages of the request, every stage only counts
+ * the time not spent in nested stages. Measurements are accumulated in histograms owned by
+ * the recording thread, so recording never takes a lock. collect() merges the histograms
+ * of all threads, e.g. for the /metrics endpoint of osrm-routed.
+ */
+
+enum class Endpoint : std::uint8_t
+{
+    Route,
+    Table,
+    Nearest,
+    Trip,
+    Match,
+    Tile,
+    Other
+};
+const constexpr std::size_t NUMBER_OF_ENDPOINTS = 7;
+
+enum class Stage : std::uint8_t
+{
+    Snapping,
+    Search,
+    Unpacking,
+    Guidance,
+    Rendering
+};
+const constexpr std::size_t NUMBER_OF_STAGES = 5;
+
+const char *name(const Endpoint endpoint);
+const char *name(const Stage stage);
+
+// Maps the service name of a request URL to its endpoint
+Endpoint endpointFromService(const std::string &service);
+
+/**
+ * Histogram with logarithmic buckets that are split into four linear sub-buckets.
+ *
+ * Like a HDR histogram this bounds the relative error of every recorded value by 25% over
+ * the whole value range with only a small, fixed number of buckets.
+ */
+class Histogram
+{
+  public:
+    // The last bucket also holds all values from 2^41 onwards
+    static const constexpr std::size_t NUMBER_OF_BUCKETS = 160;
+    using Buckets = std::array<std::uint64_t, NUMBER_OF_BUCKETS>;
+
+    Histogram() : buckets{}, count(0), sum(0) {}
+    Histogram(const Buckets &buckets, const std::uint64_t sum);
+
+    static std::size_t BucketIndex(const std::uint64_t value);
+    // The smallest value that is not part of the bucket anymore
+    static std::uint64_t BucketUpperBound(const std::size_t index);
+
+    void Record(const std::uint64_t value)
+    {
+        buckets[BucketIndex(value)]++;
+        count++;
+        sum += value;
+    }
+
+    void Merge(const Histogram &other);
+
+    std::uint64_t Bucket(const std::size_t index) const { return buckets[index]; }
+    std::uint64_t Count() const { return count; }
+    std::uint64_t Sum() const { return sum; }
+
+    // Upper bound of the bucket that contains the given quantile, 0 if nothing was recorded
+    std::uint64_t Quantile(const double quantile) const;
+
+  private:
+    Buckets buckets;
+    std::uint64_t count;
+    std::uint64_t sum;
+};
+
+// Merged measurements of all threads, durations are in microseconds
+struct Snapshot
+{
+    std::array<Histogram, NUMBER_OF_ENDPOINTS> request_duration;
+    std::array<std::array<Histogram, NUMBER_OF_STAGES>, NUMBER_OF_ENDPOINTS> stage_duration;
+    std::array<Histogram, NUMBER_OF_ENDPOINTS> settled_nodes;
+    std::array<std::uint64_t, NUMBER_OF_ENDPOINTS> cache_hits{};
+    std::array<std::uint64_t, NUMBER_OF_ENDPOINTS> cache_misses{};
+    std::array<Histogram, NUMBER_OF_ENDPOINTS> queue_wait;
+    std::array<std::uint64_t, NUMBER_OF_ENDPOINTS> rejected_requests{};
+    std::array<std::uint64_t, NUMBER_OF_ENDPOINTS> queue_size{};
+};
+
+Snapshot collect();
+
+// Prometheus text exposition format (version 0.0.4)
+std::string renderPrometheus(const Snapshot &snapshot);
+
+/// Measures a request from construction to destruction. Scopes nested in an active
+/// request scope of the same thread are ignored, the outermost scope counts.
+class RequestScope
+{
+  public:
+    explicit RequestScope(const Endpoint endpoint);
+    ~RequestScope();
+
+    RequestScope(const RequestScope &) = delete;
+    RequestScope &operator=(const RequestScope &) = delete;
+
+  private:
+    bool outermost;
+    Endpoint endpoint;
+    std::chrono::steady_clock::time_point start;
+    std::uint64_t settled_nodes_start;
+};
+
+/// Attributes the time until destruction to a stage of the current request.
+/// Without an active request scope nothing is recorded.
+class StageScope
+{
+  public:
+    explicit StageScope(const Stage stage);
+    ~StageScope();
+
+    StageScope(const StageScope &) = delete;
+    StageScope &operator=(const StageScope &) = delete;
+
+  private:
+    bool active;
+    Stage stage;
+    StageScope *parent;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration nested;
+};
+
+// Lookups of the result cache, counted for the endpoint of the current request scope
+void countCacheHit();
+void countCacheMiss();
+
+// Request queue of the server: the time requests waited for a compute thread, the requests
+// rejected because the queue was full and the number of requests waiting right now
+void recordQueueWait(const Endpoint endpoint, const std::uint64_t microseconds);
+void countRejectedRequest(const Endpoint endpoint);
+void addQueuedRequests(const Endpoint endpoint, const std::int64_t count);
+
+namespace detail
+{
+extern thread_local std::uint64_t settled_nodes;
+}
+
+// Called for every node a search removes from its heap, this needs to be cheap
+inline void countSettledNode() { ++detail::settled_nodes; }
+
+inline void addSettledNodes(const std::uint64_t count) { detail::settled_nodes += count; }
+
+// Runs a part of a search on a worker thread and returns the nodes it settled, so they can
+// be added to the thread running the request.
+template <typename Fn> std::uint64_t takeSettledNodes(Fn &&fn)
+{
+    const auto settled_before = detail::settled_nodes;
+    std::forward<Fn>(fn)();
+    const auto settled = detail::settled_nodes - settled_before;
+    detail::settled_nodes = settled_before;
+    return settled;
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef OSRM_UTIL_NUMA_HPP
+#define OSRM_UTIL_NUMA_HPP
+
+#include <cstddef>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Minimal NUMA support on top of the Linux system calls, so no libnuma is needed.
+ * On other platforms every machine is treated as a single node.
+ */
+namespace numa
+{
+
+// Number of NUMA nodes with CPUs, at least 1
+unsigned getNodeCount();
+
+// The node of the CPU the calling thread runs on. Pinned threads return their node without a
+// system call.
+unsigned getCurrentNode();
+
+// Restricts the calling thread to the CPUs of node. Returns false if that is not possible.
+bool pinThreadToNode(const unsigned node);
+
+// Places the pages of memory on node when they are first touched. memory has to be page
+// aligned. Returns false if that is not possible.
+bool bindMemoryToNode(void *memory, const std::size_t size, const unsigned node);
+}
+}
+}
+
+#endif
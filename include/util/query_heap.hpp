@@ -3,11 +3,14 @@
 
 #include <boost/assert.hpp>
 #include <boost/heap/d_ary_heap.hpp>
+#include <boost/optional.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <map>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace osrm
@@ -21,13 +24,19 @@ template <typename NodeID, typename Key> class GenerationArrayStorage
 
   public:
     explicit GenerationArrayStorage(std::size_t size)
-        : positions(size, 0), generation(1), generations(size, 0)
+        : generation(1), generations(size, 0), positions(size, 0)
     {
     }
 
+    // Memory needed by the index for a graph with the given number of nodes
+    static std::size_t RequiredMemory(std::size_t size)
+    {
+        return size * (sizeof(GenerationCounter) + sizeof(Key));
+    }
+
     Key &operator[](NodeID node)
     {
-        generation[node] = generation;
+        generations[node] = generation;
         return positions[node];
     }
 
@@ -126,6 +135,45 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
     std::unordered_map<NodeID, Key> nodes;
 };
 
+// Uses a GenerationArrayStorage if the index for all nodes fits into the memory budget
+// and falls back to an UnorderedMapStorage otherwise. The choice is made once on construction,
+// so huge graphs do not allocate a full per-node index for every thread-local heap and heaps
+// using the array do not allocate a hash table.
+template <typename NodeID, typename Key> class AdaptiveStorage
+{
+  public:
+    explicit AdaptiveStorage(
+        std::size_t size,
+        std::size_t max_array_memory = std::numeric_limits<std::size_t>::max())
+    {
+        if (GenerationArrayStorage<NodeID, Key>::RequiredMemory(size) <= max_array_memory)
+            array = GenerationArrayStorage<NodeID, Key>(size);
+        else
+            map = UnorderedMapStorage<NodeID, Key>(size);
+    }
+
+    bool UsesArray() const { return static_cast<bool>(array); }
+
+    Key &operator[](const NodeID node) { return array ? (*array)[node] : (*map)[node]; }
+
+    Key peek_index(const NodeID node) const
+    {
+        return array ? array->peek_index(node) : map->peek_index(node);
+    }
+
+    void Clear()
+    {
+        if (array)
+            array->Clear();
+        else
+            map->Clear();
+    }
+
+  private:
+    boost::optional<GenerationArrayStorage<NodeID, Key>> array;
+    boost::optional<UnorderedMapStorage<NodeID, Key>> map;
+};
+
 template <typename NodeID,
           typename Key,
           typename Weight,
@@ -137,7 +185,15 @@ class QueryHeap
     using WeightType = Weight;
     using DataType = Data;
 
-    explicit QueryHeap(std::size_t maxID) : node_index(maxID) { Clear(); }
+    template <typename... StorageArgs>
+    explicit QueryHeap(std::size_t maxID, StorageArgs &&... storage_args)
+        : capacity(maxID), node_index(maxID, std::forward<StorageArgs>(storage_args)...)
+    {
+        Clear();
+    }
+
+    // Number of node IDs the heap was created for
+    std::size_t Capacity() const { return capacity; }
 
     void Clear()
     {
@@ -247,6 +303,7 @@ class QueryHeap
         Data data;
     };
 
+    std::size_t capacity;
     std::vector<HeapNode> inserted_nodes;
     HeapContainer heap;
     IndexStorage node_index;
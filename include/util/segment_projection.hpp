@@ -0,0 +1,58 @@
+#ifndef OSRM_UTIL_SEGMENT_PROJECTION_HPP
+#define OSRM_UTIL_SEGMENT_PROJECTION_HPP
+
+#include "util/coordinate.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Projects a coordinate onto many segments at once, like
+ * coordinate_calculation::projectPointOnSegment does for one segment.
+ *
+ * The endpoints u and v of the segments are given as structure of arrays in fixed point, so the
+ * segments can be processed with SIMD instructions. The nearest points on the segments are
+ * rounded to fixed point. AVX2 or SSE2 is used if the CPU supports it, this is detected once at
+ * runtime.
+ */
+void projectPointOnSegments(const std::int32_t *u_lon,
+                            const std::int32_t *u_lat,
+                            const std::int32_t *v_lon,
+                            const std::int32_t *v_lat,
+                            const std::size_t number_of_segments,
+                            const Coordinate coordinate,
+                            std::int32_t *nearest_lon,
+                            std::int32_t *nearest_lat);
+
+namespace detail
+{
+enum class ProjectionKernel
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// The best kernel the CPU supports
+ProjectionKernel getProjectionKernel();
+
+// Runs a specific kernel, the CPU has to support it
+void projectPointOnSegments(const ProjectionKernel kernel,
+                            const std::int32_t *u_lon,
+                            const std::int32_t *u_lat,
+                            const std::int32_t *v_lon,
+                            const std::int32_t *v_lat,
+                            const std::size_t number_of_segments,
+                            const Coordinate coordinate,
+                            std::int32_t *nearest_lon,
+                            std::int32_t *nearest_lat);
+}
+}
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include "util/integer_range.hpp"
 #include "util/mmap_file.hpp"
 #include "util/rectangle.hpp"
+#include "util/segment_projection.hpp"
 #include "util/typedefs.hpp"
 #include "util/vector_view.hpp"
 #include "util/web_mercator.hpp"
@@ -21,16 +22,17 @@
 #include <boost/assert.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
+#include <boost/heap/d_ary_heap.hpp>
 #include <boost/iostreams/device/mapped_file.hpp>
 
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
 
 #include <algorithm>
 #include <array>
 #include <limits>
 #include <memory>
-#include <queue>
 #include <string>
 #include <vector>
 
@@ -172,6 +174,59 @@ class StaticRTree
         Rectangle minimum_bounding_rectangle;
     };
 
+    /**
+     * The endpoints of the segments of a leaf, projected to Web Mercator in fixed point like the
+     * bounding rectangles. They are stored as structure of arrays so a leaf can be explored with
+     * util::projectPointOnSegments instead of projecting every segment on every query.
+     * The entries after the last segment of the last leaf are unused.
+     */
+    struct ProjectedLeaf
+    {
+        std::array<std::int32_t, LEAF_NODE_SIZE> u_lon;
+        std::array<std::int32_t, LEAF_NODE_SIZE> u_lat;
+        std::array<std::int32_t, LEAF_NODE_SIZE> v_lon;
+        std::array<std::int32_t, LEAF_NODE_SIZE> v_lat;
+    };
+
+    static std::size_t GetNumberOfLeaves(const std::size_t number_of_objects)
+    {
+        return (number_of_objects + LEAF_NODE_SIZE - 1) / LEAF_NODE_SIZE;
+    }
+
+    /**
+     * Projects the segments of all leaves of the .fileIndex objects. projected_leaves needs room
+     * for GetNumberOfLeaves(objects.size()) leaves.
+     */
+    template <typename CoordinateListT>
+    static void ProjectLeaves(const util::vector_view<const EdgeDataT> &objects,
+                              const CoordinateListT &coordinate_list,
+                              ProjectedLeaf *projected_leaves)
+    {
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, GetNumberOfLeaves(objects.size())),
+            [&](const tbb::blocked_range<std::size_t> &range) {
+                for (auto leaf = range.begin(); leaf != range.end(); ++leaf)
+                {
+                    auto &projected_leaf = projected_leaves[leaf];
+                    const auto first_object = leaf * LEAF_NODE_SIZE;
+                    const auto end_object =
+                        std::min<std::size_t>(first_object + LEAF_NODE_SIZE, objects.size());
+                    for (auto i = first_object; i < end_object; ++i)
+                    {
+                        const Coordinate projected_u{
+                            web_mercator::fromWGS84(coordinate_list[objects[i].u])};
+                        const Coordinate projected_v{
+                            web_mercator::fromWGS84(coordinate_list[objects[i].v])};
+                        const auto position = i - first_object;
+                        projected_leaf.u_lon[position] = static_cast<std::int32_t>(projected_u.lon);
+                        projected_leaf.u_lat[position] = static_cast<std::int32_t>(projected_u.lat);
+                        projected_leaf.v_lon[position] = static_cast<std::int32_t>(projected_v.lon);
+                        projected_leaf.v_lat[position] = static_cast<std::int32_t>(projected_v.lat);
+                    }
+                }
+            });
+    }
+
   private:
     /**
      * A lightweight wrapper for the Hilbert Code for each EdgeDataT object
@@ -224,7 +279,7 @@ class StaticRTree
 
         inline bool operator<(const QueryCandidate &other) const
         {
-            // Attn: this is reversed order. std::priority_queue is a
+            // Attn: this is reversed order. boost::heap::d_ary_heap is a
             // max pq (biggest item at the front)!
             return other.squared_min_dist < squared_min_dist;
         }
@@ -235,6 +290,37 @@ class StaticRTree
         std::uint32_t segment_index;
     };
 
+    // Queries of a batch that run on the same thread one after another
+    static constexpr std::size_t BATCH_GRAIN_SIZE = 64;
+
+  public:
+    /**
+     * The buffers of a search. They keep their capacity from one search to the next, so
+     * searches that reuse a context stop allocating once it grew to the size of a typical
+     * search. The results a search returns are valid until the next search with its context.
+     */
+    class TraversalContext
+    {
+        friend class StaticRTree;
+
+        boost::heap::d_ary_heap<QueryCandidate, boost::heap::arity<4>> traversal_queue;
+        // breadth first queue of SearchInBox
+        std::vector<TreeIndex> box_queue;
+        // max-heap of the distances of the nearest accepted segments of NearestK
+        std::vector<std::uint64_t> nearest_distances;
+        std::vector<EdgeDataT> results;
+    };
+
+    // The context of the calling thread, used by the searches without a context argument.
+    // Filters and terminators must not search a tree of this type on the same thread.
+    static TraversalContext &GetThreadContext()
+    {
+        static thread_local TraversalContext context;
+        return context;
+    }
+
+  private:
+
     // We use a const view type when we don't own the data, otherwise
     // we use a mutable type (usually becase we're building the tree)
     using TreeViewType = typename std::conditional<Ownership == storage::Ownership::View,
@@ -258,6 +344,12 @@ class StaticRTree
     // This is a view of the EdgeDataT data mmap'd from the .fileIndex file
     util::vector_view<const EdgeDataT> m_objects;
 
+    // One entry per leaf, in the order of the leaves in m_objects
+    using ProjectedLeavesType = typename std::conditional<Ownership == storage::Ownership::View,
+                                                          const Vector<const ProjectedLeaf>,
+                                                          Vector<ProjectedLeaf>>::type;
+    ProjectedLeavesType m_projected_leaves;
+
   public:
     StaticRTree(const StaticRTree &) = delete;
     StaticRTree &operator=(const StaticRTree &) = delete;
@@ -459,6 +551,9 @@ class StaticRTree
         }
 
         m_objects = mmapFile<EdgeDataT>(leaf_node_filename, m_objects_region);
+
+        m_projected_leaves.resize(GetNumberOfLeaves(m_objects.size()));
+        ProjectLeaves(m_objects, m_coordinate_list, m_projected_leaves.data());
     }
 
     /**
@@ -489,22 +584,28 @@ class StaticRTree
                          std::back_inserter(m_tree_level_starts));
 
         m_objects = mmapFile<EdgeDataT>(leaf_file, m_objects_region);
+
+        m_projected_leaves.resize(GetNumberOfLeaves(m_objects.size()));
+        ProjectLeaves(m_objects, m_coordinate_list, m_projected_leaves.data());
     }
 
     /**
      * Constructs an r-tree from blocks of memory loaded by someone else
      * (usually a shared memory block created by osrm-datastore)
      * These memory blocks basically just contain the files read into RAM,
-     * excep the .fileIndex file always stays on disk, and we mmap() it as usual
+     * excep the .fileIndex file always stays on disk, and we mmap() it as usual.
+     * The projected leaves are computed by the loader with ProjectLeaves.
      */
     explicit StaticRTree(const TreeNode *tree_node_ptr,
                          const uint64_t number_of_nodes,
                          const std::uint64_t *level_sizes_ptr,
                          const std::size_t number_of_levels,
+                         const ProjectedLeaf *projected_leaves_ptr,
                          const boost::filesystem::path &leaf_file,
                          const Vector<Coordinate> &coordinate_list)
         : m_search_tree(tree_node_ptr, number_of_nodes), m_coordinate_list(coordinate_list),
-          m_tree_level_sizes(level_sizes_ptr, level_sizes_ptr + number_of_levels)
+          m_tree_level_sizes(level_sizes_ptr, level_sizes_ptr + number_of_levels),
+          m_projected_leaves(projected_leaves_ptr, m_tree_level_sizes.back())
     {
         // The first level starts at 0
         m_tree_level_starts = {0};
@@ -518,6 +619,12 @@ class StaticRTree
     /* Returns all features inside the bounding box.
        Rectangle needs to be projected!*/
     std::vector<EdgeDataT> SearchInBox(const Rectangle &search_rectangle) const
+    {
+        return SearchInBox(GetThreadContext(), search_rectangle);
+    }
+
+    const std::vector<EdgeDataT> &SearchInBox(TraversalContext &context,
+                                              const Rectangle &search_rectangle) const
     {
         const Rectangle projected_rectangle{
             search_rectangle.min_lon,
@@ -526,15 +633,17 @@ class StaticRTree
                 web_mercator::latToY(toFloating(FixedLatitude(search_rectangle.min_lat)))}),
             toFixed(FloatLatitude{
                 web_mercator::latToY(toFloating(FixedLatitude(search_rectangle.max_lat)))})};
-        std::vector<EdgeDataT> results;
+        auto &results = context.results;
+        results.clear();
 
-        std::queue<TreeIndex> traversal_queue;
-        traversal_queue.push(TreeIndex{});
+        auto &traversal_queue = context.box_queue;
+        traversal_queue.clear();
+        traversal_queue.push_back(TreeIndex{});
 
-        while (!traversal_queue.empty())
+        for (std::size_t front = 0; front < traversal_queue.size(); ++front)
         {
-            auto const current_tree_index = traversal_queue.front();
-            traversal_queue.pop();
+            // a copy, pushing the children can reallocate the queue
+            auto const current_tree_index = traversal_queue[front];
 
             // If we're at the bottom of the tree, we need to explore the
             // element array
@@ -576,7 +685,7 @@ class StaticRTree
 
                     if (child_rectangle.Intersects(projected_rectangle))
                     {
-                        traversal_queue.push(TreeIndex(
+                        traversal_queue.push_back(TreeIndex(
                             current_tree_index.level + 1,
                             child_index - m_tree_level_starts[current_tree_index.level + 1]));
                     }
@@ -586,15 +695,13 @@ class StaticRTree
         return results;
     }
 
-    // Override filter and terminator for the desired behaviour.
     std::vector<EdgeDataT> Nearest(const Coordinate input_coordinate,
                                    const std::size_t max_results) const
     {
-        return Nearest(input_coordinate,
-                       [](const CandidateSegment &) { return std::make_pair(true, true); },
-                       [max_results](const std::size_t num_results, const CandidateSegment &) {
-                           return num_results >= max_results;
-                       });
+        return NearestK(GetThreadContext(),
+                        input_coordinate,
+                        max_results,
+                        [](const CandidateSegment &) { return std::make_pair(true, true); });
     }
 
     // Override filter and terminator for the desired behaviour.
@@ -603,11 +710,22 @@ class StaticRTree
                                    const FilterT filter,
                                    const TerminationT terminate) const
     {
-        std::vector<EdgeDataT> results;
-        auto projected_coordinate = web_mercator::fromWGS84(input_coordinate);
-        Coordinate fixed_projected_coordinate{projected_coordinate};
+        return Nearest(GetThreadContext(), input_coordinate, filter, terminate);
+    }
+
+    // Override filter and terminator for the desired behaviour.
+    template <typename FilterT, typename TerminationT>
+    const std::vector<EdgeDataT> &Nearest(TraversalContext &context,
+                                          const Coordinate input_coordinate,
+                                          const FilterT filter,
+                                          const TerminationT terminate) const
+    {
+        auto &results = context.results;
+        results.clear();
+        const Coordinate fixed_projected_coordinate{web_mercator::fromWGS84(input_coordinate)};
         // initialize queue with root element
-        std::priority_queue<QueryCandidate> traversal_queue;
+        auto &traversal_queue = context.traversal_queue;
+        traversal_queue.clear();
         traversal_queue.push(QueryCandidate{0, TreeIndex{}});
 
         while (!traversal_queue.empty())
@@ -622,13 +740,21 @@ class StaticRTree
                 {
                     ExploreLeafNode(current_tree_index,
                                     fixed_projected_coordinate,
-                                    projected_coordinate,
-                                    traversal_queue);
+                                    [&](const std::uint64_t squared_distance,
+                                        const std::uint32_t segment_index,
+                                        const Coordinate &projected_nearest) {
+                                        traversal_queue.push(QueryCandidate{squared_distance,
+                                                                            current_tree_index,
+                                                                            segment_index,
+                                                                            projected_nearest});
+                                    });
                 }
                 else
                 {
-                    ExploreTreeNode(
-                        current_tree_index, fixed_projected_coordinate, traversal_queue);
+                    ExploreTreeNode(current_tree_index,
+                                    fixed_projected_coordinate,
+                                    std::numeric_limits<std::uint64_t>::max(),
+                                    traversal_queue);
                 }
             }
             else
@@ -662,43 +788,204 @@ class StaticRTree
         return results;
     }
 
+    /**
+     * Returns the max_results nearest segments accepted by filter, like Nearest with a
+     * terminator that counts the results.
+     * The filter is applied when the leaf of a segment is explored, and again to the results.
+     * It must not depend on the order in which it sees the segments. Tree nodes and segments
+     * farther away than the max_results nearest accepted segments found so far are not queued.
+     */
+    template <typename FilterT>
+    const std::vector<EdgeDataT> &NearestK(TraversalContext &context,
+                                           const Coordinate input_coordinate,
+                                           const std::size_t max_results,
+                                           const FilterT filter) const
+    {
+        auto &results = context.results;
+        results.clear();
+        if (max_results == 0)
+        {
+            return results;
+        }
+
+        const Coordinate fixed_projected_coordinate{web_mercator::fromWGS84(input_coordinate)};
+        auto &traversal_queue = context.traversal_queue;
+        traversal_queue.clear();
+        traversal_queue.push(QueryCandidate{0, TreeIndex{}});
+
+        auto &nearest_distances = context.nearest_distances;
+        nearest_distances.clear();
+        const auto max_squared_distance = [&]() {
+            return nearest_distances.size() < max_results
+                       ? std::numeric_limits<std::uint64_t>::max()
+                       : nearest_distances.front();
+        };
+
+        while (!traversal_queue.empty() && results.size() < max_results)
+        {
+            const QueryCandidate current_query_node = traversal_queue.top();
+            traversal_queue.pop();
+
+            const TreeIndex &current_tree_index = current_query_node.tree_index;
+            if (!current_query_node.is_segment())
+            {
+                if (is_leaf(current_tree_index))
+                {
+                    ExploreLeafNode(
+                        current_tree_index,
+                        fixed_projected_coordinate,
+                        [&](const std::uint64_t squared_distance,
+                            const std::uint32_t segment_index,
+                            const Coordinate &projected_nearest) {
+                            if (squared_distance > max_squared_distance())
+                            {
+                                return;
+                            }
+                            const auto use_segment = filter(
+                                CandidateSegment{projected_nearest, m_objects[segment_index]});
+                            if (!use_segment.first && !use_segment.second)
+                            {
+                                return;
+                            }
+
+                            traversal_queue.push(QueryCandidate{squared_distance,
+                                                                current_tree_index,
+                                                                segment_index,
+                                                                projected_nearest});
+                            nearest_distances.push_back(squared_distance);
+                            std::push_heap(nearest_distances.begin(), nearest_distances.end());
+                            if (nearest_distances.size() > max_results)
+                            {
+                                std::pop_heap(nearest_distances.begin(), nearest_distances.end());
+                                nearest_distances.pop_back();
+                            }
+                        });
+                }
+                else
+                {
+                    ExploreTreeNode(current_tree_index,
+                                    fixed_projected_coordinate,
+                                    max_squared_distance(),
+                                    traversal_queue);
+                }
+            }
+            else
+            {
+                auto edge_data = m_objects[current_query_node.segment_index];
+                const auto use_segment = filter(
+                    CandidateSegment{current_query_node.fixed_projected_coordinate, edge_data});
+                BOOST_ASSERT(use_segment.first || use_segment.second);
+                edge_data.forward_segment_id.enabled &= use_segment.first;
+                edge_data.reverse_segment_id.enabled &= use_segment.second;
+                results.push_back(std::move(edge_data));
+            }
+        }
+
+        return results;
+    }
+
+    /**
+     * Answers the nearest queries of many coordinates. filter, terminate and handle get the
+     * index of the query as first argument, with max_threads other than 1 they are called
+     * concurrently for different queries (-1 for all available threads). handle gets the
+     * results of a query, they are only valid during the call.
+     *
+     * The queries run in the order of the Hilbert values of their coordinates, like the
+     * segments are stored. Consecutive queries mostly explore the same leaves while they are
+     * still in the CPU caches.
+     */
+    template <typename FilterT, typename TerminationT, typename HandlerT>
+    void BatchNearest(const std::vector<Coordinate> &input_coordinates,
+                      const FilterT filter,
+                      const TerminationT terminate,
+                      const HandlerT handle,
+                      const int max_threads = 1) const
+    {
+        std::vector<WrappedInputElement> query_order(input_coordinates.size());
+        for (const auto query : irange<std::size_t>(0, input_coordinates.size()))
+        {
+            const Coordinate projected{web_mercator::fromWGS84(input_coordinates[query])};
+            query_order[query] =
+                WrappedInputElement{GetHilbertCode(projected), static_cast<std::uint32_t>(query)};
+        }
+        std::sort(query_order.begin(), query_order.end());
+
+        const auto run_queries = [&](const tbb::blocked_range<std::size_t> &range) {
+            auto &context = GetThreadContext();
+            for (auto position = range.begin(); position != range.end(); ++position)
+            {
+                const std::size_t query = query_order[position].m_original_index;
+                handle(query,
+                       Nearest(context,
+                               input_coordinates[query],
+                               [&filter, query](const CandidateSegment &segment) {
+                                   return filter(query, segment);
+                               },
+                               [&terminate, query](const std::size_t num_results,
+                                                   const CandidateSegment &segment) {
+                                   return terminate(query, num_results, segment);
+                               }));
+            }
+        };
+
+        const tbb::blocked_range<std::size_t> all_queries(
+            0, query_order.size(), BATCH_GRAIN_SIZE);
+        if (max_threads == 1 || query_order.size() <= BATCH_GRAIN_SIZE)
+        {
+            run_queries(all_queries);
+        }
+        else
+        {
+            tbb::task_arena arena(max_threads);
+            arena.execute([&] { tbb::parallel_for(all_queries, run_queries); });
+        }
+    }
+
   private:
     /**
      * Iterates over all the objects in a leaf node and inserts them into our
      * search priority queue.  The speed of this function is very much governed
      * by the value of LEAF_NODE_SIZE, as we'll calculate the euclidean distance
      * for every child of each leaf node visited.
+     * The nearest points of all segments are computed at once from the projected leaf, push
+     * gets the squared distance, index and projected nearest point of every segment.
      */
-    template <typename QueueT>
+    template <typename PushT>
     void ExploreLeafNode(const TreeIndex &leaf_id,
                          const Coordinate &projected_input_coordinate_fixed,
-                         const FloatCoordinate &projected_input_coordinate,
-                         QueueT &traversal_queue) const
+                         const PushT push) const
     {
         // Check that we're actually looking at the bottom level of the tree
         BOOST_ASSERT(is_leaf(leaf_id));
-
-        for (const auto i : child_indexes(leaf_id))
+        BOOST_ASSERT(leaf_id.offset < m_projected_leaves.size());
+
+        const auto &projected_leaf = m_projected_leaves[leaf_id.offset];
+        const auto segments = child_indexes(leaf_id);
+
+        std::array<std::int32_t, LEAF_NODE_SIZE> nearest_lon;
+        std::array<std::int32_t, LEAF_NODE_SIZE> nearest_lat;
+        projectPointOnSegments(projected_leaf.u_lon.data(),
+                               projected_leaf.u_lat.data(),
+                               projected_leaf.v_lon.data(),
+                               projected_leaf.v_lat.data(),
+                               segments.size(),
+                               projected_input_coordinate_fixed,
+                               nearest_lon.data(),
+                               nearest_lat.data());
+
+        std::size_t position = 0;
+        for (const auto i : segments)
         {
-            const auto &current_edge = m_objects[i];
-
-            const auto projected_u = web_mercator::fromWGS84(m_coordinate_list[current_edge.u]);
-            const auto projected_v = web_mercator::fromWGS84(m_coordinate_list[current_edge.v]);
-
-            FloatCoordinate projected_nearest;
-            std::tie(std::ignore, projected_nearest) =
-                coordinate_calculation::projectPointOnSegment(
-                    projected_u, projected_v, projected_input_coordinate);
+            const Coordinate projected_nearest{FixedLongitude{nearest_lon[position]},
+                                               FixedLatitude{nearest_lat[position]}};
+            ++position;
 
             const auto squared_distance = coordinate_calculation::squaredEuclideanDistance(
                 projected_input_coordinate_fixed, projected_nearest);
             // distance must be non-negative
             BOOST_ASSERT(0. <= squared_distance);
             BOOST_ASSERT(i < std::numeric_limits<std::uint32_t>::max());
-            traversal_queue.push(QueryCandidate{squared_distance,
-                                                leaf_id,
-                                                static_cast<std::uint32_t>(i),
-                                                Coordinate{projected_nearest}});
+            push(squared_distance, static_cast<std::uint32_t>(i), projected_nearest);
         }
     }
 
@@ -708,10 +995,12 @@ class StaticRTree
      * priority metric.
      * The closests distance to a box from our point is also the closest distance
      * to the closest line in that box (assuming the boxes hug their contents).
+     * Children farther away than max_squared_distance are skipped.
      */
     template <class QueueT>
     void ExploreTreeNode(const TreeIndex &parent,
                          const Coordinate &fixed_projected_input_coordinate,
+                         const std::uint64_t max_squared_distance,
                          QueueT &traversal_queue) const
     {
         // Figure out which_id level the parent is on, and it's offset
@@ -726,6 +1015,10 @@ class StaticRTree
             const auto squared_lower_bound_to_element =
                 child.minimum_bounding_rectangle.GetMinSquaredDist(
                     fixed_projected_input_coordinate);
+            if (squared_lower_bound_to_element > max_squared_distance)
+            {
+                continue;
+            }
 
             traversal_queue.push(QueryCandidate{
                 squared_lower_bound_to_element,
@@ -26,14 +26,16 @@ namespace osrm
 namespace util
 {
 
-template <typename DataT>
-class VectorViewIterator : public boost::iterator_facade<VectorViewIterator<DataT>,
+template <typename DataT, typename ReferenceT = DataT &>
+class VectorViewIterator : public boost::iterator_facade<VectorViewIterator<DataT, ReferenceT>,
                                                          DataT,
-                                                         boost::random_access_traversal_tag>
+                                                         boost::random_access_traversal_tag,
+                                                         ReferenceT>
 {
-    typedef boost::iterator_facade<VectorViewIterator<DataT>,
+    typedef boost::iterator_facade<VectorViewIterator<DataT, ReferenceT>,
                                    DataT,
-                                   boost::random_access_traversal_tag>
+                                   boost::random_access_traversal_tag,
+                                   ReferenceT>
         base_t;
 
   public:
@@ -69,7 +71,9 @@ template <typename DataT> class vector_view
   public:
     using value_type = DataT;
     using iterator = VectorViewIterator<DataT>;
-    using const_iterator = VectorViewIterator<const DataT>;
+    // returns values like the const_iterator of PackedVector: iterator_range::operator[] would
+    // bind a reference to the temporary that iterator_facade returns for read-only iterators
+    using const_iterator = VectorViewIterator<const DataT, std::remove_const_t<DataT>>;
     using reverse_iterator = boost::reverse_iterator<iterator>;
 
     vector_view() : m_ptr(nullptr), m_size(0) {}
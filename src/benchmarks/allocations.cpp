@@ -0,0 +1,145 @@
+#include "benchmark_utils.hpp"
+
+#include "util/timing_util.hpp"
+
+#include "osrm/route_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+namespace
+{
+std::atomic<std::uint64_t> allocation_count{0};
+std::atomic<std::uint64_t> allocated_bytes{0};
+}
+
+// Counts all allocations of the process, the benchmark only reads the difference around a
+// request.
+void *operator new(std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+void benchmark(OSRM &osrm,
+               const std::string &name,
+               RouteParameters params,
+               const std::vector<Query> &queries)
+{
+    params.coordinates.resize(2);
+
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+    double meters = 0;
+    unsigned routed = 0;
+
+    TIMER_START(routes);
+    for (const auto &query : queries)
+    {
+        params.coordinates[0] = query.first;
+        params.coordinates[1] = query.second;
+
+        json::Object result;
+        const auto allocations_before = allocation_count.load();
+        const auto bytes_before = allocated_bytes.load();
+        const auto rc = osrm.Route(params, result);
+        allocations += allocation_count.load() - allocations_before;
+        bytes += allocated_bytes.load() - bytes_before;
+
+        if (rc == Status::Ok)
+        {
+            const auto &route = result.values["routes"].get<json::Array>().values.front();
+            meters += route.get<json::Object>().values.at("distance").get<json::Number>().value;
+            routed++;
+        }
+    }
+    TIMER_STOP(routes);
+
+    std::cout << name << ": " << (allocations / queries.size()) << " allocations/req ("
+              << (bytes / queries.size() / 1024) << " KiB), "
+              << (routed > 0 ? allocations / (meters / 1000.) : 0) << " allocations/km, "
+              << (TIMER_MSEC(routes) / queries.size()) << "ms/req for " << queries.size()
+              << " routes, " << (queries.size() - routed) << " without route" << std::endl;
+}
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [CH|MLD] [number of routes]\n"
+                  << "Counts the allocations of long routes, without and with unpacking the "
+                     "geometry and steps.\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+    if (argc > 2 && std::string{argv[2]} == "MLD")
+    {
+        config.algorithm = EngineConfig::Algorithm::MLD;
+    }
+    const unsigned num_queries = argc > 3 ? std::stoul(argv[3]) : 100;
+
+    const auto coordinates =
+        benchmarks::loadCoordinates(config.storage_config.node_based_nodes_data_path);
+    if (coordinates.empty())
+    {
+        std::cerr << "Error: dataset has no coordinates" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const auto queries = benchmarks::longQueries(coordinates, num_queries, 10);
+
+    OSRM osrm{config};
+
+    RouteParameters params;
+    params.overview = RouteParameters::OverviewType::False;
+    params.steps = false;
+    // the first run also creates the search heaps of the thread
+    benchmarks::benchmark(osrm, "warm-up", params, queries);
+    benchmarks::benchmark(osrm, "route only", params, queries);
+
+    params.overview = RouteParameters::OverviewType::Full;
+    params.steps = true;
+    params.annotations = true;
+    params.annotations_type = RouteParameters::AnnotationsType::All;
+    benchmarks::benchmark(osrm, "full geometry, steps and annotations", params, queries);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
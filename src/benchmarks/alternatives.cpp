@@ -0,0 +1,118 @@
+#include "benchmark_utils.hpp"
+
+#include "util/timing_util.hpp"
+
+#include "osrm/route_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+void benchmark(OSRM &osrm, const std::vector<Query> &queries, const bool alternatives)
+{
+    RouteParameters params;
+    params.overview = RouteParameters::OverviewType::False;
+    params.steps = false;
+    params.alternatives = alternatives;
+    params.coordinates.resize(2);
+
+    std::vector<double> latencies;
+    latencies.reserve(queries.size());
+    unsigned failed = 0;
+    unsigned with_alternative = 0;
+
+    TIMER_START(routes);
+    for (const auto &query : queries)
+    {
+        params.coordinates[0] = query.first;
+        params.coordinates[1] = query.second;
+
+        json::Object route_result;
+        TIMER_START(route);
+        const auto rc = osrm.Route(params, route_result);
+        TIMER_STOP(route);
+        latencies.push_back(TIMER_MSEC(route));
+        if (rc != Status::Ok)
+        {
+            failed++;
+            continue;
+        }
+        if (route_result.values["routes"].get<json::Array>().values.size() > 1)
+            with_alternative++;
+    }
+    TIMER_STOP(routes);
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double p) {
+        return latencies[static_cast<std::size_t>(p * (latencies.size() - 1))];
+    };
+
+    std::cout << "alternatives=" << (alternatives ? "true" : "false") << ": "
+              << TIMER_MSEC(routes) / queries.size() << "ms/req (p50 " << percentile(0.5)
+              << "ms, p99 " << percentile(0.99) << "ms), " << with_alternative
+              << " with an alternative, for " << queries.size() << " routes, " << failed
+              << " without route" << std::endl;
+}
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [CH|MLD] [number of routes]\n"
+                  << "Compares the route latency with and without alternatives on the longest "
+                     "quarter of random queries.\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+    if (argc > 2 && std::string{argv[2]} == "MLD")
+    {
+        config.algorithm = EngineConfig::Algorithm::MLD;
+    }
+    const unsigned num_queries = argc > 3 ? std::stoul(argv[3]) : 1000;
+
+    const auto coordinates =
+        benchmarks::loadCoordinates(config.storage_config.node_based_nodes_data_path);
+    if (coordinates.empty())
+    {
+        std::cerr << "Error: dataset has no coordinates" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const auto queries = benchmarks::longQueries(coordinates, num_queries, 4);
+
+    OSRM osrm{config};
+    // the first run pulls the data into the page cache and creates the search heaps
+    benchmarks::benchmark(osrm, queries, false);
+    benchmarks::benchmark(osrm, queries, false);
+    benchmarks::benchmark(osrm, queries, true);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,160 @@
+#ifndef OSRM_BENCHMARKS_BENCHMARK_UTILS_HPP
+#define OSRM_BENCHMARKS_BENCHMARK_UTILS_HPP
+
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+#include "util/coordinate_calculation.hpp"
+
+#include "osrm/coordinate.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+
+using Query = std::pair<util::Coordinate, util::Coordinate>;
+
+// Coordinates of all nodes of the node-based graph, from the .osrm.nbg_nodes file
+inline std::vector<util::Coordinate> loadCoordinates(const boost::filesystem::path &nodes_file)
+{
+    storage::io::FileReader nodes_path_file_reader(nodes_file,
+                                                   storage::io::FileReader::VerifyFingerprint);
+
+    std::vector<util::Coordinate> coords;
+    storage::serialization::read(nodes_path_file_reader, coords);
+    return coords;
+}
+
+inline std::vector<Query> randomQueries(const std::vector<util::Coordinate> &coordinates,
+                                        unsigned num_queries)
+{
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::uniform_int_distribution<std::size_t> index_udist(0, coordinates.size() - 1);
+
+    std::vector<Query> queries;
+    for (unsigned i = 0; i < num_queries; ++i)
+    {
+        queries.emplace_back(coordinates[index_udist(mt_rand)], coordinates[index_udist(mt_rand)]);
+    }
+    return queries;
+}
+
+// The longest of candidates_per_query * num_queries random queries by great-circle distance,
+// for benchmarks whose cost grows with the length of the routes
+inline std::vector<Query> longQueries(const std::vector<util::Coordinate> &coordinates,
+                                      unsigned num_queries,
+                                      unsigned candidates_per_query)
+{
+    auto queries = randomQueries(coordinates, num_queries * candidates_per_query);
+
+    const auto distance = [](const Query &query) {
+        return util::coordinate_calculation::haversineDistance(query.first, query.second);
+    };
+    const auto longer = [&](const Query &lhs, const Query &rhs) {
+        return distance(lhs) > distance(rhs);
+    };
+    std::nth_element(queries.begin(), queries.begin() + num_queries, queries.end(), longer);
+    queries.resize(num_queries);
+    return queries;
+}
+
+enum class PerfEvent
+{
+    CacheMisses,
+    DTLBReadMisses
+};
+
+// Counts a hardware event of the calling thread, if the kernel allows it
+class PerfCounter
+{
+  public:
+    explicit PerfCounter(const PerfEvent event)
+    {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        switch (event)
+        {
+        case PerfEvent::CacheMisses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PerfEvent::DTLBReadMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        }
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+        (void)event;
+#endif
+    }
+
+    ~PerfCounter()
+    {
+#ifdef __linux__
+        if (fd >= 0)
+            ::close(fd);
+#endif
+    }
+
+    PerfCounter(const PerfCounter &) = delete;
+    PerfCounter &operator=(const PerfCounter &) = delete;
+
+    bool Available() const { return fd >= 0; }
+
+    void Start()
+    {
+#ifdef __linux__
+        if (fd >= 0)
+        {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    std::uint64_t Stop()
+    {
+        std::uint64_t count = 0;
+#ifdef __linux__
+        if (fd >= 0)
+        {
+            ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (::read(fd, &count, sizeof(count)) != sizeof(count))
+                count = 0;
+        }
+#endif
+        return count;
+    }
+
+  private:
+    int fd = -1;
+};
+}
+}
+
+#endif
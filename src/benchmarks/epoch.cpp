@@ -0,0 +1,96 @@
+#include "util/epoch.hpp"
+#include "util/timing_util.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Stands in for the data facade, a request only reads a little from it
+struct Facade
+{
+    std::uint64_t checksum = 42;
+};
+
+// Runs the given number of threads that each acquire the facade and return the nanoseconds
+// per acquisition, over all threads
+template <typename AcquireFn>
+double measure(const unsigned num_threads, const unsigned iterations, AcquireFn acquire)
+{
+    std::atomic<bool> start{false};
+    std::atomic<std::uint64_t> sum{0};
+    std::vector<std::thread> threads;
+    for (unsigned index = 0; index < num_threads; ++index)
+    {
+        threads.emplace_back([&] {
+            while (!start)
+                std::this_thread::yield();
+            std::uint64_t local_sum = 0;
+            for (unsigned iteration = 0; iteration < iterations; ++iteration)
+            {
+                local_sum += acquire();
+            }
+            sum += local_sum;
+        });
+    }
+
+    TIMER_START(acquire);
+    start = true;
+    for (auto &thread : threads)
+        thread.join();
+    TIMER_STOP(acquire);
+
+    if (sum != std::uint64_t{42} * num_threads * iterations)
+        throw std::runtime_error("facade read wrong data");
+
+    return TIMER_MSEC(acquire) * 1e6 / (static_cast<double>(num_threads) * iterations);
+}
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    using namespace osrm;
+
+    const unsigned iterations = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    // what DataWatchdog::Get did before: copy a shared pointer to the facade
+    const auto shared_facade = std::make_shared<const benchmarks::Facade>();
+    const auto shared_acquire = [&shared_facade] {
+        const auto facade = shared_facade;
+        return facade->checksum;
+    };
+
+    util::EpochPointer<const benchmarks::Facade> epoch_facade(
+        std::make_unique<const benchmarks::Facade>());
+    const auto epoch_acquire = [&epoch_facade] {
+        const auto facade = epoch_facade.Acquire();
+        return facade->checksum;
+    };
+
+    std::cout << "threads\tshared_ptr ns/acquire\tepoch ns/acquire" << std::endl;
+    for (unsigned num_threads = 1; num_threads <= 64; num_threads *= 2)
+    {
+        const auto shared_nsec = benchmarks::measure(num_threads, iterations, shared_acquire);
+        const auto epoch_nsec = benchmarks::measure(num_threads, iterations, epoch_acquire);
+        std::cout << num_threads << "\t" << shared_nsec << "\t" << epoch_nsec << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,142 @@
+#include "benchmark_utils.hpp"
+
+#include "storage/storage.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/route_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Every run uses a fresh engine on a fresh thread, so the first queries pay for faulting in
+// the pages of the shared memory unless the engine warmed them up.
+void benchmark(EngineConfig config, const std::string &name, const std::vector<Query> &queries)
+{
+    std::thread runner([&] {
+        OSRM osrm{config};
+
+        RouteParameters params;
+        params.overview = RouteParameters::OverviewType::False;
+        params.steps = false;
+        params.coordinates.resize(2);
+
+        std::vector<double> latencies;
+        latencies.reserve(queries.size());
+        unsigned failed = 0;
+
+        PerfCounter tlb_misses(PerfEvent::DTLBReadMisses);
+        tlb_misses.Start();
+        TIMER_START(routes);
+        for (const auto &query : queries)
+        {
+            params.coordinates[0] = query.first;
+            params.coordinates[1] = query.second;
+
+            json::Object result;
+            TIMER_START(route);
+            const auto rc = osrm.Route(params, result);
+            TIMER_STOP(route);
+            latencies.push_back(TIMER_MSEC(route));
+            if (rc != Status::Ok)
+                failed++;
+        }
+        TIMER_STOP(routes);
+        const auto misses = tlb_misses.Stop();
+
+        const auto first_queries = std::min<std::size_t>(latencies.size(), 100);
+        double first_msec = 0;
+        for (std::size_t i = 0; i < first_queries; ++i)
+            first_msec += latencies[i];
+
+        std::sort(latencies.begin(), latencies.end());
+        const auto percentile = [&latencies](double p) {
+            return latencies[static_cast<std::size_t>(p * (latencies.size() - 1))];
+        };
+
+        std::cout << name << ": " << (TIMER_MSEC(routes) / queries.size()) << "ms/req (p50 "
+                  << percentile(0.5) << "ms, p99 " << percentile(0.99) << "ms, first "
+                  << first_queries << " " << (first_msec / first_queries) << "ms/req), ";
+        if (tlb_misses.Available())
+            std::cout << (misses / queries.size()) << " dTLB misses/req";
+        else
+            std::cout << "dTLB misses not available";
+        std::cout << ", " << failed << " without route" << std::endl;
+    });
+    runner.join();
+}
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [CH|MLD] [number of routes]\n"
+                  << "Loads the data into shared memory like osrm-datastore, once with normal "
+                     "and once with huge pages, and keeps the last load.\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.use_shared_memory = true;
+    if (argc > 2 && std::string{argv[2]} == "MLD")
+    {
+        config.algorithm = EngineConfig::Algorithm::MLD;
+    }
+    const unsigned num_queries = argc > 3 ? std::stoul(argv[3]) : 1000;
+
+    const storage::StorageConfig storage_config{argv[1]};
+    const auto coordinates =
+        benchmarks::loadCoordinates(storage_config.node_based_nodes_data_path);
+    if (coordinates.empty())
+    {
+        std::cerr << "Error: dataset has no coordinates" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const auto queries = benchmarks::randomQueries(coordinates, num_queries);
+
+    for (const auto huge_pages : {false, true})
+    {
+        storage::Storage storage(storage_config);
+        if (storage.Run(-1, false, huge_pages) != EXIT_SUCCESS)
+        {
+            std::cerr << "Error: could not load the data into shared memory" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        const std::string pages = huge_pages ? "huge pages" : "normal pages";
+        config.warm_up = false;
+        benchmarks::benchmark(config, pages, queries);
+        config.warm_up = true;
+        benchmarks::benchmark(config, pages + " with warm-up", queries);
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
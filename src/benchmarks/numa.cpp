@@ -0,0 +1,144 @@
+#include "benchmark_utils.hpp"
+
+#include "util/numa.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/route_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Runs the routes on num_threads threads spread over the NUMA nodes like osrm-routed does and
+// returns the routes per second over all threads
+double measure(const OSRM &osrm,
+               const std::vector<util::Coordinate> &coordinates,
+               const unsigned num_threads,
+               const unsigned routes_per_thread)
+{
+    std::atomic<bool> start{false};
+    std::atomic<unsigned> ready{0};
+    std::atomic<std::uint64_t> routed{0};
+    std::vector<std::thread> threads;
+    for (unsigned index = 0; index < num_threads; ++index)
+    {
+        threads.emplace_back([&, index] {
+            util::numa::pinThreadToNode(index % util::numa::getNodeCount());
+
+            std::mt19937 mt_rand(RANDOM_SEED + index);
+            std::uniform_int_distribution<std::size_t> index_udist(0, coordinates.size() - 1);
+            RouteParameters params;
+            params.overview = RouteParameters::OverviewType::False;
+            params.steps = false;
+            params.coordinates.resize(2);
+
+            // the first route creates the search heaps of the thread
+            json::Object result;
+            params.coordinates[0] = coordinates[index_udist(mt_rand)];
+            params.coordinates[1] = coordinates[index_udist(mt_rand)];
+            osrm.Route(params, result);
+
+            ready++;
+            while (!start)
+                std::this_thread::yield();
+
+            std::uint64_t local_routed = 0;
+            for (unsigned route = 0; route < routes_per_thread; ++route)
+            {
+                params.coordinates[0] = coordinates[index_udist(mt_rand)];
+                params.coordinates[1] = coordinates[index_udist(mt_rand)];
+                json::Object route_result;
+                if (osrm.Route(params, route_result) == Status::Ok)
+                    local_routed++;
+            }
+            routed += local_routed;
+        });
+    }
+
+    while (ready != num_threads)
+        std::this_thread::yield();
+
+    TIMER_START(routes);
+    start = true;
+    for (auto &thread : threads)
+        thread.join();
+    TIMER_STOP(routes);
+
+    return num_threads * routes_per_thread / TIMER_SEC(routes);
+}
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " data.osrm [CH|MLD] [number of threads] [routes per thread]\n"
+                  << "Compares the route throughput with one copy of the data and with a copy "
+                     "per NUMA node.\nRun it with numactl --interleave=all to spread the shared "
+                     "copy over all nodes.\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+    if (argc > 2 && std::string{argv[2]} == "MLD")
+    {
+        config.algorithm = EngineConfig::Algorithm::MLD;
+    }
+    const unsigned num_threads =
+        argc > 3 ? std::stoul(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+    const unsigned routes_per_thread = argc > 4 ? std::stoul(argv[4]) : 1000;
+
+    const auto coordinates =
+        benchmarks::loadCoordinates(config.storage_config.node_based_nodes_data_path);
+    if (coordinates.empty())
+    {
+        std::cerr << "Error: dataset has no coordinates" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "NUMA nodes: " << util::numa::getNodeCount() << ", threads: " << num_threads
+              << std::endl;
+
+    for (const bool numa_replicate : {false, true})
+    {
+        config.numa_replicate = numa_replicate;
+        const OSRM osrm{config};
+        const auto routes_per_second =
+            benchmarks::measure(osrm, coordinates, num_threads, routes_per_thread);
+        std::cout << (numa_replicate ? "replica per node: " : "single copy: ")
+                  << routes_per_second << " routes/s" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
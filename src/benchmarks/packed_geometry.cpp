@@ -0,0 +1,137 @@
+#include "benchmark_utils.hpp"
+
+#include "extractor/packed_geometry.hpp"
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+#include "util/timing_util.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+struct Result
+{
+    double nsec_per_geometry;
+    // sum of the last nodes, printed so the unpacking cannot be optimized away
+    std::uint64_t checksum;
+};
+
+// Measures unpacking the given geometries with unpack
+template <typename UnpackFn>
+Result measure(const std::vector<std::uint32_t> &geometries, UnpackFn unpack)
+{
+    std::vector<NodeID> nodes;
+    std::uint64_t checksum = 0;
+    TIMER_START(unpack);
+    for (const auto id : geometries)
+    {
+        unpack(id, nodes);
+        checksum += nodes.empty() ? 0 : nodes.back();
+    }
+    TIMER_STOP(unpack);
+
+    return Result{TIMER_MSEC(unpack) * 1e6 / geometries.size(), checksum};
+}
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [number of geometries]\n"
+                  << "Compares size and unpacking time of the plain and the packed geometry "
+                     "node lists.\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    const boost::filesystem::path geometries_path{std::string{argv[1]} + ".geometry"};
+    const unsigned num_geometries = argc > 2 ? std::stoul(argv[2]) : 1000000;
+
+    std::vector<std::uint32_t> index;
+    std::vector<NodeID> nodes;
+    {
+        storage::io::FileReader reader(geometries_path,
+                                       storage::io::FileReader::VerifyFingerprint);
+        storage::serialization::read(reader, index);
+        storage::serialization::read(reader, nodes);
+    }
+    if (index.size() < 2)
+    {
+        std::cerr << "Error: dataset has no geometries" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    TIMER_START(pack);
+    extractor::PackedGeometryEncoder counter(index.data(), index.size());
+    counter.Push(nodes.begin(), nodes.end());
+    counter.Finish();
+    std::vector<NodeID> first_nodes(counter.GetNumberOfGeometries());
+    std::vector<extractor::PackedGeometryBlock> blocks(counter.GetNumberOfBlocks());
+    std::vector<extractor::PackedGeometryEncoder::WordT> words(counter.GetNumberOfWords());
+    extractor::PackedGeometryEncoder encoder(
+        index.data(), index.size(), first_nodes.data(), blocks.data(), words.data());
+    encoder.Push(nodes.begin(), nodes.end());
+    encoder.Finish();
+    TIMER_STOP(pack);
+
+    const auto plain_bytes = nodes.size() * sizeof(NodeID);
+    const auto packed_bytes = first_nodes.size() * sizeof(NodeID) +
+                              blocks.size() * sizeof(extractor::PackedGeometryBlock) +
+                              words.size() * sizeof(extractor::PackedGeometryEncoder::WordT);
+    const extractor::PackedGeometry packed{
+        std::move(first_nodes), std::move(blocks), std::move(words)};
+
+    std::cout << "nodes: " << nodes.size() << ", geometries: " << (index.size() - 1) << std::endl;
+    std::cout << "plain: " << (plain_bytes >> 20) << " MiB, packed: " << (packed_bytes >> 20)
+              << " MiB (" << (100.0 * packed_bytes / plain_bytes) << "%), packed in "
+              << TIMER_SEC(pack) << "s" << std::endl;
+
+    std::mt19937 mt_rand(benchmarks::RANDOM_SEED);
+    std::uniform_int_distribution<std::uint32_t> geometry_udist(0, index.size() - 2);
+    std::vector<std::uint32_t> geometries(num_geometries);
+    std::generate(geometries.begin(), geometries.end(), [&] { return geometry_udist(mt_rand); });
+
+    const auto plain_result =
+        benchmarks::measure(geometries, [&](const std::uint32_t id, std::vector<NodeID> &out) {
+            out.assign(nodes.begin() + index[id], nodes.begin() + index[id + 1]);
+        });
+    const auto packed_result =
+        benchmarks::measure(geometries, [&](const std::uint32_t id, std::vector<NodeID> &out) {
+            out.resize(index[id + 1] - index[id]);
+            packed.Decode(id, index[id], index[id + 1], out.begin());
+        });
+
+    std::cout << "plain: " << plain_result.nsec_per_geometry
+              << " ns/geometry, packed: " << packed_result.nsec_per_geometry
+              << " ns/geometry (checksum " << plain_result.checksum << ")" << std::endl;
+
+    if (plain_result.checksum != packed_result.checksum)
+    {
+        std::cerr << "Error: packed geometries decode to other nodes, checksum "
+                  << packed_result.checksum << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
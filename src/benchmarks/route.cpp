@@ -0,0 +1,155 @@
+#include "benchmark_utils.hpp"
+
+#include "util/timing_util.hpp"
+
+#include "osrm/route_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+struct Result
+{
+    double msec_per_route;
+    double misses_per_route;
+};
+
+// The search heaps are thread-local, so every run uses a fresh thread to make sure
+// the heaps are created with the heap index settings of the given config.
+Result benchmark(EngineConfig config, const std::string &name, const std::vector<Query> &queries)
+{
+    Result result;
+    std::thread runner([&] {
+        OSRM osrm{config};
+
+        RouteParameters params;
+        params.overview = RouteParameters::OverviewType::False;
+        params.steps = false;
+        params.coordinates.resize(2);
+
+        std::vector<double> latencies;
+        latencies.reserve(queries.size());
+        unsigned failed = 0;
+
+        PerfCounter cache_misses(PerfEvent::CacheMisses);
+        cache_misses.Start();
+        TIMER_START(routes);
+        for (const auto &query : queries)
+        {
+            params.coordinates[0] = query.first;
+            params.coordinates[1] = query.second;
+
+            json::Object route_result;
+            TIMER_START(route);
+            const auto rc = osrm.Route(params, route_result);
+            TIMER_STOP(route);
+            latencies.push_back(TIMER_MSEC(route));
+            if (rc != Status::Ok)
+                failed++;
+        }
+        TIMER_STOP(routes);
+        const auto misses = cache_misses.Stop();
+
+        std::sort(latencies.begin(), latencies.end());
+        const auto percentile = [&latencies](double p) {
+            return latencies[static_cast<std::size_t>(p * (latencies.size() - 1))];
+        };
+
+        result.msec_per_route = TIMER_MSEC(routes) / queries.size();
+        result.misses_per_route = static_cast<double>(misses) / queries.size();
+
+        std::cout << name << ": " << result.msec_per_route << "ms/req (p50 " << percentile(0.5)
+                  << "ms, p99 " << percentile(0.99) << "ms), ";
+        if (cache_misses.Available())
+            std::cout << result.misses_per_route << " cache misses/req, ";
+        std::cout << "for " << queries.size() << " routes, " << failed << " without route"
+                  << std::endl;
+    });
+    runner.join();
+    return result;
+}
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " data.osrm [CH|MLD] [number of routes] [renumbered.osrm]\n"
+                  << "Compares the route latency with array and hash map based heap indices.\n"
+                  << "Given a copy of the dataset prepared with osrm-contract --renumber-nodes it "
+                     "compares the latency and cache misses of both node orders instead.\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+    if (argc > 2 && std::string{argv[2]} == "MLD")
+    {
+        config.algorithm = EngineConfig::Algorithm::MLD;
+    }
+    const unsigned num_queries = argc > 3 ? std::stoul(argv[3]) : 1000;
+
+    const auto coordinates =
+        benchmarks::loadCoordinates(config.storage_config.node_based_nodes_data_path);
+    if (coordinates.empty())
+    {
+        std::cerr << "Error: dataset has no coordinates" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const auto queries = benchmarks::randomQueries(coordinates, num_queries);
+
+    if (argc > 4)
+    {
+        // the first run pulls the files into the page cache for the second one
+        benchmarks::benchmark(config, "warm-up", queries);
+        const auto original = benchmarks::benchmark(config, "original node order", queries);
+
+        config.storage_config = {argv[4]};
+        benchmarks::benchmark(config, "warm-up", queries);
+        const auto renumbered = benchmarks::benchmark(config, "renumbered nodes", queries);
+
+        std::cout << "delta: " << (renumbered.msec_per_route - original.msec_per_route)
+                  << "ms/req ("
+                  << (100. * renumbered.msec_per_route / original.msec_per_route - 100.) << "%), "
+                  << (renumbered.misses_per_route - original.misses_per_route)
+                  << " cache misses/req" << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    config.max_heap_index_memory_mb = 0;
+    benchmarks::benchmark(config, "hash map heap index", queries);
+
+    config.max_heap_index_memory_mb = -1;
+    benchmarks::benchmark(config, "generation array heap index", queries);
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,94 @@
+#include "benchmark_utils.hpp"
+
+#include "util/timing_util.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+#include "osrm/nearest_parameters.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <boost/filesystem/operations.hpp>
+
+#include <exception>
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+// Returns the time in milliseconds to start an engine and answer a first request. Mapped
+// data is only read on access, so the first request is part of the startup.
+double measureStartup(EngineConfig config, const util::Coordinate coordinate)
+{
+    TIMER_START(startup);
+    OSRM osrm{config};
+
+    NearestParameters params;
+    params.coordinates.push_back(coordinate);
+    json::Object result;
+    if (osrm.Nearest(params, result) != Status::Ok)
+    {
+        throw std::runtime_error("nearest request failed");
+    }
+    TIMER_STOP(startup);
+
+    return TIMER_MSEC(startup);
+}
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osrm [CH|MLD]\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+    if (argc > 2 && std::string{argv[2]} == "MLD")
+    {
+        config.algorithm = EngineConfig::Algorithm::MLD;
+    }
+
+    const auto coordinates =
+        benchmarks::loadCoordinates(config.storage_config.node_based_nodes_data_path);
+    if (coordinates.empty())
+    {
+        std::cerr << "Error: dataset has no coordinates" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const auto coordinate = coordinates[coordinates.size() / 2];
+
+    const auto load_msec = benchmarks::measureStartup(config, coordinate);
+
+    // the first start with mmap creates the memory image, later starts only map it
+    config.use_mmap = true;
+    boost::filesystem::remove(config.storage_config.memory_image_path);
+    const auto create_image_msec = benchmarks::measureStartup(config, coordinate);
+    const auto map_image_msec = benchmarks::measureStartup(config, coordinate);
+
+    std::cout << load_msec << "ms loading into memory" << std::endl;
+    std::cout << create_image_msec << "ms creating and mapping the memory image" << std::endl;
+    std::cout << map_image_msec << "ms mapping the memory image" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -1,8 +1,9 @@
+#include "benchmark_utils.hpp"
+
 #include "util/static_rtree.hpp"
 #include "extractor/edge_based_node_segment.hpp"
 #include "extractor/query_node.hpp"
 #include "mocks/mock_datafacade.hpp"
-#include "storage/io.hpp"
 #include "engine/geospatial_query.hpp"
 #include "util/coordinate.hpp"
 #include "util/serialization.hpp"
@@ -20,8 +21,6 @@ namespace benchmarks
 
 using namespace osrm::test;
 
-// Choosen by a fair W20 dice roll (this value is completely arbitrary)
-constexpr unsigned RANDOM_SEED = 13;
 constexpr int32_t WORLD_MIN_LAT = -90 * COORDINATE_PRECISION;
 constexpr int32_t WORLD_MAX_LAT = 90 * COORDINATE_PRECISION;
 constexpr int32_t WORLD_MIN_LON = -180 * COORDINATE_PRECISION;
@@ -30,16 +29,6 @@ constexpr int32_t WORLD_MAX_LON = 180 * COORDINATE_PRECISION;
 using RTreeLeaf = extractor::EdgeBasedNodeSegment;
 using BenchStaticRTree = util::StaticRTree<RTreeLeaf, storage::Ownership::Container>;
 
-std::vector<util::Coordinate> loadCoordinates(const boost::filesystem::path &nodes_file)
-{
-    storage::io::FileReader nodes_path_file_reader(nodes_file,
-                                                   storage::io::FileReader::VerifyFingerprint);
-
-    std::vector<util::Coordinate> coords;
-    storage::serialization::read(nodes_path_file_reader, coords);
-    return coords;
-}
-
 template <typename QueryT>
 void benchmarkQuery(const std::vector<util::Coordinate> &queries,
                     const std::string &name,
@@ -62,7 +51,34 @@ void benchmarkQuery(const std::vector<util::Coordinate> &queries,
               << ")" << std::endl;
 }
 
-void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
+// Snaps all queries at once, like the coordinates of a large table request
+void benchmarkBatch(BenchStaticRTree &rtree,
+                    const std::vector<util::Coordinate> &queries,
+                    const std::string &name,
+                    const int max_threads)
+{
+    std::cout << "Running " << name << " with " << queries.size() << " coordinates: " << std::flush;
+
+    TIMER_START(query);
+    rtree.BatchNearest(
+        queries,
+        [](const std::size_t, const BenchStaticRTree::CandidateSegment &) {
+            return std::make_pair(true, true);
+        },
+        [](const std::size_t,
+           const std::size_t num_results,
+           const BenchStaticRTree::CandidateSegment &) { return num_results >= 1; },
+        [](const std::size_t, const std::vector<RTreeLeaf> &) {},
+        max_threads);
+    TIMER_STOP(query);
+
+    std::cout << "Took " << TIMER_SEC(query) << " seconds  ->  "
+              << TIMER_MSEC(query) * 1000. / queries.size() << " us/coordinate" << std::endl;
+}
+
+void benchmark(BenchStaticRTree &rtree,
+               const std::vector<util::Coordinate> &coordinates,
+               unsigned num_queries)
 {
     std::mt19937 mt_rand(RANDOM_SEED);
     std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
@@ -80,6 +96,25 @@ void benchmark(BenchStaticRTree &rtree, unsigned num_queries)
     benchmarkQuery(queries, "raw RTree queries (10 results)", [&rtree](const util::Coordinate &q) {
         return rtree.Nearest(q, 10);
     });
+
+    // coordinates close to the roads of the dataset, in no particular order
+    std::uniform_int_distribution<std::size_t> index_udist(0, coordinates.size() - 1);
+    std::uniform_int_distribution<> offset_udist(-1000, 1000);
+    std::vector<util::Coordinate> local_queries;
+    for (unsigned i = 0; i < num_queries; i++)
+    {
+        const auto &coordinate = coordinates[index_udist(mt_rand)];
+        local_queries.emplace_back(
+            util::FixedLongitude{static_cast<std::int32_t>(coordinate.lon) + offset_udist(mt_rand)},
+            util::FixedLatitude{static_cast<std::int32_t>(coordinate.lat) + offset_udist(mt_rand)});
+    }
+
+    benchmarkQuery(local_queries,
+                   "RTree queries close to roads (1 result)",
+                   [&rtree](const util::Coordinate &q) { return rtree.Nearest(q, 1); });
+    benchmarkBatch(rtree, local_queries, "batch of queries close to roads (1 result)", 1);
+    benchmarkBatch(
+        rtree, local_queries, "batch of queries close to roads on all threads (1 result)", -1);
 }
 }
 }
@@ -101,7 +136,7 @@ int main(int argc, char **argv)
 
     osrm::benchmarks::BenchStaticRTree rtree(ram_path, file_path, coords);
 
-    osrm::benchmarks::benchmark(rtree, 10000);
+    osrm::benchmarks::benchmark(rtree, coords, 10000);
 
     return 0;
 }
@@ -0,0 +1,118 @@
+#include "benchmark_utils.hpp"
+
+#include "util/json_renderer.hpp"
+#include "util/json_writer.hpp"
+#include "util/timing_util.hpp"
+
+#include "osrm/table_parameters.hpp"
+
+#include "osrm/coordinate.hpp"
+#include "osrm/engine_config.hpp"
+#include "osrm/json_container.hpp"
+
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cstdlib>
+
+namespace osrm
+{
+namespace benchmarks
+{
+
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " data.osrm [CH|MLD] [number of locations] [number of requests]\n";
+        return EXIT_FAILURE;
+    }
+
+    using namespace osrm;
+
+    // Configure based on a .osrm base path, and no datasets in shared mem from osrm-datastore
+    EngineConfig config;
+    config.storage_config = {argv[1]};
+    config.use_shared_memory = false;
+    if (argc > 2 && std::string{argv[2]} == "MLD")
+    {
+        config.algorithm = EngineConfig::Algorithm::MLD;
+    }
+    const unsigned num_locations = argc > 3 ? std::stoul(argv[3]) : 100;
+    const unsigned num_requests = argc > 4 ? std::stoul(argv[4]) : 10;
+
+    const auto coordinates =
+        benchmarks::loadCoordinates(config.storage_config.node_based_nodes_data_path);
+    if (coordinates.empty())
+    {
+        std::cerr << "Error: dataset has no coordinates" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    OSRM osrm{config};
+
+    std::mt19937 mt_rand(benchmarks::RANDOM_SEED);
+    std::uniform_int_distribution<std::size_t> index_udist(0, coordinates.size() - 1);
+
+    TableParameters params;
+    for (unsigned i = 0; i < num_locations; ++i)
+    {
+        params.coordinates.push_back(coordinates[index_udist(mt_rand)]);
+    }
+
+    // both variants include rendering the response as the server does
+    std::vector<char> rendered;
+    TIMER_START(tables);
+    for (unsigned i = 0; i < num_requests; ++i)
+    {
+        json::Object result;
+        const auto rc = osrm.Table(params, result);
+        if (rc != Status::Ok)
+        {
+            std::cerr << "Error: table request failed" << std::endl;
+            return EXIT_FAILURE;
+        }
+        rendered.clear();
+        util::json::render(rendered, result);
+    }
+    TIMER_STOP(tables);
+
+    TIMER_START(streamed_tables);
+    for (unsigned i = 0; i < num_requests; ++i)
+    {
+        rendered.clear();
+        util::json::Writer writer(rendered);
+        const auto rc = osrm.Table(params, writer);
+        if (rc != Status::Ok)
+        {
+            std::cerr << "Error: table request failed" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    TIMER_STOP(streamed_tables);
+
+    const auto num_cells = static_cast<double>(num_locations) * num_locations;
+    std::cout << (TIMER_MSEC(tables) / num_requests) << "ms/req at " << num_locations << "x"
+              << num_locations << " locations" << std::endl;
+    std::cout << (TIMER_USEC(tables) / num_requests / num_cells) << "us/cell" << std::endl;
+    std::cout << (TIMER_MSEC(streamed_tables) / num_requests) << "ms/req streamed, "
+              << (TIMER_USEC(streamed_tables) / num_requests / num_cells) << "us/cell"
+              << std::endl;
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -3,9 +3,11 @@
 #include "contractor/files.hpp"
 #include "contractor/graph_contractor.hpp"
 #include "contractor/graph_contractor_adaptors.hpp"
+#include "contractor/renumber.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
+#include "extractor/files.hpp"
 #include "extractor/node_based_edge.hpp"
 
 #include "storage/io.hpp"
@@ -22,6 +24,8 @@
 #include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
 #include <algorithm>
 #include <bitset>
 #include <cstdint>
@@ -35,6 +39,58 @@ namespace osrm
 namespace contractor
 {
 
+namespace
+{
+// Applies the permutation to the extractor files that store edge-based node IDs
+void renumberFiles(const ContractorConfig &config, const std::vector<NodeID> &permutation)
+{
+    {
+        std::vector<EdgeWeight> node_weights;
+        {
+            storage::io::FileReader reader(config.node_file_path,
+                                           storage::io::FileReader::VerifyFingerprint);
+            storage::serialization::read(reader, node_weights);
+        }
+        renumber(node_weights, permutation);
+        storage::io::FileWriter writer(config.node_file_path,
+                                       storage::io::FileWriter::GenerateFingerprint);
+        storage::serialization::write(writer, node_weights);
+    }
+    {
+        // read again, the updater changed the weights of the edges in memory
+        EdgeID max_edge_id;
+        std::vector<extractor::EdgeBasedEdge> edge_based_edge_list;
+        const auto &edge_based_graph_path = config.updater_config.edge_based_graph_path;
+        extractor::files::readEdgeBasedGraph(
+            edge_based_graph_path, max_edge_id, edge_based_edge_list);
+        renumber(edge_based_edge_list, permutation);
+        extractor::files::writeEdgeBasedGraph(
+            edge_based_graph_path, max_edge_id, edge_based_edge_list);
+    }
+    extractor::renumberNodeFiles(config.updater_config.rtree_leaf_path,
+                                 config.updater_config.edge_based_nodes_data_path,
+                                 permutation);
+    {
+        std::vector<extractor::NBGToEBG> mapping;
+        extractor::files::readNBGMapping(config.cnbg_ebg_mapping_path, mapping);
+        renumber(mapping, permutation);
+        extractor::files::writeNBGMapping(config.cnbg_ebg_mapping_path, mapping);
+    }
+
+    for (const auto &path :
+         {config.mld_partition_path, config.mld_storage_path, config.mld_graph_path})
+    {
+        if (boost::filesystem::exists(path))
+        {
+            util::Log(logWARNING) << "Found existing " << path << " file, removing. You need to "
+                                  << "re-run osrm-partition and osrm-customize after "
+                                  << "osrm-contract --renumber-nodes.";
+            boost::filesystem::remove(path);
+        }
+    }
+}
+}
+
 int Contractor::Run()
 {
     if (config.core_factor > 1.0 || config.core_factor < 0)
@@ -86,6 +142,25 @@ int Contractor::Run()
 
     util::Log() << "Contraction took " << TIMER_SEC(contraction) << " sec";
 
+    if (config.renumber_nodes)
+    {
+        TIMER_START(renumber);
+        // the contractor does not return the levels it was given
+        if (config.use_cached_priority)
+        {
+            files::readLevels(config.level_output_path, node_levels);
+        }
+
+        const auto permutation =
+            makePermutation(max_edge_id + 1, contracted_edge_list, node_levels, is_core_node);
+        renumber(contracted_edge_list, permutation);
+        renumber(is_core_node, permutation);
+        renumber(node_levels, permutation);
+        renumberFiles(config, permutation);
+        TIMER_STOP(renumber);
+        util::Log() << "Renumbered data in " << TIMER_SEC(renumber) << " seconds";
+    }
+
     {
         RangebasedCRC32 crc32_calculator;
         const unsigned checksum = crc32_calculator(contracted_edge_list);
@@ -96,7 +171,7 @@ int Contractor::Run()
     }
 
     files::writeCoreMarker(config.core_output_path, is_core_node);
-    if (!config.use_cached_priority)
+    if (!config.use_cached_priority || config.renumber_nodes)
     {
         files::writeLevels(config.level_output_path, node_levels);
     }
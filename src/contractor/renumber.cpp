@@ -0,0 +1,88 @@
+#include "contractor/renumber.hpp"
+
+#include "util/integer_range.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace osrm
+{
+namespace contractor
+{
+
+std::vector<NodeID> makePermutation(const NodeID number_of_nodes,
+                                    const util::DeallocatingVector<QueryEdge> &edges,
+                                    const std::vector<float> &node_levels,
+                                    const std::vector<bool> &is_core_node)
+{
+    const auto is_core = [&is_core_node](const NodeID node) {
+        return !is_core_node.empty() && is_core_node[node];
+    };
+    const auto rank = [&](const NodeID node) {
+        if (is_core(node))
+            return std::numeric_limits<float>::max();
+        return node_levels.empty() ? 0.f : node_levels[node];
+    };
+
+    // The edges of a contracted node lead to higher nodes, so every edge makes its source a
+    // child of its target. The children are stored in adjacency array form.
+    std::vector<std::uint32_t> first_child(number_of_nodes + 1, 0);
+    for (const auto &edge : edges)
+        first_child[edge.target + 1]++;
+    std::partial_sum(first_child.begin(), first_child.end(), first_child.begin());
+    std::vector<NodeID> children(first_child.back());
+    {
+        auto position = first_child;
+        for (const auto &edge : edges)
+            children[position[edge.target]++] = edge.source;
+    }
+
+    std::vector<NodeID> roots(number_of_nodes);
+    std::iota(roots.begin(), roots.end(), 0);
+    std::stable_sort(roots.begin(), roots.end(), [&rank](const NodeID lhs, const NodeID rhs) {
+        return rank(lhs) > rank(rhs);
+    });
+
+    std::vector<NodeID> permutation(number_of_nodes, SPECIAL_NODEID);
+    NodeID next_id = 0;
+
+    // The core is searched by every query that reaches it, so it is kept together in its
+    // original order
+    for (const auto node : roots)
+    {
+        if (!is_core(node))
+            break;
+        permutation[node] = next_id++;
+    }
+
+    std::vector<NodeID> stack;
+    for (const auto root : roots)
+    {
+        if (!is_core(root) && permutation[root] != SPECIAL_NODEID)
+            continue;
+
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            const auto node = stack.back();
+            stack.pop_back();
+            if (permutation[node] == SPECIAL_NODEID)
+                permutation[node] = next_id++;
+            else if (node != root)
+                continue;
+
+            // reversed, so the first child is visited first
+            for (auto child = first_child[node + 1]; child > first_child[node]; --child)
+            {
+                if (permutation[children[child - 1]] == SPECIAL_NODEID)
+                    stack.push_back(children[child - 1]);
+            }
+        }
+    }
+    BOOST_ASSERT(next_id == number_of_nodes);
+
+    return permutation;
+}
+}
+}
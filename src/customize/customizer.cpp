@@ -1,6 +1,7 @@
 #include "customizer/customizer.hpp"
 #include "customizer/cell_customizer.hpp"
 #include "customizer/edge_based_graph.hpp"
+#include "customizer/files.hpp"
 
 #include "partition/cell_storage.hpp"
 #include "partition/edge_based_graph_reader.hpp"
@@ -14,6 +15,11 @@
 #include "util/log.hpp"
 #include "util/timing_util.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <iterator>
+
 namespace osrm
 {
 namespace customizer
@@ -72,13 +78,16 @@ void CellStorageStatistics(const Graph &graph,
 }
 
 auto LoadAndUpdateEdgeExpandedGraph(const CustomizationConfig &config,
-                                    const partition::MultiLevelPartition &mlp)
+                                    const partition::MultiLevelPartition &mlp,
+                                    std::vector<NodeID> &updated_nodes)
 {
     updater::Updater updater(config.updater_config);
 
-    EdgeID num_nodes;
+    std::vector<EdgeWeight> node_weights;
     std::vector<extractor::EdgeBasedEdge> edge_based_edge_list;
-    std::tie(num_nodes, edge_based_edge_list) = updater.LoadAndUpdateEdgeExpandedGraph();
+    const EdgeID num_nodes =
+        updater.LoadAndUpdateEdgeExpandedGraph(edge_based_edge_list, node_weights, updated_nodes) +
+        1;
 
     auto directed = partition::splitBidirectionalEdges(edge_based_edge_list);
     auto tidied =
@@ -100,21 +109,55 @@ int Customizer::Run(const CustomizationConfig &config)
     partition::MultiLevelPartition mlp;
     partition::files::readPartition(config.mld_partition_path, mlp);
 
-    auto edge_based_graph = LoadAndUpdateEdgeExpandedGraph(config, mlp);
+    std::vector<NodeID> updated_nodes;
+    auto edge_based_graph = LoadAndUpdateEdgeExpandedGraph(config, mlp, updated_nodes);
 
     partition::CellStorage storage;
     partition::files::readCells(config.mld_storage_path, storage);
     TIMER_STOP(loading_data);
     util::Log() << "Loading partition data took " << TIMER_SEC(loading_data) << " seconds";
 
+    // The updates are always applied to the weights of the .ebg file, so the nodes updated by
+    // the last run but not by this one get their original weights back and are dirty as well.
+    std::vector<NodeID> dirty_nodes;
+    bool incremental = config.incremental;
+    if (incremental && !boost::filesystem::exists(config.cell_updates_path))
+    {
+        util::Log(logWARNING) << "The updates of the last customization are unknown, "
+                                 "customizing all cells";
+        incremental = false;
+    }
+    else if (incremental)
+    {
+        std::vector<NodeID> previous_updated_nodes;
+        files::readUpdatedNodes(config.cell_updates_path, previous_updated_nodes);
+        std::set_union(previous_updated_nodes.begin(),
+                       previous_updated_nodes.end(),
+                       updated_nodes.begin(),
+                       updated_nodes.end(),
+                       std::back_inserter(dirty_nodes));
+    }
+
     TIMER_START(cell_customize);
     CellCustomizer customizer(mlp);
-    customizer.Customize(*edge_based_graph, storage);
+    if (incremental)
+    {
+        const auto number_of_cells = customizer.Customize(*edge_based_graph, storage, dirty_nodes);
+        util::Log() << "Recomputed " << number_of_cells << " cells affected by "
+                    << dirty_nodes.size() << " nodes updated by this or the last run";
+    }
+    else
+    {
+        customizer.Customize(*edge_based_graph, storage);
+    }
     TIMER_STOP(cell_customize);
     util::Log() << "Cells customization took " << TIMER_SEC(cell_customize) << " seconds";
 
     TIMER_START(writing_mld_data);
+    // an interrupted write must not leave the updates of the last run next to the new cells
+    boost::filesystem::remove(config.cell_updates_path);
     partition::files::writeCells(config.mld_storage_path, storage);
+    files::writeUpdatedNodes(config.cell_updates_path, updated_nodes);
     TIMER_STOP(writing_mld_data);
     util::Log() << "MLD customization writing took " << TIMER_SEC(writing_mld_data) << " seconds";
 
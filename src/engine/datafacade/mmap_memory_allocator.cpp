@@ -0,0 +1,178 @@
+#include "engine/datafacade/mmap_memory_allocator.hpp"
+#include "storage/storage.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/fingerprint.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include "boost/assert.hpp"
+
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+namespace
+{
+// The image starts with a fingerprint followed by the layout and the memory block
+const constexpr std::size_t LAYOUT_OFFSET = sizeof(util::FingerPrint);
+const constexpr std::size_t MEMORY_OFFSET = LAYOUT_OFFSET + sizeof(storage::DataLayout);
+
+static_assert(LAYOUT_OFFSET % alignof(storage::DataLayout) == 0,
+              "DataLayout in the memory image is not aligned");
+
+std::time_t lastInputChange(const storage::StorageConfig &config)
+{
+    const std::vector<boost::filesystem::path> inputs = {config.ram_index_path,
+                                                         config.file_index_path,
+                                                         config.hsgr_data_path,
+                                                         config.node_based_nodes_data_path,
+                                                         config.edge_based_nodes_data_path,
+                                                         config.edges_data_path,
+                                                         config.core_data_path,
+                                                         config.geometries_path,
+                                                         config.timestamp_path,
+                                                         config.turn_weight_penalties_path,
+                                                         config.turn_duration_penalties_path,
+                                                         config.datasource_names_path,
+                                                         config.names_data_path,
+                                                         config.properties_path,
+                                                         config.intersection_class_path,
+                                                         config.turn_lane_data_path,
+                                                         config.turn_lane_description_path,
+                                                         config.mld_partition_path,
+                                                         config.mld_storage_path,
+                                                         config.mld_graph_path};
+
+    std::time_t last_change = 0;
+    for (const auto &path : inputs)
+    {
+        if (!path.empty() && boost::filesystem::exists(path))
+        {
+            last_change = std::max(last_change, boost::filesystem::last_write_time(path));
+        }
+    }
+    return last_change;
+}
+
+bool isImageUsable(const storage::StorageConfig &config)
+{
+    const auto &image_path = config.memory_image_path;
+    if (!boost::filesystem::exists(image_path))
+        return false;
+
+    // timestamps only have a resolution of seconds, so an image written in the same second
+    // as one of the files might miss changes made afterwards
+    if (boost::filesystem::last_write_time(image_path) <= lastInputChange(config))
+    {
+        util::Log() << "Memory image " << image_path.string() << " is outdated";
+        return false;
+    }
+
+    const auto image_size = boost::filesystem::file_size(image_path);
+    if (image_size < MEMORY_OFFSET)
+        return false;
+
+    boost::iostreams::mapped_file_source header(image_path.string(), MEMORY_OFFSET);
+    util::FingerPrint fingerprint;
+    std::memcpy(&fingerprint, header.data(), sizeof(fingerprint));
+    if (!fingerprint.IsValid() || !fingerprint.IsDataCompatible(util::FingerPrint::GetValid()))
+    {
+        util::Log() << "Memory image " << image_path.string()
+                    << " was created by an incompatible version";
+        return false;
+    }
+
+    storage::DataLayout layout;
+    std::memcpy(&layout, header.data() + LAYOUT_OFFSET, sizeof(layout));
+    const bool is_compressed = layout.num_entries[storage::DataLayout::GEOMETRIES_PACKED_WORDS] > 0;
+    if (is_compressed != config.compress_geometry)
+    {
+        util::Log() << "Memory image " << image_path.string()
+                    << " uses a different geometry compression";
+        return false;
+    }
+    return image_size == MEMORY_OFFSET + layout.GetSizeOfLayout();
+}
+
+// Loads the data into a temporary file that replaces the image once it is complete, so
+// concurrently starting processes never map a partially written image.
+void createImage(const storage::StorageConfig &config)
+{
+    TIMER_START(create_image);
+
+    storage::Storage storage(config);
+    storage::DataLayout layout;
+    storage.PopulateLayout(layout);
+
+    const auto &image_path = config.memory_image_path;
+    const auto temporary_path =
+        boost::filesystem::unique_path(image_path.string() + ".%%%%-%%%%.tmp");
+    try
+    {
+        boost::iostreams::mapped_file_params params(temporary_path.string());
+        params.flags = boost::iostreams::mapped_file::readwrite;
+        params.new_file_size = MEMORY_OFFSET + layout.GetSizeOfLayout();
+
+        boost::iostreams::mapped_file image(params);
+        const auto fingerprint = util::FingerPrint::GetValid();
+        std::memcpy(image.data(), &fingerprint, sizeof(fingerprint));
+        std::memcpy(image.data() + LAYOUT_OFFSET, &layout, sizeof(layout));
+        storage.PopulateData(layout, image.data() + MEMORY_OFFSET);
+        image.close();
+
+        boost::filesystem::rename(temporary_path, image_path);
+    }
+    catch (const std::exception &exc)
+    {
+        boost::system::error_code ignored;
+        boost::filesystem::remove(temporary_path, ignored);
+        throw util::exception("Could not create memory image " + image_path.string() + ": " +
+                              exc.what() + SOURCE_REF);
+    }
+
+    TIMER_STOP(create_image);
+    util::Log() << "Created memory image " << image_path.string() << " in "
+                << TIMER_SEC(create_image) << " seconds";
+}
+}
+
+MMapMemoryAllocator::MMapMemoryAllocator(const storage::StorageConfig &config)
+{
+    if (!isImageUsable(config))
+    {
+        createImage(config);
+    }
+
+    mapped_memory.open(config.memory_image_path.string());
+    util::Log(logDEBUG) << "Mapped memory image " << config.memory_image_path.string();
+}
+
+MMapMemoryAllocator::~MMapMemoryAllocator() {}
+
+storage::DataLayout &MMapMemoryAllocator::GetLayout()
+{
+    // the mapping is read-only, the layout is never modified by the facades
+    return *reinterpret_cast<storage::DataLayout *>(const_cast<char *>(mapped_memory.data()) +
+                                                    LAYOUT_OFFSET);
+}
+
+char *MMapMemoryAllocator::GetMemory()
+{
+    return const_cast<char *>(mapped_memory.data()) + MEMORY_OFFSET;
+}
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
@@ -0,0 +1,66 @@
+#include "engine/datafacade/numa_replica_allocator.hpp"
+
+#include "util/log.hpp"
+#include "util/numa.hpp"
+#include "util/timing_util.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace osrm
+{
+namespace engine
+{
+namespace datafacade
+{
+
+NumaReplicaAllocator::NumaReplicaAllocator(std::shared_ptr<ContiguousBlockAllocator> source_,
+                                           const unsigned node)
+    : source(std::move(source_)), metric_layout(source->GetMetricLayout().GetSegmentLayout(true))
+{
+    TIMER_START(replicate);
+
+    // The memory is not touched before it is bound, so all of its pages end up on the node
+    const std::size_t page_size = boost::interprocess::mapped_region::get_page_size();
+    const auto size = metric_layout.GetSizeOfLayout();
+    metric_memory.reset(new char[size + page_size]);
+    const auto address = reinterpret_cast<std::uintptr_t>(metric_memory.get());
+    aligned_metric_memory = metric_memory.get() + (page_size - address % page_size) % page_size;
+    const auto bound_size = (size + page_size - 1) / page_size * page_size;
+    util::numa::bindMemoryToNode(aligned_metric_memory, bound_size, node);
+
+    auto &source_layout = source->GetMetricLayout();
+    char *source_memory = source->GetMetricMemory();
+    for (auto i = 0; i < storage::DataLayout::NUM_BLOCKS; i++)
+    {
+        const auto bid = static_cast<storage::DataLayout::BlockID>(i);
+        const auto block_size = metric_layout.GetBlockSize(bid);
+        if (!storage::DataLayout::IsMetricBlock(bid))
+            continue;
+
+        BOOST_ASSERT(source_layout.GetBlockSize(bid) == block_size);
+        const auto *source_block =
+            static_cast<const char *>(source_layout.GetAlignedBlockPtr(source_memory, bid));
+        auto *block = metric_layout.GetBlockPtr<char, true>(aligned_metric_memory, bid);
+        std::copy(source_block, source_block + block_size, block);
+    }
+
+    TIMER_STOP(replicate);
+    util::Log() << "Replicated " << (size >> 20) << " MiB of metric data to NUMA node " << node
+                << " in " << TIMER_MSEC(replicate) << "ms";
+}
+
+NumaReplicaAllocator::~NumaReplicaAllocator() {}
+
+storage::DataLayout &NumaReplicaAllocator::GetLayout() { return source->GetLayout(); }
+char *NumaReplicaAllocator::GetMemory() { return source->GetMemory(); }
+
+storage::DataLayout &NumaReplicaAllocator::GetMetricLayout() { return metric_layout; }
+char *NumaReplicaAllocator::GetMetricMemory() { return aligned_metric_memory; }
+
+} // namespace datafacade
+} // namespace engine
+} // namespace osrm
@@ -10,12 +10,16 @@ namespace engine
 namespace datafacade
 {
 
-SharedMemoryAllocator::SharedMemoryAllocator(storage::SharedDataType data_region)
+SharedMemoryAllocator::SharedMemoryAllocator(storage::SharedDataType data_region,
+                                             storage::SharedDataType metric_region)
 {
-    util::Log(logDEBUG) << "Loading new data for region " << regionToString(data_region);
+    util::Log(logDEBUG) << "Loading new data for region " << regionToString(data_region)
+                        << " with metric region " << regionToString(metric_region);
 
     BOOST_ASSERT(storage::SharedMemory::RegionExists(data_region));
+    BOOST_ASSERT(storage::SharedMemory::RegionExists(metric_region));
     m_large_memory = storage::makeSharedMemory(data_region);
+    m_metric_memory = storage::makeSharedMemory(metric_region);
 }
 
 SharedMemoryAllocator::~SharedMemoryAllocator() {}
@@ -29,6 +33,15 @@ char *SharedMemoryAllocator::GetMemory()
     return reinterpret_cast<char *>(m_large_memory->Ptr()) + sizeof(storage::DataLayout);
 }
 
+storage::DataLayout &SharedMemoryAllocator::GetMetricLayout()
+{
+    return *reinterpret_cast<storage::DataLayout *>(m_metric_memory->Ptr());
+}
+char *SharedMemoryAllocator::GetMetricMemory()
+{
+    return reinterpret_cast<char *>(m_metric_memory->Ptr()) + sizeof(storage::DataLayout);
+}
+
 } // namespace datafacade
 } // namespace engine
 } // namespace osrm
@@ -17,7 +17,10 @@ namespace engine
 namespace plugins
 {
 
-NearestPlugin::NearestPlugin(const int max_results_) : max_results{max_results_} {}
+NearestPlugin::NearestPlugin(const int max_results_, ResultCache *result_cache_)
+    : max_results{max_results_}, result_cache{result_cache_}
+{
+}
 
 Status
 NearestPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
@@ -44,18 +47,28 @@ NearestPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacad
         return Error("InvalidOptions", "Only one input coordinate is supported", json_result);
     }
 
-    auto phantom_nodes = GetPhantomNodes(facade, params, params.number_of_results);
+    // Snapping is most of the work of a nearest request, so it is keyed on its input
+    ResultCacheKey key;
+    key.Add(params.coordinates.front())
+        .Add(params.hints)
+        .Add(params)
+        .Add(params.number_of_results);
 
-    if (phantom_nodes.front().size() == 0)
-    {
-        return Error("NoSegment", "Could not find a matching segments for coordinate", json_result);
-    }
-    BOOST_ASSERT(phantom_nodes.front().size() > 0);
+    return cachedResponse(result_cache, std::move(key), json_result, [&]() -> Status {
+        auto phantom_nodes = GetPhantomNodes(facade, params, params.number_of_results);
+
+        if (phantom_nodes.front().size() == 0)
+        {
+            return Error(
+                "NoSegment", "Could not find a matching segments for coordinate", json_result);
+        }
+        BOOST_ASSERT(phantom_nodes.front().size() > 0);
 
-    api::NearestAPI nearest_api(facade, params);
-    nearest_api.MakeResponse(phantom_nodes, json_result);
+        api::NearestAPI nearest_api(facade, params);
+        nearest_api.MakeResponse(phantom_nodes, json_result);
 
-    return Status::Ok;
+        return Status::Ok;
+    });
 }
 }
 }
@@ -4,7 +4,9 @@
 #include "engine/api/table_parameters.hpp"
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/search_engine_data.hpp"
+#include "util/binary_writer.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
 #include "util/string_util.hpp"
 
 #include <cstdlib>
@@ -23,8 +25,11 @@ namespace engine
 namespace plugins
 {
 
-TablePlugin::TablePlugin(const int max_locations_distance_table)
-    : max_locations_distance_table(max_locations_distance_table)
+TablePlugin::TablePlugin(const int max_locations_distance_table,
+                         const int max_threads,
+                         ResultCache *result_cache)
+    : max_locations_distance_table(max_locations_distance_table), max_threads(max_threads),
+      result_cache(result_cache)
 {
 }
 
@@ -32,6 +37,32 @@ Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
                                   const RoutingAlgorithmsInterface &algorithms,
                                   const api::TableParameters &params,
                                   util::json::Object &result) const
+{
+    return HandleRequestImpl(facade, algorithms, params, result);
+}
+
+Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                                  const RoutingAlgorithmsInterface &algorithms,
+                                  const api::TableParameters &params,
+                                  util::json::Writer &result) const
+{
+    return HandleRequestImpl(facade, algorithms, params, result);
+}
+
+Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                                  const RoutingAlgorithmsInterface &algorithms,
+                                  const api::TableParameters &params,
+                                  util::binary::Writer &result) const
+{
+    return HandleRequestImpl(facade, algorithms, params, result);
+}
+
+template <typename ResultT>
+Status
+TablePlugin::HandleRequestImpl(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
+                               const RoutingAlgorithmsInterface &algorithms,
+                               const api::TableParameters &params,
+                               ResultT &result) const
 {
     if (!algorithms.HasManyToManySearch())
     {
@@ -67,7 +98,7 @@ Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
         return Error("TooBig", "Too many table coordinates", result);
     }
 
-    auto phantom_nodes = GetPhantomNodes(facade, params);
+    auto phantom_nodes = GetPhantomNodes(facade, params, max_threads);
 
     if (phantom_nodes.size() != params.coordinates.size())
     {
@@ -78,18 +109,28 @@ Status TablePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryData
     }
 
     auto snapped_phantoms = SnapPhantomNodes(phantom_nodes);
-    auto result_table =
-        algorithms.ManyToManySearch(snapped_phantoms, params.sources, params.destinations);
 
-    if (result_table.empty())
+    ResultCacheKey key;
+    for (const auto &phantom : snapped_phantoms)
     {
-        return Error("NoTable", "No table found", result);
+        key.Add(phantom, params.generate_hints);
     }
+    key.Add(params).Add(params.sources).Add(params.destinations);
+
+    return cachedResponse(result_cache, std::move(key), result, [&]() -> Status {
+        auto result_table =
+            algorithms.ManyToManySearch(snapped_phantoms, params.sources, params.destinations);
+
+        if (result_table.empty())
+        {
+            return Error("NoTable", "No table found", result);
+        }
 
-    api::TableAPI table_api{facade, params};
-    table_api.MakeResponse(result_table, snapped_phantoms, result);
+        api::TableAPI table_api{facade, params};
+        table_api.MakeResponse(result_table, snapped_phantoms, result);
 
-    return Status::Ok;
+        return Status::Ok;
+    });
 }
 }
 }
@@ -0,0 +1,148 @@
+#include "engine/result_cache.hpp"
+
+#include "util/metrics.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace osrm
+{
+namespace engine
+{
+
+ResultCache::ResultCache(const std::size_t max_entries, const std::size_t num_shards)
+    : max_entries_per_shard(std::max<std::size_t>(1, max_entries / num_shards)), generation(0)
+{
+    BOOST_ASSERT(num_shards > 0);
+    shards.resize(num_shards);
+    for (auto &shard : shards)
+    {
+        shard.reset(new Shard());
+    }
+}
+
+ResultCache::Shard &ResultCache::GetShard(const std::string &key)
+{
+    return *shards[std::hash<std::string>{}(key) % shards.size()];
+}
+
+std::shared_ptr<const ResultCache::Entry> ResultCache::Get(const std::string &key)
+{
+    auto &shard = GetShard(key);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+
+    const auto found = shard.index.find(key);
+    if (found == shard.index.end())
+    {
+        lock.unlock();
+        util::metrics::countCacheMiss();
+        return nullptr;
+    }
+
+    shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+    auto entry = found->second->entry;
+    lock.unlock();
+
+    util::metrics::countCacheHit();
+    return entry;
+}
+
+void ResultCache::Put(std::string key,
+                      std::shared_ptr<const Entry> entry,
+                      const std::uint64_t entry_generation)
+{
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Invalidate() increments the generation before it clears the shards, so checking it while
+    // holding the lock never adds a stale entry after the shard was cleared
+    if (generation.load(std::memory_order_acquire) != entry_generation)
+        return;
+
+    const auto found = shard.index.find(key);
+    if (found != shard.index.end())
+    {
+        // a concurrent request with the same key computed it first
+        shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+        return;
+    }
+
+    if (shard.entries.size() >= max_entries_per_shard)
+    {
+        shard.index.erase(shard.entries.back().key);
+        shard.entries.pop_back();
+    }
+
+    shard.entries.push_front(CachedEntry{key, std::move(entry)});
+    shard.index.emplace(std::move(key), shard.entries.begin());
+    BOOST_ASSERT(shard.index.size() == shard.entries.size());
+}
+
+void ResultCache::Invalidate()
+{
+    generation.fetch_add(1, std::memory_order_acq_rel);
+    for (auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->index.clear();
+        shard->entries.clear();
+    }
+}
+
+std::size_t ResultCache::Size() const
+{
+    std::size_t size = 0;
+    for (const auto &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        size += shard->entries.size();
+    }
+    return size;
+}
+
+ResultCacheKey &ResultCacheKey::Add(const util::Coordinate coordinate)
+{
+    return Add(static_cast<std::int32_t>(coordinate.lon))
+        .Add(static_cast<std::int32_t>(coordinate.lat));
+}
+
+ResultCacheKey &ResultCacheKey::Add(const Bearing bearing)
+{
+    return Add(bearing.bearing).Add(bearing.range);
+}
+
+ResultCacheKey &ResultCacheKey::Add(const Hint &hint)
+{
+    return Add(hint.phantom, true).Add(hint.data_checksum);
+}
+
+ResultCacheKey &ResultCacheKey::Add(const PhantomNode &phantom, const bool with_input_location)
+{
+    // field by field, the padding of the bit fields is not initialized
+    Add(phantom.forward_segment_id.id).Add(phantom.forward_segment_id.enabled);
+    Add(phantom.reverse_segment_id.id).Add(phantom.reverse_segment_id.enabled);
+    Add(phantom.forward_weight).Add(phantom.reverse_weight);
+    Add(phantom.forward_weight_offset).Add(phantom.reverse_weight_offset);
+    Add(phantom.forward_duration).Add(phantom.reverse_duration);
+    Add(phantom.forward_duration_offset).Add(phantom.reverse_duration_offset);
+    Add(phantom.component.id).Add(phantom.component.is_tiny);
+    Add(phantom.location);
+    if (with_input_location)
+        Add(phantom.input_location);
+    Add(phantom.fwd_segment_position);
+    Add(phantom.IsValidForwardSource()).Add(phantom.IsValidForwardTarget());
+    Add(phantom.IsValidReverseSource()).Add(phantom.IsValidReverseTarget());
+    return *this;
+}
+
+ResultCacheKey &ResultCacheKey::Add(const api::BaseParameters &parameters)
+{
+    return Add(parameters.radiuses)
+        .Add(parameters.bearings)
+        .Add(parameters.approaches)
+        .Add(parameters.generate_hints);
+}
+}
+}
@@ -2,15 +2,13 @@
 #include "engine/routing_algorithms/routing_base_ch.hpp"
 
 #include "util/integer_range.hpp"
+#include "util/metrics.hpp"
 
 #include <boost/assert.hpp>
 
 #include <algorithm>
 #include <iterator>
 #include <memory>
-#include <unordered_map>
-#include <unordered_set>
-
 #include <vector>
 
 namespace osrm
@@ -56,13 +54,14 @@ void alternativeRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade
                             NodeID *middle_node,
                             EdgeWeight *upper_bound_to_shortest_path_weight,
                             std::vector<NodeID> &search_space_intersection,
-                            std::vector<SearchSpaceEdge> &search_space,
+                            std::vector<NodeID> &search_space,
                             const EdgeWeight min_edge_offset)
 {
     QueryHeap &forward_heap = DIRECTION == FORWARD_DIRECTION ? heap1 : heap2;
     QueryHeap &reverse_heap = DIRECTION == FORWARD_DIRECTION ? heap2 : heap1;
 
     const NodeID node = forward_heap.DeleteMin();
+    util::metrics::countSettledNode();
     const EdgeWeight weight = forward_heap.GetKey(node);
 
     const auto scaled_weight =
@@ -74,7 +73,7 @@ void alternativeRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade
         return;
     }
 
-    search_space.emplace_back(forward_heap.GetData(node).parent, node);
+    search_space.push_back(node);
 
     if (reverse_heap.WasInserted(node))
     {
@@ -130,25 +129,6 @@ void alternativeRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade
     }
 }
 
-void retrievePackedAlternatePath(const QueryHeap &forward_heap1,
-                                 const QueryHeap &reverse_heap1,
-                                 const QueryHeap &forward_heap2,
-                                 const QueryHeap &reverse_heap2,
-                                 const NodeID s_v_middle,
-                                 const NodeID v_t_middle,
-                                 std::vector<NodeID> &packed_path)
-{
-    // fetch packed path [s,v)
-    std::vector<NodeID> packed_v_t_path;
-    ch::retrievePackedPathFromHeap(forward_heap1, reverse_heap2, s_v_middle, packed_path);
-    packed_path.pop_back(); // remove middle node. It's in both half-paths
-
-    // fetch patched path [v,t]
-    ch::retrievePackedPathFromHeap(forward_heap2, reverse_heap1, v_t_middle, packed_v_t_path);
-
-    packed_path.insert(packed_path.end(), packed_v_t_path.begin(), packed_v_t_path.end());
-}
-
 // TODO: reorder parameters
 // compute and unpack <s,..,v> and <v,..,t> by exploring search spaces
 // from v and intersecting against queues. only half-searches have to be
@@ -319,7 +299,6 @@ void computeWeightAndSharingOfViaPath(
 
 // conduct T-Test
 bool viaNodeCandidatePassesTTest(
-    SearchEngineData<Algorithm> &engine_working_data,
     const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
     QueryHeap &existing_forward_heap,
     QueryHeap &existing_reverse_heap,
@@ -328,8 +307,7 @@ bool viaNodeCandidatePassesTTest(
     const RankedCandidateNode &candidate,
     const EdgeWeight weight_of_shortest_path,
     EdgeWeight *weight_of_via_path,
-    NodeID *s_v_middle,
-    NodeID *v_t_middle,
+    std::vector<NodeID> &packed_via_path,
     const EdgeWeight min_edge_offset)
 {
     new_forward_heap.Clear();
@@ -337,7 +315,7 @@ bool viaNodeCandidatePassesTTest(
     std::vector<NodeID> packed_s_v_path;
     std::vector<NodeID> packed_v_t_path;
 
-    *s_v_middle = SPECIAL_NODEID;
+    NodeID s_v_middle = SPECIAL_NODEID;
     EdgeWeight upper_bound_s_v_path_weight = INVALID_EDGE_WEIGHT;
     // compute path <s,..,v> by reusing forward search from s
     new_reverse_heap.Insert(candidate.node, 0, candidate.node);
@@ -346,7 +324,7 @@ bool viaNodeCandidatePassesTTest(
         ch::routingStep<REVERSE_DIRECTION>(facade,
                                            new_reverse_heap,
                                            existing_forward_heap,
-                                           *s_v_middle,
+                                           s_v_middle,
                                            upper_bound_s_v_path_weight,
                                            min_edge_offset,
                                            DO_NOT_FORCE_LOOPS,
@@ -359,7 +337,7 @@ bool viaNodeCandidatePassesTTest(
     }
 
     // compute path <v,..,t> by reusing backward search from t
-    *v_t_middle = SPECIAL_NODEID;
+    NodeID v_t_middle = SPECIAL_NODEID;
     EdgeWeight upper_bound_of_v_t_path_weight = INVALID_EDGE_WEIGHT;
     new_forward_heap.Insert(candidate.node, 0, candidate.node);
     while (new_forward_heap.Size() > 0)
@@ -367,7 +345,7 @@ bool viaNodeCandidatePassesTTest(
         ch::routingStep<FORWARD_DIRECTION>(facade,
                                            new_forward_heap,
                                            existing_reverse_heap,
-                                           *v_t_middle,
+                                           v_t_middle,
                                            upper_bound_of_v_t_path_weight,
                                            min_edge_offset,
                                            DO_NOT_FORCE_LOOPS,
@@ -383,12 +361,12 @@ bool viaNodeCandidatePassesTTest(
 
     // retrieve packed paths
     ch::retrievePackedPathFromHeap(
-        existing_forward_heap, new_reverse_heap, *s_v_middle, packed_s_v_path);
+        existing_forward_heap, new_reverse_heap, s_v_middle, packed_s_v_path);
 
     ch::retrievePackedPathFromHeap(
-        new_forward_heap, existing_reverse_heap, *v_t_middle, packed_v_t_path);
+        new_forward_heap, existing_reverse_heap, v_t_middle, packed_v_t_path);
 
-    NodeID s_P = *s_v_middle, t_P = *v_t_middle;
+    NodeID s_P = s_v_middle, t_P = v_t_middle;
     if (SPECIAL_NODEID == s_P)
     {
         return false;
@@ -522,35 +500,40 @@ bool viaNodeCandidatePassesTTest(
     }
 
     t_test_path_weight += unpacked_until_weight;
-    // Run actual T-Test query and compare if weight equal.
-    engine_working_data.InitializeOrClearThirdThreadLocalStorage(facade.GetNumberOfNodes());
 
-    QueryHeap &forward_heap3 = *engine_working_data.forward_heap_3;
-    QueryHeap &reverse_heap3 = *engine_working_data.reverse_heap_3;
+    // the via path <s,..,v,..,t>, v is in both half-paths
+    packed_via_path = std::move(packed_s_v_path);
+    packed_via_path.pop_back();
+    packed_via_path.insert(packed_via_path.end(), packed_v_t_path.begin(), packed_v_t_path.end());
+
+    // Run actual T-Test query and compare if weight equal. The half-paths are retrieved, so the
+    // heaps of the half-searches are free again.
+    new_forward_heap.Clear();
+    new_reverse_heap.Clear();
     EdgeWeight upper_bound = INVALID_EDGE_WEIGHT;
     NodeID middle = SPECIAL_NODEID;
 
-    forward_heap3.Insert(s_P, 0, s_P);
-    reverse_heap3.Insert(t_P, 0, t_P);
+    new_forward_heap.Insert(s_P, 0, s_P);
+    new_reverse_heap.Insert(t_P, 0, t_P);
     // exploration from s and t until deletemin/(1+epsilon) > _lengt_oO_sShortest_path
-    while ((forward_heap3.Size() + reverse_heap3.Size()) > 0)
+    while ((new_forward_heap.Size() + new_reverse_heap.Size()) > 0)
     {
-        if (!forward_heap3.Empty())
+        if (!new_forward_heap.Empty())
         {
             ch::routingStep<FORWARD_DIRECTION>(facade,
-                                               forward_heap3,
-                                               reverse_heap3,
+                                               new_forward_heap,
+                                               new_reverse_heap,
                                                middle,
                                                upper_bound,
                                                min_edge_offset,
                                                DO_NOT_FORCE_LOOPS,
                                                DO_NOT_FORCE_LOOPS);
         }
-        if (!reverse_heap3.Empty())
+        if (!new_reverse_heap.Empty())
         {
             ch::routingStep<REVERSE_DIRECTION>(facade,
-                                               reverse_heap3,
-                                               forward_heap3,
+                                               new_reverse_heap,
+                                               new_forward_heap,
                                                middle,
                                                upper_bound,
                                                min_edge_offset,
@@ -575,13 +558,12 @@ alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
 
     std::vector<NodeID> alternative_path;
     std::vector<NodeID> via_node_candidate_list;
-    std::vector<SearchSpaceEdge> forward_search_space;
-    std::vector<SearchSpaceEdge> reverse_search_space;
+    std::vector<NodeID> forward_search_space;
+    std::vector<NodeID> reverse_search_space;
 
     // Init queues, semi-expensive because access to TSS invokes a sys-call
     engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
     engine_working_data.InitializeOrClearSecondThreadLocalStorage(facade.GetNumberOfNodes());
-    engine_working_data.InitializeOrClearThirdThreadLocalStorage(facade.GetNumberOfNodes());
 
     auto &forward_heap1 = *engine_working_data.forward_heap_1;
     auto &reverse_heap1 = *engine_working_data.reverse_heap_1;
@@ -655,74 +637,40 @@ alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
         ch::retrievePackedPathFromSingleHeap(reverse_heap1, middle_node, packed_reverse_path);
     }
 
-    // this set is is used as an indicator if a node is on the shortest path
-    std::unordered_set<NodeID> nodes_in_path(packed_forward_path.size() +
-                                             packed_reverse_path.size());
-    nodes_in_path.insert(packed_forward_path.begin(), packed_forward_path.end());
-    nodes_in_path.insert(middle_node);
-    nodes_in_path.insert(packed_reverse_path.begin(), packed_reverse_path.end());
-
-    std::unordered_map<NodeID, EdgeWeight> approximated_forward_sharing;
-    std::unordered_map<NodeID, EdgeWeight> approximated_reverse_sharing;
-
-    // sweep over search space, compute forward sharing for each current edge (u,v)
-    for (const SearchSpaceEdge &current_edge : forward_search_space)
-    {
-        const NodeID u = current_edge.first;
-        const NodeID v = current_edge.second;
-
-        if (nodes_in_path.find(v) != nodes_in_path.end())
+    // sorted nodes of the shortest path, an indicator if a node is on the shortest path
+    std::vector<NodeID> nodes_in_path(packed_forward_path);
+    nodes_in_path.push_back(middle_node);
+    nodes_in_path.insert(
+        nodes_in_path.end(), packed_reverse_path.begin(), packed_reverse_path.end());
+    std::sort(nodes_in_path.begin(), nodes_in_path.end());
+    const auto is_in_path = [&nodes_in_path](const NodeID node) {
+        return std::binary_search(nodes_in_path.begin(), nodes_in_path.end(), node);
+    };
+
+    // Sweep over the search spaces in the order the nodes were settled, so the sharing of the
+    // parent is known. The sharing of a node is the weight of the shortest path up to where the
+    // path to the node leaves it. Nodes that were not settled keep a sharing of 0.
+    const auto compute_sharing = [&is_in_path](QueryHeap &heap,
+                                               const std::vector<NodeID> &search_space) {
+        for (const NodeID node : search_space)
         {
-            // current_edge is on shortest path => sharing(v):=queue.GetKey(v);
-            approximated_forward_sharing.emplace(v, forward_heap1.GetKey(v));
-        }
-        else
-        {
-            // current edge is not on shortest path. Check if we know a value for the other
-            // endpoint
-            const auto sharing_of_u_iterator = approximated_forward_sharing.find(u);
-            if (sharing_of_u_iterator != approximated_forward_sharing.end())
-            {
-                approximated_forward_sharing.emplace(v, sharing_of_u_iterator->second);
-            }
+            auto &data = heap.GetData(node);
+            data.sharing =
+                is_in_path(node) ? heap.GetKey(node) : heap.GetData(data.parent).sharing;
         }
-    }
-
-    // sweep over search space, compute backward sharing
-    for (const SearchSpaceEdge &current_edge : reverse_search_space)
-    {
-        const NodeID u = current_edge.first;
-        const NodeID v = current_edge.second;
-        if (nodes_in_path.find(v) != nodes_in_path.end())
-        {
-            // current_edge is on shortest path => sharing(u):=queue.GetKey(u);
-            approximated_reverse_sharing.emplace(v, reverse_heap1.GetKey(v));
-        }
-        else
-        {
-            // current edge is not on shortest path. Check if we know a value for the other
-            // endpoint
-            const auto sharing_of_u_iterator = approximated_reverse_sharing.find(u);
-            if (sharing_of_u_iterator != approximated_reverse_sharing.end())
-            {
-                approximated_reverse_sharing.emplace(v, sharing_of_u_iterator->second);
-            }
-        }
-    }
+    };
+    compute_sharing(forward_heap1, forward_search_space);
+    compute_sharing(reverse_heap1, reverse_search_space);
 
     std::vector<NodeID> preselected_node_list;
     for (const NodeID node : via_node_candidate_list)
     {
         if (node == middle_node)
             continue;
-        const auto fwd_iterator = approximated_forward_sharing.find(node);
-        const EdgeWeight fwd_sharing =
-            (fwd_iterator != approximated_forward_sharing.end()) ? fwd_iterator->second : 0;
-        const auto rev_iterator = approximated_reverse_sharing.find(node);
-        const EdgeWeight rev_sharing =
-            (rev_iterator != approximated_reverse_sharing.end()) ? rev_iterator->second : 0;
-
-        const EdgeWeight approximated_sharing = fwd_sharing + rev_sharing;
+
+        // the candidates were reached by both searches
+        const EdgeWeight approximated_sharing =
+            forward_heap1.GetData(node).sharing + reverse_heap1.GetData(node).sharing;
         const EdgeWeight approximated_weight =
             forward_heap1.GetKey(node) + reverse_heap1.GetKey(node);
         const bool weight_passes =
@@ -772,11 +720,10 @@ alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
 
     NodeID selected_via_node = SPECIAL_NODEID;
     EdgeWeight weight_of_via_path = INVALID_EDGE_WEIGHT;
-    NodeID s_v_middle = SPECIAL_NODEID, v_t_middle = SPECIAL_NODEID;
+    std::vector<NodeID> packed_alternate_path;
     for (const RankedCandidateNode &candidate : ranked_candidates_list)
     {
-        if (viaNodeCandidatePassesTTest(engine_working_data,
-                                        facade,
+        if (viaNodeCandidatePassesTTest(facade,
                                         forward_heap1,
                                         reverse_heap1,
                                         forward_heap2,
@@ -784,8 +731,7 @@ alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
                                         candidate,
                                         upper_bound_to_shortest_path_weight,
                                         &weight_of_via_path,
-                                        &s_v_middle,
-                                        &v_t_middle,
+                                        packed_alternate_path,
                                         min_edge_offset))
         {
             // select first admissable
@@ -818,16 +764,6 @@ alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
 
     if (SPECIAL_NODEID != selected_via_node)
     {
-        std::vector<NodeID> packed_alternate_path;
-        // retrieve alternate path
-        retrievePackedAlternatePath(forward_heap1,
-                                    reverse_heap1,
-                                    forward_heap2,
-                                    reverse_heap2,
-                                    s_v_middle,
-                                    v_t_middle,
-                                    packed_alternate_path);
-
         secondary_route.unpacked_path_segments.resize(1);
         secondary_route.source_traversed_in_reverse.push_back(
             (packed_alternate_path.front() !=
@@ -0,0 +1,363 @@
+#include "engine/routing_algorithms/alternative_path.hpp"
+#include "engine/routing_algorithms/routing_base_mld.hpp"
+
+#include "util/metrics.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace routing_algorithms
+{
+namespace mld
+{
+
+namespace
+{
+const double constexpr VIAPATH_ALPHA = 0.25;   // alternative has a plateau of 25% of the shortest
+const double constexpr VIAPATH_EPSILON = 0.15; // alternative at most 15% longer
+const double constexpr VIAPATH_GAMMA = 0.75;   // alternative shares at most 75% with the shortest.
+const std::size_t constexpr MAX_UNPACKED_VIA_PATHS = 10; // candidates checked after unpacking
+
+using QueryHeap = SearchEngineData<Algorithm>::QueryHeap;
+
+struct ViaNodeCandidate
+{
+    NodeID node;
+    EdgeWeight weight;
+    EdgeWeight sharing;
+    // all via nodes on the same plateau have the same via path
+    NodeID plateau_begin;
+    NodeID plateau_end;
+
+    bool operator<(const ViaNodeCandidate &other) const
+    {
+        return (2 * weight + sharing) < (2 * other.weight + other.sharing);
+    }
+};
+
+// Continues the bidirectional search of the shortest path until no path via a node reached by
+// both searches can be within the stretch bound and have a plateau of the minimal length, and
+// returns the nodes reached by both. The plateau of a via path is covered by both search trees,
+// so the searches have to overlap by its length. The nodes reached by both are the border nodes
+// of the cells the searches meet in and their overlay edges.
+std::vector<NodeID>
+searchViaNodeCandidates(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                        QueryHeap &forward_heap,
+                        QueryHeap &reverse_heap,
+                        NodeID &middle_node,
+                        EdgeWeight &shortest_path_weight,
+                        const PhantomNodes &phantom_nodes)
+{
+    std::vector<NodeID> candidates;
+
+    const auto may_be_in_stretch = [&shortest_path_weight](const EdgeWeight min_weight) {
+        return shortest_path_weight == INVALID_EDGE_WEIGHT ||
+               min_weight < shortest_path_weight * (1. + VIAPATH_EPSILON + VIAPATH_ALPHA);
+    };
+
+    EdgeWeight forward_heap_min = forward_heap.MinKey();
+    EdgeWeight reverse_heap_min = reverse_heap.MinKey();
+    while (forward_heap.Size() + reverse_heap.Size() > 0 &&
+           may_be_in_stretch(forward_heap_min + reverse_heap_min))
+    {
+        if (!forward_heap.Empty())
+        {
+            const auto node = forward_heap.Min();
+            routingStep<FORWARD_DIRECTION>(facade,
+                                           forward_heap,
+                                           reverse_heap,
+                                           middle_node,
+                                           shortest_path_weight,
+                                           DO_NOT_FORCE_LOOPS,
+                                           DO_NOT_FORCE_LOOPS,
+                                           phantom_nodes);
+            if (reverse_heap.WasInserted(node))
+                candidates.push_back(node);
+            if (!forward_heap.Empty())
+                forward_heap_min = forward_heap.MinKey();
+        }
+        if (!reverse_heap.Empty())
+        {
+            const auto node = reverse_heap.Min();
+            routingStep<REVERSE_DIRECTION>(facade,
+                                           reverse_heap,
+                                           forward_heap,
+                                           middle_node,
+                                           shortest_path_weight,
+                                           DO_NOT_FORCE_LOOPS,
+                                           DO_NOT_FORCE_LOOPS,
+                                           phantom_nodes);
+            if (forward_heap.WasInserted(node))
+                candidates.push_back(node);
+            if (!reverse_heap.Empty())
+                reverse_heap_min = reverse_heap.MinKey();
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    return candidates;
+}
+
+// The plateau of a via node is the part of its via path on which the forward and the reverse
+// search trees agree. Every sub-path of a plateau is a shortest path, so a long plateau makes
+// the via path locally optimal like the T-test of the CH search does.
+void findPlateau(const QueryHeap &forward_heap,
+                 const QueryHeap &reverse_heap,
+                 const NodeID via_node,
+                 NodeID &plateau_begin,
+                 NodeID &plateau_end)
+{
+    plateau_begin = via_node;
+    for (auto parent = forward_heap.GetData(plateau_begin).parent; parent != plateau_begin;
+         parent = forward_heap.GetData(plateau_begin).parent)
+    {
+        if (!reverse_heap.WasInserted(parent) ||
+            reverse_heap.GetData(parent).parent != plateau_begin ||
+            forward_heap.GetKey(plateau_begin) - forward_heap.GetKey(parent) !=
+                reverse_heap.GetKey(parent) - reverse_heap.GetKey(plateau_begin))
+            break;
+        plateau_begin = parent;
+    }
+
+    plateau_end = via_node;
+    for (auto parent = reverse_heap.GetData(plateau_end).parent; parent != plateau_end;
+         parent = reverse_heap.GetData(plateau_end).parent)
+    {
+        if (!forward_heap.WasInserted(parent) ||
+            forward_heap.GetData(parent).parent != plateau_end ||
+            reverse_heap.GetKey(plateau_end) - reverse_heap.GetKey(parent) !=
+                forward_heap.GetKey(parent) - forward_heap.GetKey(plateau_end))
+            break;
+        plateau_end = parent;
+    }
+}
+
+// Approximates the weight a via path shares with the shortest path by the weight from the
+// source (target) to the first node of the shortest path on the forward (reverse) search tree.
+EdgeWeight approximateSharing(const QueryHeap &forward_heap,
+                              const QueryHeap &reverse_heap,
+                              const std::vector<NodeID> &sorted_shortest_path_nodes,
+                              const NodeID via_node)
+{
+    const auto shared_weight = [&sorted_shortest_path_nodes](const QueryHeap &heap, NodeID node) {
+        while (!std::binary_search(
+            sorted_shortest_path_nodes.begin(), sorted_shortest_path_nodes.end(), node))
+        {
+            const auto parent = heap.GetData(node).parent;
+            if (parent == node)
+                return 0;
+            node = parent;
+        }
+        return std::max(heap.GetKey(node), 0);
+    };
+
+    return shared_weight(forward_heap, via_node) + shared_weight(reverse_heap, via_node);
+}
+
+// The weight of the edges of a path that are on the shortest path
+EdgeWeight
+computeSharing(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+               const std::vector<EdgeID> &sorted_shortest_path_edges,
+               const std::vector<EdgeID> &unpacked_edges)
+{
+    EdgeWeight sharing = 0;
+    for (const auto edge : unpacked_edges)
+    {
+        if (std::binary_search(
+                sorted_shortest_path_edges.begin(), sorted_shortest_path_edges.end(), edge))
+        {
+            sharing += facade.GetEdgeData(edge).weight;
+        }
+    }
+    return sharing;
+}
+
+bool isSimplePath(std::vector<NodeID> nodes)
+{
+    // loops start and end at the same node
+    if (nodes.size() > 1 && nodes.front() == nodes.back())
+        nodes.pop_back();
+    std::sort(nodes.begin(), nodes.end());
+    return std::adjacent_find(nodes.begin(), nodes.end()) == nodes.end();
+}
+}
+
+// Via-node alternatives on the overlay graph: the search of the shortest path continues until
+// no path via a node reached by both searches can be within the stretch bound and have a long
+// enough plateau. The via paths are approximated on the search trees and ranked like in the CH
+// search, local optimality is checked with the plateau of the trees instead of the T-test. Only
+// the best ranked candidates are unpacked to check their exact sharing with the shortest path.
+InternalManyRoutesResult
+alternativePathSearch(SearchEngineData<Algorithm> &engine_working_data,
+                      const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                      const PhantomNodes &phantom_node_pair)
+{
+    engine_working_data.InitializeOrClearFirstThreadLocalStorage(facade.GetNumberOfNodes());
+    engine_working_data.InitializeOrClearSecondThreadLocalStorage(facade.GetNumberOfNodes());
+
+    auto &forward_heap = *engine_working_data.forward_heap_1;
+    auto &reverse_heap = *engine_working_data.reverse_heap_1;
+    // the overlay edges are unpacked with the second heaps, the first ones keep the trees
+    auto &unpacking_forward_heap = *engine_working_data.forward_heap_2;
+    auto &unpacking_reverse_heap = *engine_working_data.reverse_heap_2;
+
+    insertNodesInHeaps(forward_heap, reverse_heap, phantom_node_pair);
+    if (forward_heap.Empty() || reverse_heap.Empty())
+    {
+        return InternalManyRoutesResult{
+            extractRoute(facade, INVALID_EDGE_WEIGHT, phantom_node_pair, {}, {})};
+    }
+
+    NodeID middle_node = SPECIAL_NODEID;
+    EdgeWeight shortest_path_weight = INVALID_EDGE_WEIGHT;
+    const auto via_node_candidates = searchViaNodeCandidates(facade,
+                                                             forward_heap,
+                                                             reverse_heap,
+                                                             middle_node,
+                                                             shortest_path_weight,
+                                                             phantom_node_pair);
+
+    if (SPECIAL_NODEID == middle_node)
+    {
+        return InternalManyRoutesResult{
+            extractRoute(facade, INVALID_EDGE_WEIGHT, phantom_node_pair, {}, {})};
+    }
+
+    const auto unpack = [&](const NodeID via_node,
+                            std::vector<NodeID> &unpacked_nodes,
+                            std::vector<EdgeID> &unpacked_edges) {
+        const auto packed_path = retrievePackedPathFromHeap(forward_heap, reverse_heap, via_node);
+        const auto source_node =
+            packed_path.empty() ? via_node : std::get<0>(packed_path.front());
+        unpackPath(engine_working_data,
+                   facade,
+                   unpacking_forward_heap,
+                   unpacking_reverse_heap,
+                   DO_NOT_FORCE_LOOPS,
+                   DO_NOT_FORCE_LOOPS,
+                   source_node,
+                   packed_path,
+                   unpacked_nodes,
+                   unpacked_edges,
+                   phantom_node_pair);
+    };
+
+    std::vector<NodeID> shortest_path_nodes;
+    std::vector<EdgeID> shortest_path_edges;
+    unpack(middle_node, shortest_path_nodes, shortest_path_edges);
+
+    std::vector<NodeID> sorted_shortest_path_nodes{middle_node};
+    for (const auto &edge : retrievePackedPathFromHeap(forward_heap, reverse_heap, middle_node))
+    {
+        sorted_shortest_path_nodes.push_back(std::get<0>(edge));
+        sorted_shortest_path_nodes.push_back(std::get<1>(edge));
+    }
+    std::sort(sorted_shortest_path_nodes.begin(), sorted_shortest_path_nodes.end());
+    sorted_shortest_path_nodes.erase(
+        std::unique(sorted_shortest_path_nodes.begin(), sorted_shortest_path_nodes.end()),
+        sorted_shortest_path_nodes.end());
+
+    const auto maximal_weight = shortest_path_weight * (1. + VIAPATH_EPSILON);
+    const auto maximal_sharing = shortest_path_weight * VIAPATH_GAMMA;
+    const auto minimal_plateau = shortest_path_weight * VIAPATH_ALPHA;
+    const auto passes_stretch = [&](const EdgeWeight weight, const EdgeWeight sharing) {
+        return weight <= maximal_weight && sharing <= maximal_sharing &&
+               (weight - sharing) < (1. + VIAPATH_EPSILON) * (shortest_path_weight - sharing);
+    };
+
+    std::vector<ViaNodeCandidate> ranked_candidates;
+    for (const auto node : via_node_candidates)
+    {
+        if (std::binary_search(
+                sorted_shortest_path_nodes.begin(), sorted_shortest_path_nodes.end(), node))
+            continue;
+
+        const EdgeWeight weight = forward_heap.GetKey(node) + reverse_heap.GetKey(node);
+        // paths with a negative weight start and end on the same segment in the wrong order
+        if (weight < shortest_path_weight)
+            continue;
+
+        const auto sharing =
+            approximateSharing(forward_heap, reverse_heap, sorted_shortest_path_nodes, node);
+        if (!passes_stretch(weight, sharing))
+            continue;
+
+        NodeID plateau_begin, plateau_end;
+        findPlateau(forward_heap, reverse_heap, node, plateau_begin, plateau_end);
+        const auto plateau_weight =
+            forward_heap.GetKey(plateau_end) - forward_heap.GetKey(plateau_begin);
+        if (plateau_weight < minimal_plateau)
+            continue;
+
+        ranked_candidates.push_back({node, weight, sharing, plateau_begin, plateau_end});
+    }
+
+    // one candidate per plateau, they all describe the same via path
+    const auto by_plateau = [](const ViaNodeCandidate &lhs, const ViaNodeCandidate &rhs) {
+        return std::tie(lhs.plateau_begin, lhs.plateau_end) <
+               std::tie(rhs.plateau_begin, rhs.plateau_end);
+    };
+    std::sort(ranked_candidates.begin(), ranked_candidates.end(), by_plateau);
+    ranked_candidates.erase(std::unique(ranked_candidates.begin(),
+                                        ranked_candidates.end(),
+                                        [](const auto &lhs, const auto &rhs) {
+                                            return lhs.plateau_begin == rhs.plateau_begin &&
+                                                   lhs.plateau_end == rhs.plateau_end;
+                                        }),
+                            ranked_candidates.end());
+
+    // unpacking is expensive, only the best ranked via paths are checked exactly
+    const auto number_of_checked_candidates =
+        std::min(ranked_candidates.size(), MAX_UNPACKED_VIA_PATHS);
+    std::partial_sort(ranked_candidates.begin(),
+                      ranked_candidates.begin() + number_of_checked_candidates,
+                      ranked_candidates.end());
+    ranked_candidates.resize(number_of_checked_candidates);
+
+    std::vector<EdgeID> sorted_shortest_path_edges = shortest_path_edges;
+    std::sort(sorted_shortest_path_edges.begin(), sorted_shortest_path_edges.end());
+
+    EdgeWeight alternative_path_weight = INVALID_EDGE_WEIGHT;
+    std::vector<NodeID> alternative_path_nodes;
+    std::vector<EdgeID> alternative_path_edges;
+    for (const auto &candidate : ranked_candidates)
+    {
+        unpack(candidate.node, alternative_path_nodes, alternative_path_edges);
+
+        const auto sharing =
+            computeSharing(facade, sorted_shortest_path_edges, alternative_path_edges);
+        if (passes_stretch(candidate.weight, sharing) && isSimplePath(alternative_path_nodes))
+        {
+            // select first admissable
+            alternative_path_weight = candidate.weight;
+            break;
+        }
+    }
+
+    util::metrics::StageScope unpacking(util::metrics::Stage::Unpacking);
+    auto primary_route = extractRoute(
+        facade, shortest_path_weight, phantom_node_pair, shortest_path_nodes, shortest_path_edges);
+    auto secondary_route = extractRoute(facade,
+                                        alternative_path_weight,
+                                        phantom_node_pair,
+                                        alternative_path_nodes,
+                                        alternative_path_edges);
+    BOOST_ASSERT(alternative_path_weight != INVALID_EDGE_WEIGHT ||
+                 secondary_route.shortest_path_weight == INVALID_EDGE_WEIGHT);
+
+    return InternalManyRoutesResult{{std::move(primary_route), std::move(secondary_route)}};
+}
+
+} // namespace mld
+} // namespace routing_algorithms
+} // namespace engine
+} // namespace osrm
@@ -1,11 +1,22 @@
 #include "engine/routing_algorithms/many_to_many.hpp"
 #include "engine/routing_algorithms/routing_base_ch.hpp"
 
+#include "util/metrics.hpp"
+
 #include <boost/assert.hpp>
+#include <boost/range/iterator_range_core.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
 
+#include <algorithm>
+#include <atomic>
 #include <limits>
 #include <memory>
-#include <unordered_map>
+#include <tuple>
 #include <vector>
 
 namespace osrm
@@ -19,17 +30,44 @@ namespace
 {
 struct NodeBucket
 {
-    unsigned target_id; // essentially a row in the weight matrix
+    NodeID middle_node;
+    unsigned column_index; // a column in the weight/duration matrix
     EdgeWeight weight;
     EdgeWeight duration;
-    NodeBucket(const unsigned target_id, const EdgeWeight weight, const EdgeWeight duration)
-        : target_id(target_id), weight(weight), duration(duration)
+
+    NodeBucket(const NodeID middle_node,
+               const unsigned column_index,
+               const EdgeWeight weight,
+               const EdgeWeight duration)
+        : middle_node(middle_node), column_index(column_index), weight(weight),
+          duration(duration)
+    {
+    }
+
+    // partial order comparison
+    bool operator<(const NodeBucket &rhs) const
     {
+        return std::tie(middle_node, column_index) < std::tie(rhs.middle_node, rhs.column_index);
     }
+
+    // functor for equal_range
+    struct Compare
+    {
+        bool operator()(const NodeBucket &lhs, const NodeID &rhs) const
+        {
+            return lhs.middle_node < rhs;
+        }
+
+        bool operator()(const NodeID &lhs, const NodeBucket &rhs) const
+        {
+            return lhs < rhs.middle_node;
+        }
+    };
 };
 
-// FIXME This should be replaced by an std::unordered_multimap, though this needs benchmarking
-using SearchSpaceWithBuckets = std::unordered_map<NodeID, std::vector<NodeBucket>>;
+// Buckets of all backward searches in one flat array. It is sorted by middle node
+// once all backward searches are done, so the forward searches can binary search it.
+using SearchSpaceWithBuckets = std::vector<NodeBucket>;
 
 inline bool
 addLoopWeight(const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
@@ -228,43 +266,42 @@ void forwardRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade<Alg
                         const PhantomNode &phantom_node)
 {
     const NodeID node = query_heap.DeleteMin();
+    util::metrics::countSettledNode();
     const EdgeWeight source_weight = query_heap.GetKey(node);
     const EdgeWeight source_duration = query_heap.GetData(node).duration;
 
     // check if each encountered node has an entry
-    const auto bucket_iterator = search_space_with_buckets.find(node);
-    // iterate bucket if there exists one
-    if (bucket_iterator != search_space_with_buckets.end())
+    const auto bucket_list = std::equal_range(search_space_with_buckets.begin(),
+                                              search_space_with_buckets.end(),
+                                              node,
+                                              NodeBucket::Compare());
+    for (const auto &current_bucket : boost::make_iterator_range(bucket_list))
     {
-        const std::vector<NodeBucket> &bucket_list = bucket_iterator->second;
-        for (const NodeBucket &current_bucket : bucket_list)
-        {
-            // get target id from bucket entry
-            const unsigned column_idx = current_bucket.target_id;
-            const EdgeWeight target_weight = current_bucket.weight;
-            const EdgeWeight target_duration = current_bucket.duration;
+        // get target id from bucket entry
+        const auto column_idx = current_bucket.column_index;
+        const EdgeWeight target_weight = current_bucket.weight;
+        const EdgeWeight target_duration = current_bucket.duration;
 
-            auto &current_weight = weights_table[row_idx * number_of_targets + column_idx];
-            auto &current_duration = durations_table[row_idx * number_of_targets + column_idx];
+        auto &current_weight = weights_table[row_idx * number_of_targets + column_idx];
+        auto &current_duration = durations_table[row_idx * number_of_targets + column_idx];
 
-            // check if new weight is better
-            auto new_weight = source_weight + target_weight;
-            auto new_duration = source_duration + target_duration;
+        // check if new weight is better
+        auto new_weight = source_weight + target_weight;
+        auto new_duration = source_duration + target_duration;
 
-            if (new_weight < 0)
-            {
-                if (addLoopWeight(facade, node, new_weight, new_duration))
-                {
-                    current_weight = std::min(current_weight, new_weight);
-                    current_duration = std::min(current_duration, new_duration);
-                }
-            }
-            else if (new_weight < current_weight)
+        if (new_weight < 0)
+        {
+            if (addLoopWeight(facade, node, new_weight, new_duration))
             {
-                current_weight = new_weight;
-                current_duration = new_duration;
+                current_weight = std::min(current_weight, new_weight);
+                current_duration = std::min(current_duration, new_duration);
             }
         }
+        else if (new_weight < current_weight)
+        {
+            current_weight = new_weight;
+            current_duration = new_duration;
+        }
     }
 
     relaxOutgoingEdges<FORWARD_DIRECTION>(
@@ -279,11 +316,12 @@ void backwardRoutingStep(const datafacade::ContiguousInternalMemoryDataFacade<Al
                          const PhantomNode &phantom_node)
 {
     const NodeID node = query_heap.DeleteMin();
+    util::metrics::countSettledNode();
     const EdgeWeight target_weight = query_heap.GetKey(node);
     const EdgeWeight target_duration = query_heap.GetData(node).duration;
 
     // store settled nodes in search space bucket
-    search_space_with_buckets[node].emplace_back(column_idx, target_weight, target_duration);
+    search_space_with_buckets.emplace_back(node, column_idx, target_weight, target_duration);
 
     relaxOutgoingEdges<REVERSE_DIRECTION>(
         facade, node, target_weight, target_duration, query_heap, phantom_node);
@@ -307,78 +345,113 @@ manyToManySearch(SearchEngineData<Algorithm> &engine_working_data,
     std::vector<EdgeWeight> weights_table(number_of_entries, INVALID_EDGE_WEIGHT);
     std::vector<EdgeWeight> durations_table(number_of_entries, MAXIMAL_EDGE_DURATION);
 
-    engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(facade.GetNumberOfNodes());
+    const auto source_phantom = [&](const std::size_t row_idx) -> const PhantomNode & {
+        return source_indices.empty() ? phantom_nodes[row_idx]
+                                      : phantom_nodes[source_indices[row_idx]];
+    };
+    const auto target_phantom = [&](const std::size_t column_idx) -> const PhantomNode & {
+        return target_indices.empty() ? phantom_nodes[column_idx]
+                                      : phantom_nodes[target_indices[column_idx]];
+    };
 
-    auto &query_heap = *(engine_working_data.many_to_many_heap);
+    // The heaps are thread-local, so every worker uses its own heap
+    const auto search_target_phantoms = [&](const tbb::blocked_range<std::size_t> &columns,
+                                            SearchSpaceWithBuckets &buckets) {
+        engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+            facade.GetNumberOfNodes());
+        auto &query_heap = *(engine_working_data.many_to_many_heap);
 
-    SearchSpaceWithBuckets search_space_with_buckets;
+        for (auto column_idx = columns.begin(); column_idx != columns.end(); ++column_idx)
+        {
+            const auto &phantom = target_phantom(column_idx);
 
-    unsigned column_idx = 0;
-    const auto search_target_phantom = [&](const PhantomNode &phantom) {
-        // clear heap and insert target nodes
-        query_heap.Clear();
-        insertTargetInHeap(query_heap, phantom);
+            // clear heap and insert target nodes
+            query_heap.Clear();
+            insertTargetInHeap(query_heap, phantom);
 
-        // explore search space
-        while (!query_heap.Empty())
-        {
-            backwardRoutingStep(facade, column_idx, query_heap, search_space_with_buckets, phantom);
+            // explore search space
+            while (!query_heap.Empty())
+            {
+                backwardRoutingStep(facade, column_idx, query_heap, buckets, phantom);
+            }
         }
-        ++column_idx;
     };
 
-    // for each source do forward search
-    unsigned row_idx = 0;
-    const auto search_source_phantom = [&](const PhantomNode &phantom) {
-        // clear heap and insert source nodes
-        query_heap.Clear();
-        insertSourceInHeap(query_heap, phantom);
+    // Every forward search only writes to its own row of the tables
+    const auto search_source_phantoms = [&](const tbb::blocked_range<std::size_t> &rows,
+                                            const SearchSpaceWithBuckets &buckets) {
+        engine_working_data.InitializeOrClearManyToManyThreadLocalStorage(
+            facade.GetNumberOfNodes());
+        auto &query_heap = *(engine_working_data.many_to_many_heap);
 
-        // explore search space
-        while (!query_heap.Empty())
+        for (auto row_idx = rows.begin(); row_idx != rows.end(); ++row_idx)
         {
-            forwardRoutingStep(facade,
-                               row_idx,
-                               number_of_targets,
-                               query_heap,
-                               search_space_with_buckets,
-                               weights_table,
-                               durations_table,
-                               phantom);
+            const auto &phantom = source_phantom(row_idx);
+
+            // clear heap and insert source nodes
+            query_heap.Clear();
+            insertSourceInHeap(query_heap, phantom);
+
+            // explore search space
+            while (!query_heap.Empty())
+            {
+                forwardRoutingStep(facade,
+                                   row_idx,
+                                   number_of_targets,
+                                   query_heap,
+                                   buckets,
+                                   weights_table,
+                                   durations_table,
+                                   phantom);
+            }
         }
-        ++row_idx;
     };
 
-    if (target_indices.empty())
+    SearchSpaceWithBuckets search_space_with_buckets;
+    const tbb::blocked_range<std::size_t> all_columns(0, number_of_targets);
+    const tbb::blocked_range<std::size_t> all_rows(0, number_of_sources);
+
+    if (engine_working_data.max_many_to_many_threads == 1)
     {
-        for (const auto &phantom : phantom_nodes)
-        {
-            search_target_phantom(phantom);
-        }
+        search_target_phantoms(all_columns, search_space_with_buckets);
+        std::sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+        search_source_phantoms(all_rows, search_space_with_buckets);
     }
     else
     {
-        for (const auto index : target_indices)
+        tbb::task_arena arena(engine_working_data.max_many_to_many_threads);
+        // nodes settled by the workers are counted for the thread running the request
+        std::atomic<std::uint64_t> settled_nodes{0};
+
+        // every worker collects the buckets of its backward searches in its own vector
+        tbb::enumerable_thread_specific<SearchSpaceWithBuckets> worker_buckets;
+        arena.execute([&] {
+            tbb::parallel_for(all_columns, [&](const tbb::blocked_range<std::size_t> &columns) {
+                settled_nodes += util::metrics::takeSettledNodes(
+                    [&] { search_target_phantoms(columns, worker_buckets.local()); });
+            });
+        });
+
+        std::size_t number_of_buckets = 0;
+        for (const auto &buckets : worker_buckets)
         {
-            const auto &phantom = phantom_nodes[index];
-            search_target_phantom(phantom);
+            number_of_buckets += buckets.size();
         }
-    }
-
-    if (source_indices.empty())
-    {
-        for (const auto &phantom : phantom_nodes)
+        search_space_with_buckets.reserve(number_of_buckets);
+        for (const auto &buckets : worker_buckets)
         {
-            search_source_phantom(phantom);
-        }
-    }
-    else
-    {
-        for (const auto index : source_indices)
-        {
-            const auto &phantom = phantom_nodes[index];
-            search_source_phantom(phantom);
+            search_space_with_buckets.insert(
+                search_space_with_buckets.end(), buckets.begin(), buckets.end());
         }
+
+        arena.execute([&] {
+            tbb::parallel_sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+            tbb::parallel_for(all_rows, [&](const tbb::blocked_range<std::size_t> &rows) {
+                settled_nodes += util::metrics::takeSettledNodes(
+                    [&] { search_source_phantoms(rows, search_space_with_buckets); });
+            });
+        });
+        util::metrics::addSettledNodes(settled_nodes);
     }
 
     return durations_table;
@@ -2,6 +2,8 @@
 #include "engine/routing_algorithms/routing_base_ch.hpp"
 #include "engine/routing_algorithms/routing_base_mld.hpp"
 
+#include "util/metrics.hpp"
+
 #include <boost/assert.hpp>
 #include <boost/optional.hpp>
 #include <memory>
@@ -185,6 +187,7 @@ void unpackLegs(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
                 const EdgeWeight shortest_path_weight,
                 InternalRouteResult &raw_route_data)
 {
+    util::metrics::StageScope unpacking(util::metrics::Stage::Unpacking);
     raw_route_data.unpacked_path_segments.resize(packed_leg_begin.size() - 1);
 
     raw_route_data.shortest_path_weight = shortest_path_weight;
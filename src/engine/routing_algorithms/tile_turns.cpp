@@ -101,8 +101,6 @@ std::vector<TurnData> generateTurns(const datafacade &facade,
     //         w
     //  uv is the "approach"
     //  vw is the "exit"
-    std::vector<EdgeWeight> approach_weight_vector;
-    std::vector<EdgeWeight> approach_duration_vector;
 
     // Look at every node in the directed graph we created
     for (const auto &startnode : sorted_startnodes)
@@ -148,31 +146,26 @@ std::vector<TurnData> generateTurns(const datafacade &facade,
                     const auto &data = facade.GetEdgeData(edge_based_edge_id);
 
                     // Now, calculate the sum of the weight of all the segments.
-                    if (edge_based_node_info.find(approachedge.edge_based_node_id)
-                            ->second.is_geometry_forward)
+                    const auto &approach_info =
+                        edge_based_node_info.find(approachedge.edge_based_node_id)->second;
+                    const auto sum = [](const auto &range) {
+                        return std::accumulate(range.begin(), range.end(), EdgeWeight{0});
+                    };
+                    EdgeWeight sum_node_weight, sum_node_duration;
+                    if (approach_info.is_geometry_forward)
                     {
-                        approach_weight_vector = facade.GetUncompressedForwardWeights(
-                            edge_based_node_info.find(approachedge.edge_based_node_id)
-                                ->second.packed_geometry_id);
-                        approach_duration_vector = facade.GetUncompressedForwardDurations(
-                            edge_based_node_info.find(approachedge.edge_based_node_id)
-                                ->second.packed_geometry_id);
+                        sum_node_weight = sum(
+                            facade.GetUncompressedForwardWeights(approach_info.packed_geometry_id));
+                        sum_node_duration = sum(facade.GetUncompressedForwardDurations(
+                            approach_info.packed_geometry_id));
                     }
                     else
                     {
-                        approach_weight_vector = facade.GetUncompressedReverseWeights(
-                            edge_based_node_info.find(approachedge.edge_based_node_id)
-                                ->second.packed_geometry_id);
-                        approach_duration_vector = facade.GetUncompressedReverseDurations(
-                            edge_based_node_info.find(approachedge.edge_based_node_id)
-                                ->second.packed_geometry_id);
+                        sum_node_weight = sum(
+                            facade.GetUncompressedReverseWeights(approach_info.packed_geometry_id));
+                        sum_node_duration = sum(facade.GetUncompressedReverseDurations(
+                            approach_info.packed_geometry_id));
                     }
-                    const auto sum_node_weight = std::accumulate(approach_weight_vector.begin(),
-                                                                 approach_weight_vector.end(),
-                                                                 EdgeWeight{0});
-                    const auto sum_node_duration = std::accumulate(approach_duration_vector.begin(),
-                                                                   approach_duration_vector.end(),
-                                                                   EdgeWeight{0});
 
                     // The edge.weight is the whole edge weight, which includes the turn
                     // cost.
@@ -5,128 +5,75 @@ namespace osrm
 namespace engine
 {
 
+namespace
+{
+// The heap index is sized by the number of nodes, so heaps are re-created if the
+// dataset changed (e.g. after a shared memory update) instead of just being cleared.
+template <typename HeapPtr>
+void initializeOrClearHeap(HeapPtr &heap,
+                           const unsigned number_of_nodes,
+                           const std::size_t max_heap_index_memory)
+{
+    using Heap = typename HeapPtr::element_type;
+    if (heap.get() && heap->Capacity() == number_of_nodes)
+    {
+        heap->Clear();
+    }
+    else
+    {
+        heap.reset(new Heap(number_of_nodes, max_heap_index_memory));
+    }
+}
+}
+
 // CH heaps
 using CH = routing_algorithms::ch::Algorithm;
 SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_1;
 SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_1;
 SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_2;
 SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_2;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::forward_heap_3;
-SearchEngineData<CH>::SearchEngineHeapPtr SearchEngineData<CH>::reverse_heap_3;
 SearchEngineData<CH>::ManyToManyHeapPtr SearchEngineData<CH>::many_to_many_heap;
 
 void SearchEngineData<CH>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
-    {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
-
-    if (reverse_heap_1.get())
-    {
-        reverse_heap_1->Clear();
-    }
-    else
-    {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
+    initializeOrClearHeap(forward_heap_1, number_of_nodes, max_heap_index_memory);
+    initializeOrClearHeap(reverse_heap_1, number_of_nodes, max_heap_index_memory);
 }
 
 void SearchEngineData<CH>::InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (forward_heap_2.get())
-    {
-        forward_heap_2->Clear();
-    }
-    else
-    {
-        forward_heap_2.reset(new QueryHeap(number_of_nodes));
-    }
-
-    if (reverse_heap_2.get())
-    {
-        reverse_heap_2->Clear();
-    }
-    else
-    {
-        reverse_heap_2.reset(new QueryHeap(number_of_nodes));
-    }
-}
-
-void SearchEngineData<CH>::InitializeOrClearThirdThreadLocalStorage(unsigned number_of_nodes)
-{
-    if (forward_heap_3.get())
-    {
-        forward_heap_3->Clear();
-    }
-    else
-    {
-        forward_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
-
-    if (reverse_heap_3.get())
-    {
-        reverse_heap_3->Clear();
-    }
-    else
-    {
-        reverse_heap_3.reset(new QueryHeap(number_of_nodes));
-    }
+    initializeOrClearHeap(forward_heap_2, number_of_nodes, max_heap_index_memory);
+    initializeOrClearHeap(reverse_heap_2, number_of_nodes, max_heap_index_memory);
 }
 
 void SearchEngineData<CH>::InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (many_to_many_heap.get())
-    {
-        many_to_many_heap->Clear();
-    }
-    else
-    {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes));
-    }
+    initializeOrClearHeap(many_to_many_heap, number_of_nodes, max_heap_index_memory);
 }
 
 // MLD
 using MLD = routing_algorithms::mld::Algorithm;
 SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::forward_heap_1;
 SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::reverse_heap_1;
+SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::forward_heap_2;
+SearchEngineData<MLD>::SearchEngineHeapPtr SearchEngineData<MLD>::reverse_heap_2;
 SearchEngineData<MLD>::ManyToManyHeapPtr SearchEngineData<MLD>::many_to_many_heap;
 
 void SearchEngineData<MLD>::InitializeOrClearFirstThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (forward_heap_1.get())
-    {
-        forward_heap_1->Clear();
-    }
-    else
-    {
-        forward_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
+    initializeOrClearHeap(forward_heap_1, number_of_nodes, max_heap_index_memory);
+    initializeOrClearHeap(reverse_heap_1, number_of_nodes, max_heap_index_memory);
+}
 
-    if (reverse_heap_1.get())
-    {
-        reverse_heap_1->Clear();
-    }
-    else
-    {
-        reverse_heap_1.reset(new QueryHeap(number_of_nodes));
-    }
+void SearchEngineData<MLD>::InitializeOrClearSecondThreadLocalStorage(unsigned number_of_nodes)
+{
+    initializeOrClearHeap(forward_heap_2, number_of_nodes, max_heap_index_memory);
+    initializeOrClearHeap(reverse_heap_2, number_of_nodes, max_heap_index_memory);
 }
 
 void SearchEngineData<MLD>::InitializeOrClearManyToManyThreadLocalStorage(unsigned number_of_nodes)
 {
-    if (many_to_many_heap.get())
-    {
-        many_to_many_heap->Clear();
-    }
-    else
-    {
-        many_to_many_heap.reset(new ManyToManyQueryHeap(number_of_nodes));
-    }
+    initializeOrClearHeap(many_to_many_heap, number_of_nodes, max_heap_index_memory);
 }
 }
 }
@@ -208,7 +208,10 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
 // clang-format on
 NAN_METHOD(Engine::route) //
 {
-    async(info, &argumentsToRouteParameter, &osrm::OSRM::Route, true);
+    // the bindings convert the json::Object result
+    using RouteFn = osrm::Status (osrm::OSRM::*)(const osrm::RouteParameters &,
+                                                 osrm::json::Object &) const;
+    async(info, &argumentsToRouteParameter, static_cast<RouteFn>(&osrm::OSRM::Route), true);
 }
 
 // clang-format off
@@ -294,7 +297,10 @@ NAN_METHOD(Engine::nearest) //
 // clang-format on
 NAN_METHOD(Engine::table) //
 {
-    async(info, &argumentsToTableParameter, &osrm::OSRM::Table, true);
+    // the bindings convert the json::Object result, not the streamed or binary one
+    using TableFn = osrm::Status (osrm::OSRM::*)(const osrm::TableParameters &,
+                                                 osrm::json::Object &) const;
+    async(info, &argumentsToTableParameter, static_cast<TableFn>(&osrm::OSRM::Table), true);
 }
 
 // clang-format off
@@ -18,7 +18,6 @@
 #include "util/integer_range.hpp"
 #include "util/json_container.hpp"
 #include "util/log.hpp"
-#include "util/mmap_file.hpp"
 
 #include <algorithm>
 #include <iterator>
@@ -183,18 +182,7 @@ int Partitioner::Run(const PartitionConfig &config)
     auto permutation = makePermutation(edge_based_graph, partitions);
     renumber(edge_based_graph, permutation);
     renumber(partitions, permutation);
-    {
-        boost::iostreams::mapped_file segment_region;
-        auto segments =
-            util::mmapFile<extractor::EdgeBasedNodeSegment>(config.file_index_path, segment_region);
-        renumber(segments, permutation);
-    }
-    {
-        extractor::EdgeBasedNodeDataContainer node_data;
-        extractor::files::readNodeData(config.node_data_path, node_data);
-        renumber(node_data, permutation);
-        extractor::files::writeNodeData(config.node_data_path, node_data);
-    }
+    extractor::renumberNodeFiles(config.file_index_path, config.node_data_path, permutation);
     if (boost::filesystem::exists(config.hsgr_path))
     {
         util::Log(logWARNING) << "Found existing .osrm.hsgr file, removing. You need to re-run "
@@ -217,6 +205,8 @@ int Partitioner::Run(const PartitionConfig &config)
     TIMER_START(writing_mld_data);
     files::writePartition(config.partition_path, mlp);
     files::writeCells(config.storage_path, storage);
+    // the new cells are not customized, osrm-customize --incremental has to start over
+    boost::filesystem::remove(config.cell_updates_path);
     extractor::files::writeEdgeBasedGraph(config.edge_based_graph_path,
                                           edge_based_graph.GetNumberOfNodes() - 1,
                                           graphToEdges(edge_based_graph));
@@ -1,7 +1,9 @@
 #include "server/connection.hpp"
+#include "server/request_executor.hpp"
 #include "server/request_handler.hpp"
 #include "server/request_parser.hpp"
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/assert.hpp>
 #include <boost/bind.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
@@ -16,16 +18,51 @@ namespace osrm
 namespace server
 {
 
-Connection::Connection(boost::asio::io_service &io_service, RequestHandler &handler)
-    : strand(io_service), TCP_socket(io_service), request_handler(handler)
+namespace
+{
+// HTTP/1.1 connections are persistent unless the client closes them, while
+// HTTP/1.0 connections are only kept open if the client asks for it.
+bool isHTTP11(const http::request &request)
+{
+    return request.http_version_major > 1 ||
+           (request.http_version_major == 1 && request.http_version_minor >= 1);
+}
+
+bool requestsKeepAlive(const http::request &request)
+{
+    if (isHTTP11(request))
+    {
+        return !boost::icontains(request.connection, "close");
+    }
+    return boost::icontains(request.connection, "keep-alive");
+}
+}
+
+Connection::Connection(boost::asio::io_service &io_service,
+                       RequestHandler &handler,
+                       RequestExecutor &executor,
+                       const ConnectionConfig &config)
+    : config(config), strand(io_service), TCP_socket(io_service), timer(io_service),
+      request_handler(handler), request_executor(executor), unparsed_begin(nullptr),
+      unparsed_end(nullptr), processed_requests(0), keep_alive(false)
 {
 }
 
 boost::asio::ip::tcp::socket &Connection::socket() { return TCP_socket; }
 
 /// Start the first asynchronous operation for the connection.
-void Connection::start()
+void Connection::start() { read_request(); }
+
+void Connection::read_request()
 {
+    if (config.keepalive_timeout > 0)
+    {
+        timer.expires_from_now(boost::posix_time::seconds(config.keepalive_timeout));
+        timer.async_wait(strand.wrap(boost::bind(&Connection::handle_timeout,
+                                                 this->shared_from_this(),
+                                                 boost::asio::placeholders::error)));
+    }
+
     TCP_socket.async_read_some(
         boost::asio::buffer(incoming_data_buffer),
         strand.wrap(boost::bind(&Connection::handle_read,
@@ -36,61 +73,75 @@ void Connection::start()
 
 void Connection::handle_read(const boost::system::error_code &error, std::size_t bytes_transferred)
 {
+    // data arrived or the connection is gone, either way the idle timeout does not apply
+    // anymore. A timeout handler that is already queued sees the infinite expiry time.
+    timer.expires_at(boost::posix_time::pos_infin);
+
     if (error)
     {
         return;
     }
 
-    // no error detected, let's parse the request
+    process_data(incoming_data_buffer.data(), incoming_data_buffer.data() + bytes_transferred);
+}
+
+void Connection::handle_timeout(const boost::system::error_code &error)
+{
+    if (error || timer.expires_at() > boost::asio::deadline_timer::traits_type::now())
+    {
+        return;
+    }
+
+    // the client did not send a request in time, the pending read fails after closing
+    boost::system::error_code ignore_error;
+    TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+    TCP_socket.close(ignore_error);
+}
+
+void Connection::process_data(char *begin, char *end)
+{
     http::compression_type compression_type(http::no_compression);
     RequestParser::RequestStatus result;
-    std::tie(result, compression_type) =
-        request_parser.parse(current_request,
-                             incoming_data_buffer.data(),
-                             incoming_data_buffer.data() + bytes_transferred);
+    char *request_end;
+    std::tie(result, compression_type, request_end) =
+        request_parser.parse(current_request, begin, end);
 
     // the request has been parsed
     if (result == RequestParser::RequestStatus::valid)
     {
+        // keep requests pipelined behind this one until its reply is written
+        unparsed_begin = request_end;
+        unparsed_end = end;
+
+        processed_requests++;
+        keep_alive = config.keepalive_timeout > 0 &&
+                     processed_requests < config.keepalive_max_requests &&
+                     requestsKeepAlive(current_request);
+
         current_request.endpoint = TCP_socket.remote_endpoint().address();
-        request_handler.HandleRequest(current_request, current_reply);
 
-        // compress the result w/ gzip/deflate if requested
-        switch (compression_type)
-        {
-        case http::deflate_rfc1951:
-            // use deflate for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "deflate"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::gzip_rfc1952:
-            // use gzip for compression
-            current_reply.headers.insert(current_reply.headers.begin(),
-                                         {"Content-Encoding", "gzip"});
-            compressed_output = compress_buffers(current_reply.content, compression_type);
-            current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = current_reply.headers_to_buffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
-            break;
-        case http::no_compression:
-            // don't use any compression
-            current_reply.set_uncompressed_size();
+        // the query runs on a compute thread, so the I/O threads keep serving other
+        // connections. The reply is written back on the strand of this connection.
+        auto self = this->shared_from_this();
+        const auto accepted =
+            request_executor.Post(current_request.uri, [self, compression_type] {
+                self->handle_request(compression_type);
+                self->strand.post(boost::bind(&Connection::write_reply, self));
+            });
+
+        if (!accepted)
+        { // shed load if too many requests are waiting already
+            current_reply = http::reply::stock_reply(http::reply::service_unavailable);
+            current_reply.headers.emplace_back("Retry-After", "1");
+            current_reply.http_1_1 = isHTTP11(current_request);
+            current_reply.set_keep_alive(keep_alive);
             output_buffer = current_reply.to_buffers();
-            break;
+            write_reply();
         }
-        // write result to stream
-        boost::asio::async_write(TCP_socket,
-                                 output_buffer,
-                                 strand.wrap(boost::bind(&Connection::handle_write,
-                                                         this->shared_from_this(),
-                                                         boost::asio::placeholders::error)));
     }
     else if (result == RequestParser::RequestStatus::invalid)
     { // request is not parseable
+        keep_alive = false;
         current_reply = http::reply::stock_reply(http::reply::bad_request);
 
         boost::asio::async_write(TCP_socket,
@@ -102,24 +153,86 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
     else
     {
         // we don't have a result yet, so continue reading
-        TCP_socket.async_read_some(
-            boost::asio::buffer(incoming_data_buffer),
-            strand.wrap(boost::bind(&Connection::handle_read,
-                                    this->shared_from_this(),
-                                    boost::asio::placeholders::error,
-                                    boost::asio::placeholders::bytes_transferred)));
+        read_request();
+    }
+}
+
+void Connection::handle_request(const http::compression_type compression_type)
+{
+    request_handler.HandleRequest(current_request, current_reply);
+    current_reply.http_1_1 = isHTTP11(current_request);
+    current_reply.set_keep_alive(keep_alive);
+
+    // compress the result w/ gzip/deflate if requested
+    switch (compression_type)
+    {
+    case http::deflate_rfc1951:
+        // use deflate for compression
+        current_reply.headers.insert(current_reply.headers.begin(),
+                                     {"Content-Encoding", "deflate"});
+        compressed_output = compress_buffers(current_reply.content, compression_type);
+        current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
+        output_buffer = current_reply.headers_to_buffers();
+        output_buffer.push_back(boost::asio::buffer(compressed_output));
+        break;
+    case http::gzip_rfc1952:
+        // use gzip for compression
+        current_reply.headers.insert(current_reply.headers.begin(),
+                                     {"Content-Encoding", "gzip"});
+        compressed_output = compress_buffers(current_reply.content, compression_type);
+        current_reply.set_size(static_cast<unsigned>(compressed_output.size()));
+        output_buffer = current_reply.headers_to_buffers();
+        output_buffer.push_back(boost::asio::buffer(compressed_output));
+        break;
+    case http::no_compression:
+        // don't use any compression
+        current_reply.set_uncompressed_size();
+        output_buffer = current_reply.to_buffers();
+        break;
     }
 }
 
+void Connection::write_reply()
+{
+    // write result to stream
+    boost::asio::async_write(TCP_socket,
+                             output_buffer,
+                             strand.wrap(boost::bind(&Connection::handle_write,
+                                                     this->shared_from_this(),
+                                                     boost::asio::placeholders::error)));
+}
+
 /// Handle completion of a write operation.
 void Connection::handle_write(const boost::system::error_code &error)
 {
-    if (!error)
+    if (error)
     {
-        // Initiate graceful connection closure.
-        boost::system::error_code ignore_error;
-        TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+        return;
     }
+
+    if (keep_alive)
+    {
+        request_parser = RequestParser();
+        current_request = http::request();
+        current_reply = http::reply();
+        compressed_output.clear();
+        output_buffer.clear();
+
+        // answer pipelined requests before reading from the socket again
+        if (unparsed_begin != unparsed_end)
+        {
+            process_data(unparsed_begin, unparsed_end);
+        }
+        else
+        {
+            read_request();
+        }
+        return;
+    }
+
+    // Initiate graceful connection closure.
+    boost::system::error_code ignore_error;
+    TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
 }
 
 std::vector<char> Connection::compress_buffers(const std::vector<char> &uncompressed_data,
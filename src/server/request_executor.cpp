@@ -0,0 +1,218 @@
+#include "server/request_executor.hpp"
+
+#include "util/log.hpp"
+#include "util/numa.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <exception>
+
+namespace osrm
+{
+namespace server
+{
+
+RequestExecutor::RequestExecutor(RequestExecutorConfig config_)
+    : config(std::move(config_)), queued_tasks(0), stopped(false)
+{
+    queues[""];
+    for (const auto &service : config.services)
+    {
+        queues[service];
+    }
+    for (const auto &limit : config.max_concurrent_requests)
+    {
+        queues[limit.first].max_running = limit.second;
+    }
+    for (auto &queue : queues)
+    {
+        queue.second.endpoint = util::metrics::endpointFromService(queue.first);
+    }
+
+    const auto num_threads = std::max(1u, config.num_threads);
+    const auto num_nodes = util::numa::getNodeCount();
+    for (unsigned i = 0; i < num_threads; ++i)
+    {
+        if (config.pin_numa_nodes && num_nodes > 1)
+        {
+            threads.emplace_back([this, node = i % num_nodes] {
+                util::numa::pinThreadToNode(node);
+                Work();
+            });
+        }
+        else
+        {
+            threads.emplace_back([this] { Work(); });
+        }
+    }
+}
+
+RequestExecutor::~RequestExecutor() { Stop(); }
+
+bool RequestExecutor::Post(const std::string &uri, Task task)
+{
+    const auto service = ServiceName(uri);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &queue = GetQueue(service);
+        if (stopped ||
+            (config.max_queue_size >= 0 &&
+             queued_tasks >= static_cast<std::size_t>(config.max_queue_size)))
+        {
+            queue.statistics.rejected++;
+            util::metrics::countRejectedRequest(queue.endpoint);
+            return false;
+        }
+
+        queue.tasks.push_back({std::move(task), std::chrono::steady_clock::now()});
+        queued_tasks++;
+        util::metrics::addQueuedRequests(queue.endpoint, 1);
+    }
+    task_available.notify_one();
+    return true;
+}
+
+void RequestExecutor::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+        for (auto &queue : queues)
+        {
+            util::metrics::addQueuedRequests(
+                queue.second.endpoint, -static_cast<std::int64_t>(queue.second.tasks.size()));
+            queue.second.tasks.clear();
+        }
+        queued_tasks = 0;
+    }
+    task_available.notify_all();
+
+    for (auto &thread : threads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+}
+
+std::size_t RequestExecutor::QueueSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queued_tasks;
+}
+
+std::vector<std::pair<std::string, RequestExecutor::Statistics>>
+RequestExecutor::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<std::pair<std::string, Statistics>> statistics;
+    for (const auto &queue : queues)
+    {
+        statistics.emplace_back(queue.first, queue.second.statistics);
+    }
+    std::sort(statistics.begin(), statistics.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first < rhs.first;
+    });
+    return statistics;
+}
+
+std::string RequestExecutor::ServiceName(const std::string &uri)
+{
+    const auto begin = uri.find_first_not_of('/');
+    if (begin == std::string::npos)
+    {
+        return {};
+    }
+    const auto end = uri.find_first_of("/?", begin);
+    return uri.substr(begin, end == std::string::npos ? end : end - begin);
+}
+
+void RequestExecutor::Work()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        ServiceQueues::iterator queue;
+        task_available.wait(lock, [this, &queue] {
+            queue = NextRunnableQueue();
+            return stopped || queue != queues.end();
+        });
+
+        if (stopped)
+        {
+            return;
+        }
+
+        auto &service_queue = queue->second;
+        auto next = std::move(service_queue.tasks.front());
+        service_queue.tasks.pop_front();
+        service_queue.running++;
+        queued_tasks--;
+        util::metrics::addQueuedRequests(service_queue.endpoint, -1);
+
+        const auto wait_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now() - next.enqueued)
+                                 .count();
+        service_queue.statistics.executed++;
+        service_queue.statistics.wait_us.Record(wait_us);
+        util::metrics::recordQueueWait(service_queue.endpoint, wait_us);
+
+        lock.unlock();
+        try
+        {
+            next.task();
+        }
+        catch (const std::exception &e)
+        {
+            util::Log(logWARNING) << "[server error] request execution failed: " << e.what();
+        }
+        lock.lock();
+
+        BOOST_ASSERT(service_queue.running > 0);
+        service_queue.running--;
+        // a task of this service might have been waiting for the concurrency limit
+        if (!service_queue.tasks.empty())
+        {
+            task_available.notify_one();
+        }
+    }
+}
+
+// Picks the queue holding the oldest task among all services below their concurrency limit
+RequestExecutor::ServiceQueues::iterator RequestExecutor::NextRunnableQueue()
+{
+    auto next = queues.end();
+    for (auto queue = queues.begin(); queue != queues.end(); ++queue)
+    {
+        const auto &service_queue = queue->second;
+        if (service_queue.tasks.empty() ||
+            (service_queue.max_running > 0 && service_queue.running >= service_queue.max_running))
+        {
+            continue;
+        }
+
+        if (next == queues.end() ||
+            service_queue.tasks.front().enqueued < next->second.tasks.front().enqueued)
+        {
+            next = queue;
+        }
+    }
+    return next;
+}
+
+// The set of queues is fixed on construction, so arbitrary URIs can not add new queues
+RequestExecutor::ServiceQueue &RequestExecutor::GetQueue(const std::string &service)
+{
+    auto queue = queues.find(service);
+    if (queue == queues.end())
+    {
+        queue = queues.find("");
+    }
+    BOOST_ASSERT(queue != queues.end());
+    return queue->second;
+}
+}
+}
@@ -1,3 +1,4 @@
+#include "server/request_executor.hpp"
 #include "server/request_handler.hpp"
 #include "server/service_handler.hpp"
 
@@ -7,6 +8,7 @@
 
 #include "util/json_renderer.hpp"
 #include "util/log.hpp"
+#include "util/metrics.hpp"
 #include "util/string_util.hpp"
 #include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
@@ -38,6 +40,15 @@ void RequestHandler::RegisterServiceHandler(
     service_handler = std::move(service_handler_);
 }
 
+void RequestHandler::HandleMetricsRequest(http::reply &current_reply)
+{
+    const auto text = util::metrics::renderPrometheus(util::metrics::collect());
+    current_reply.content.assign(text.begin(), text.end());
+    current_reply.headers.emplace_back("Content-Type", "text/plain; version=0.0.4");
+    current_reply.headers.emplace_back("Content-Length",
+                                       std::to_string(current_reply.content.size()));
+}
+
 void RequestHandler::HandleRequest(const http::request &current_request, http::reply &current_reply)
 {
     if (!service_handler)
@@ -58,6 +69,15 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
 
         util::Log(logDEBUG) << "[req][" << tid << "] " << request_string;
 
+        if (request_string == METRICS_PATH)
+        {
+            HandleMetricsRequest(current_reply);
+            return;
+        }
+
+        util::metrics::RequestScope request_metrics(
+            util::metrics::endpointFromService(RequestExecutor::ServiceName(request_string)));
+
         auto api_iterator = request_string.begin();
         auto maybe_parsed_url = api::parseURL(api_iterator, request_string.end());
         ServiceHandler::ResultT result;
@@ -108,8 +128,21 @@ void RequestHandler::HandleRequest(const http::request &current_request, http::r
             current_reply.headers.emplace_back("Content-Disposition",
                                                "inline; filename=\"response.json\"");
 
+            util::metrics::StageScope rendering(util::metrics::Stage::Rendering);
             util::json::render(current_reply.content, result.get<util::json::Object>());
         }
+        else if (result.is<service::EncodedResult>())
+        {
+            auto &encoded_result = result.get<service::EncodedResult>();
+            current_reply.headers.emplace_back("Content-Type", encoded_result.content_type);
+            if (encoded_result.content_type == service::JSON_CONTENT_TYPE)
+            {
+                current_reply.headers.emplace_back("Content-Disposition",
+                                                   "inline; filename=\"response.json\"");
+            }
+
+            current_reply.content = std::move(encoded_result.content);
+        }
         else
         {
             BOOST_ASSERT(result.is<std::string>());
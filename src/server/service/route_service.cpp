@@ -4,6 +4,7 @@
 #include "server/api/parameters_parser.hpp"
 #include "engine/api/route_parameters.hpp"
 
+#include "util/binary_writer.hpp"
 #include "util/json_container.hpp"
 
 namespace osrm
@@ -66,6 +67,21 @@ RouteService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
     }
     BOOST_ASSERT(parameters->IsValid());
 
+    if (parameters->format == engine::api::RouteParameters::OutputFormatType::Binary)
+    {
+        if (parameters->steps || parameters->annotations)
+        {
+            json_result.values["code"] = "InvalidOptions";
+            json_result.values["message"] =
+                "Steps and annotations are not supported by the binary format";
+            return engine::Status::Error;
+        }
+
+        result = EncodedResult{BINARY_CONTENT_TYPE, {}};
+        util::binary::Writer writer(result.get<EncodedResult>().content);
+        return BaseService::routing_machine.Route(*parameters, writer);
+    }
+
     return BaseService::routing_machine.Route(*parameters, json_result);
 }
 }
@@ -3,7 +3,9 @@
 #include "server/api/parameters_parser.hpp"
 #include "engine/api/table_parameters.hpp"
 
+#include "util/binary_writer.hpp"
 #include "util/json_container.hpp"
+#include "util/json_writer.hpp"
 
 #include <boost/format.hpp>
 
@@ -87,7 +89,19 @@ TableService::RunQuery(std::size_t prefix_length, std::string &query, ResultT &r
     }
     BOOST_ASSERT(parameters->IsValid());
 
-    return BaseService::routing_machine.Table(*parameters, json_result);
+    // large tables are encoded while they are written instead of building a json::Object
+    result = EncodedResult();
+    auto &encoded_result = result.get<EncodedResult>();
+    if (parameters->format == engine::api::TableParameters::OutputFormatType::Binary)
+    {
+        encoded_result.content_type = BINARY_CONTENT_TYPE;
+        util::binary::Writer writer(encoded_result.content);
+        return BaseService::routing_machine.Table(*parameters, writer);
+    }
+
+    encoded_result.content_type = JSON_CONTENT_TYPE;
+    util::json::Writer writer(encoded_result.content);
+    return BaseService::routing_machine.Table(*parameters, writer);
 }
 }
 }
@@ -1,6 +1,7 @@
 #include "storage/storage.hpp"
 
 #include "storage/io.hpp"
+#include "storage/serialization.hpp"
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
 #include "storage/shared_memory_ownership.hpp"
@@ -16,6 +17,7 @@
 #include "extractor/files.hpp"
 #include "extractor/guidance/turn_instruction.hpp"
 #include "extractor/original_edge_data.hpp"
+#include "extractor/packed_geometry.hpp"
 #include "extractor/packed_osm_ids.hpp"
 #include "extractor/profile_properties.hpp"
 #include "extractor/query_node.hpp"
@@ -33,23 +35,32 @@
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
 #include "util/log.hpp"
+#include "util/mmap_file.hpp"
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/static_graph.hpp"
 #include "util/static_rtree.hpp"
+#include "util/std_hash.hpp"
+#include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 #include "util/vector_view.hpp"
 
 #ifdef __linux__
+#include <fcntl.h>
 #include <sys/mman.h>
+#include <unistd.h>
 #endif
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 
+#include <tbb/task_group.h>
+
 #include <cstdint>
 
 #include <fstream>
@@ -57,6 +68,7 @@
 #include <iterator>
 #include <new>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -64,15 +76,80 @@ namespace storage
 {
 
 using RTreeLeaf = engine::datafacade::BaseDataFacade::RTreeLeaf;
-using RTreeNode = util::StaticRTree<RTreeLeaf, storage::Ownership::View>::TreeNode;
+using SharedRTree = util::StaticRTree<RTreeLeaf, storage::Ownership::View>;
+using RTreeNode = SharedRTree::TreeNode;
+using RTreeProjectedLeaf = SharedRTree::ProjectedLeaf;
 using QueryGraph = util::StaticGraph<contractor::QueryEdge::EdgeData>;
 using EdgeBasedGraph = util::StaticGraph<extractor::EdgeBasedEdge::EdgeData>;
 
 using Monitor = SharedMonitor<SharedDataTimestamp>;
 
+namespace
+{
+// Runs the loaders of independent files concurrently and reports the progress per file.
+// Only the files of the requested segments are loaded, see DataLayout::IsMetricBlock.
+class ParallelLoader
+{
+  public:
+    ParallelLoader(const bool load_static, const bool load_metric)
+        : load_static(load_static), load_metric(load_metric)
+    {
+    }
+
+    template <typename LoadFn> void LoadStatic(const boost::filesystem::path &path, LoadFn load)
+    {
+        if (load_static)
+            Load(path, std::move(load));
+    }
+
+    template <typename LoadFn> void LoadMetric(const boost::filesystem::path &path, LoadFn load)
+    {
+        if (load_metric)
+            Load(path, std::move(load));
+    }
+
+    // Rethrows the first exception of a loader
+    void Wait() { tasks.wait(); }
+
+  private:
+    template <typename LoadFn> void Load(const boost::filesystem::path &path, LoadFn load)
+    {
+        tasks.run([path, load] {
+            TIMER_START(load_file);
+            const auto size = boost::filesystem::file_size(path);
+            adviseSequentialRead(path);
+            load();
+            TIMER_STOP(load_file);
+            util::Log() << "Loaded " << path.filename().string() << " (" << (size >> 20)
+                        << " MiB) in " << TIMER_MSEC(load_file) << "ms";
+        });
+    }
+
+    // The whole file is read right after this, so let the kernel start reading ahead of the
+    // buffered stream of the io::FileReader
+    static void adviseSequentialRead(const boost::filesystem::path &path)
+    {
+#ifdef __linux__
+        const auto fd = ::open(path.string().c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+            ::close(fd);
+        }
+#else
+        (void)path;
+#endif
+    }
+
+    const bool load_static;
+    const bool load_metric;
+    tbb::task_group tasks;
+};
+}
+
 Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
 
-int Storage::Run(int max_wait)
+int Storage::Run(int max_wait, bool only_metric, bool huge_pages)
 {
     BOOST_ASSERT_MSG(config.IsValid(), "Invalid storage config");
 
@@ -107,39 +184,88 @@ int Storage::Run(int max_wait)
 
     // Get the next region ID and time stamp without locking shared barriers.
     // Because of datastore_lock the only write operation can occur sequentially later.
-    Monitor monitor(SharedDataTimestamp{REGION_NONE, 0});
+    Monitor monitor(SharedDataTimestamp{REGION_NONE, REGION_NONE, 0});
     auto in_use_region = monitor.data().region;
+    auto in_use_metric_region = monitor.data().metric_region;
     auto next_timestamp = monitor.data().timestamp + 1;
     auto next_region =
         in_use_region == REGION_2 || in_use_region == REGION_NONE ? REGION_1 : REGION_2;
-
-    // ensure that the shared memory region we want to write to is really removed
-    // this is only needef for failure recovery because we actually wait for all clients
-    // to detach at the end of the function
-    if (storage::SharedMemory::RegionExists(next_region))
-    {
-        util::Log(logWARNING) << "Old shared memory region " << regionToString(next_region)
-                              << " still exists.";
-        util::UnbufferedLog() << "Retrying removal... ";
-        storage::SharedMemory::Remove(next_region);
-        util::UnbufferedLog() << "ok.";
-    }
-
-    util::Log() << "Loading data into " << regionToString(next_region);
+    auto next_metric_region = in_use_metric_region == METRIC_REGION_2 ||
+                                      in_use_metric_region == REGION_NONE
+                                  ? METRIC_REGION_1
+                                  : METRIC_REGION_2;
 
     // Populate a memory layout into stack memory
     DataLayout layout;
     PopulateLayout(layout);
+    const auto static_layout = layout.GetSegmentLayout(false);
+    const auto metric_layout = layout.GetSegmentLayout(true);
+
+    if (only_metric)
+    {
+        if (in_use_region == REGION_NONE || !storage::SharedMemory::RegionExists(in_use_region))
+        {
+            throw util::exception("No data loaded into shared memory yet, a metric update needs "
+                                  "the static data of a full load.");
+        }
 
-    // Allocate shared memory block
-    auto regions_size = sizeof(layout) + layout.GetSizeOfLayout();
-    util::Log() << "Allocating shared memory of " << regions_size << " bytes";
-    auto data_memory = makeSharedMemory(next_region, regions_size);
+        // The metric must be based on the same files as the static data in use. Equal block
+        // sizes are not enough, e.g. osrm-contract --renumber-nodes only reorders the nodes.
+        auto in_use_memory = makeSharedMemory(in_use_region);
+        auto in_use_ptr = static_cast<char *>(in_use_memory->Ptr());
+        const auto &in_use_layout = *reinterpret_cast<const DataLayout *>(in_use_ptr);
+        if (static_layout.num_entries != in_use_layout.num_entries ||
+            *in_use_layout.GetBlockPtr<std::uint64_t>(in_use_ptr + sizeof(in_use_layout),
+                                                      DataLayout::STATIC_DATA_FINGERPRINT) !=
+                GetStaticDataFingerprint())
+        {
+            throw util::exception("The static data in " + regionToString(in_use_region) +
+                                  " does not match the dataset. Run a full load instead.");
+        }
 
-    // Copy memory layout to shared memory and populate data
-    char *shared_memory_ptr = static_cast<char *>(data_memory->Ptr());
-    memcpy(shared_memory_ptr, &layout, sizeof(layout));
-    PopulateData(layout, shared_memory_ptr + sizeof(layout));
+        // the static data stays where it is
+        next_region = in_use_region;
+    }
+
+    // ensure that the shared memory regions we want to write to are really removed
+    // this is only needed for failure recovery because we actually wait for all clients
+    // to detach at the end of the function
+    for (const auto region : {next_region, next_metric_region})
+    {
+        if (region != in_use_region && storage::SharedMemory::RegionExists(region))
+        {
+            util::Log(logWARNING) << "Old shared memory region " << regionToString(region)
+                                  << " still exists.";
+            util::UnbufferedLog() << "Retrying removal... ";
+            storage::SharedMemory::Remove(region);
+            util::UnbufferedLog() << "ok.";
+        }
+    }
+
+    // Allocate a shared memory block per segment and copy its memory layout in front of it
+    const auto make_segment = [huge_pages](const SharedDataType region,
+                                           const DataLayout &segment_layout) {
+        auto segment_size = sizeof(segment_layout) + segment_layout.GetSizeOfLayout();
+        util::Log() << "Allocating shared memory of " << segment_size << " bytes in "
+                    << regionToString(region);
+        auto memory = makeSharedMemory(region, segment_size, huge_pages);
+        memcpy(memory->Ptr(), &segment_layout, sizeof(segment_layout));
+        return memory;
+    };
+
+    std::unique_ptr<SharedMemory> data_memory;
+    if (!only_metric)
+    {
+        util::Log() << "Loading static data into " << regionToString(next_region);
+        data_memory = make_segment(next_region, static_layout);
+        PopulateStaticData(static_layout,
+                           static_cast<char *>(data_memory->Ptr()) + sizeof(static_layout));
+    }
+
+    util::Log() << "Loading metric data into " << regionToString(next_metric_region);
+    auto metric_memory = make_segment(next_metric_region, metric_layout);
+    PopulateMetricData(metric_layout,
+                       static_cast<char *>(metric_memory->Ptr()) + sizeof(metric_layout));
 
     { // Lock for write access shared region mutex
         boost::interprocess::scoped_lock<Monitor::mutex_type> lock(monitor.get_mutex(),
@@ -155,8 +281,12 @@ int Storage::Run(int max_wait)
                     << " seconds. Removing locked block and creating a new one. All currently "
                        "attached processes will not receive notifications and must be restarted";
                 Monitor::remove();
-                in_use_region = REGION_NONE;
-                monitor = Monitor(SharedDataTimestamp{REGION_NONE, 0});
+                if (!only_metric)
+                {
+                    in_use_region = REGION_NONE;
+                }
+                in_use_metric_region = REGION_NONE;
+                monitor = Monitor(SharedDataTimestamp{REGION_NONE, REGION_NONE, 0});
             }
         }
         else
@@ -164,27 +294,35 @@ int Storage::Run(int max_wait)
             lock.lock();
         }
 
-        // Update the current region ID and timestamp
+        // Update the current region IDs and timestamp
         monitor.data().region = next_region;
+        monitor.data().metric_region = next_metric_region;
         monitor.data().timestamp = next_timestamp;
     }
 
     util::Log() << "All data loaded. Notify all client about new data in "
-                << regionToString(next_region) << " with timestamp " << next_timestamp;
+                << regionToString(next_region) << " and " << regionToString(next_metric_region)
+                << " with timestamp " << next_timestamp;
     monitor.notify_all();
 
     // SHMCTL(2): Mark the segment to be destroyed. The segment will actually be destroyed
     // only after the last process detaches it.
-    if (in_use_region != REGION_NONE && storage::SharedMemory::RegionExists(in_use_region))
+    for (const auto region : {in_use_region, in_use_metric_region})
     {
-        util::UnbufferedLog() << "Marking old shared memory region "
-                              << regionToString(in_use_region) << " for removal... ";
+        if (region == REGION_NONE || region == next_region ||
+            !storage::SharedMemory::RegionExists(region))
+        {
+            continue;
+        }
+
+        util::UnbufferedLog() << "Marking old shared memory region " << regionToString(region)
+                              << " for removal... ";
 
         // aquire a handle for the old shared memory region before we mark it for deletion
         // we will need this to wait for all users to detach
-        auto in_use_shared_memory = makeSharedMemory(in_use_region);
+        auto in_use_shared_memory = makeSharedMemory(region);
 
-        storage::SharedMemory::Remove(in_use_region);
+        storage::SharedMemory::Remove(region);
         util::UnbufferedLog() << "ok.";
 
         util::UnbufferedLog() << "Waiting for clients to detach... ";
@@ -197,6 +335,40 @@ int Storage::Run(int max_wait)
     return EXIT_SUCCESS;
 }
 
+std::uint64_t Storage::GetStaticDataFingerprint() const
+{
+    // the files of the blocks that are not DataLayout::IsMetricBlock
+    const std::vector<boost::filesystem::path> static_files = {config.ram_index_path,
+                                                               config.file_index_path,
+                                                               config.node_based_nodes_data_path,
+                                                               config.edge_based_nodes_data_path,
+                                                               config.edges_data_path,
+                                                               config.timestamp_path,
+                                                               config.names_data_path,
+                                                               config.properties_path,
+                                                               config.intersection_class_path,
+                                                               config.turn_lane_data_path,
+                                                               config.turn_lane_description_path,
+                                                               config.mld_partition_path};
+
+    std::size_t fingerprint = 0;
+    for (const auto &path : static_files)
+    {
+        hash_combine(fingerprint, path.string());
+
+        boost::system::error_code error;
+        const auto size = boost::filesystem::file_size(path, error);
+        if (error)
+            continue;
+        const auto modified = boost::filesystem::last_write_time(path, error);
+        if (error)
+            continue;
+        hash_combine(fingerprint, static_cast<std::uint64_t>(size));
+        hash_combine(fingerprint, static_cast<std::int64_t>(modified));
+    }
+    return fingerprint;
+}
+
 /**
  * This function examines all our data files and figures out how much
  * memory needs to be allocated, and the position of each data structure
@@ -287,12 +459,20 @@ void Storage::PopulateLayout(DataLayout &layout)
         tree_node_file.Skip<RTreeNode>(tree_size);
         const auto tree_levels_size = tree_node_file.ReadElementCount64();
         layout.SetBlockSize<std::uint64_t>(DataLayout::R_SEARCH_TREE_LEVELS, tree_levels_size);
+
+        // the leaves are computed from the .fileIndex when the data is loaded
+        const auto number_of_objects =
+            boost::filesystem::file_size(config.file_index_path) / sizeof(RTreeLeaf);
+        layout.SetBlockSize<RTreeProjectedLeaf>(DataLayout::R_SEARCH_TREE_PROJECTED_LEAVES,
+                                                SharedRTree::GetNumberOfLeaves(number_of_objects));
     }
 
     {
         layout.SetBlockSize<extractor::ProfileProperties>(DataLayout::PROPERTIES, 1);
     }
 
+    layout.SetBlockSize<std::uint64_t>(DataLayout::STATIC_DATA_FINGERPRINT, 1);
+
     // read timestampsize
     {
         io::FileReader timestamp_file(config.timestamp_path, io::FileReader::VerifyFingerprint);
@@ -348,12 +528,43 @@ void Storage::PopulateLayout(DataLayout &layout)
     {
         io::FileReader reader(config.geometries_path, io::FileReader::VerifyFingerprint);
 
-        const auto number_of_geometries_indices = reader.ReadVectorSize<unsigned>();
-        layout.SetBlockSize<unsigned>(DataLayout::GEOMETRIES_INDEX, number_of_geometries_indices);
-
-        const auto number_of_compressed_geometries = reader.ReadVectorSize<NodeID>();
-        layout.SetBlockSize<NodeID>(DataLayout::GEOMETRIES_NODE_LIST,
-                                    number_of_compressed_geometries);
+        std::uint64_t number_of_compressed_geometries = 0;
+        if (config.compress_geometry)
+        {
+            // the packed size depends on the nodes, so they need to be encoded once to count
+            std::vector<unsigned> geometry_begin_indices;
+            storage::serialization::read(reader, geometry_begin_indices);
+            layout.SetBlockSize<unsigned>(DataLayout::GEOMETRIES_INDEX,
+                                          geometry_begin_indices.size());
+
+            extractor::PackedGeometryEncoder encoder(geometry_begin_indices.data(),
+                                                     geometry_begin_indices.size());
+            extractor::serialization::readPackedNodes(reader, encoder);
+            number_of_compressed_geometries = encoder.GetNumberOfNodes();
+
+            layout.SetBlockSize<NodeID>(DataLayout::GEOMETRIES_NODE_LIST, 0);
+            layout.SetBlockSize<NodeID>(DataLayout::GEOMETRIES_PACKED_FIRST_NODES,
+                                        encoder.GetNumberOfGeometries());
+            layout.SetBlockSize<extractor::PackedGeometryBlock>(
+                DataLayout::GEOMETRIES_PACKED_BLOCKS, encoder.GetNumberOfBlocks());
+            layout.SetBlockSize<extractor::PackedGeometryEncoder::WordT>(
+                DataLayout::GEOMETRIES_PACKED_WORDS, encoder.GetNumberOfWords());
+        }
+        else
+        {
+            const auto number_of_geometries_indices = reader.ReadVectorSize<unsigned>();
+            layout.SetBlockSize<unsigned>(DataLayout::GEOMETRIES_INDEX,
+                                          number_of_geometries_indices);
+
+            number_of_compressed_geometries = reader.ReadVectorSize<NodeID>();
+            layout.SetBlockSize<NodeID>(DataLayout::GEOMETRIES_NODE_LIST,
+                                        number_of_compressed_geometries);
+            layout.SetBlockSize<NodeID>(DataLayout::GEOMETRIES_PACKED_FIRST_NODES, 0);
+            layout.SetBlockSize<extractor::PackedGeometryBlock>(
+                DataLayout::GEOMETRIES_PACKED_BLOCKS, 0);
+            layout.SetBlockSize<extractor::PackedGeometryEncoder::WordT>(
+                DataLayout::GEOMETRIES_PACKED_WORDS, 0);
+        }
 
         reader.ReadElementCount64(); // number of segments
         const auto number_of_segment_weight_blocks =
@@ -501,29 +712,55 @@ void Storage::PopulateLayout(DataLayout &layout)
 }
 
 void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
+{
+    PopulateData(layout, memory_ptr, true, true);
+}
+
+void Storage::PopulateStaticData(const DataLayout &layout, char *memory_ptr)
+{
+    PopulateData(layout, memory_ptr, true, false);
+}
+
+void Storage::PopulateMetricData(const DataLayout &layout, char *memory_ptr)
+{
+    PopulateData(layout, memory_ptr, false, true);
+}
+
+void Storage::PopulateData(const DataLayout &layout,
+                           char *memory_ptr,
+                           const bool load_static,
+                           const bool load_metric)
 {
     BOOST_ASSERT(memory_ptr != nullptr);
 
     // read actual data into shared memory object //
+    // Every file is loaded by its own task, the blocks of different files never overlap.
+    TIMER_START(populate_data);
+    ParallelLoader loader(load_static, load_metric);
 
     // Load the HSGR file
     if (boost::filesystem::exists(config.hsgr_data_path))
     {
-        auto graph_nodes_ptr = layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
-            memory_ptr, storage::DataLayout::CH_GRAPH_NODE_LIST);
-        auto graph_edges_ptr = layout.GetBlockPtr<contractor::QueryGraphView::EdgeArrayEntry, true>(
-            memory_ptr, storage::DataLayout::CH_GRAPH_EDGE_LIST);
-        auto checksum = layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::HSGR_CHECKSUM);
-
-        util::vector_view<contractor::QueryGraphView::NodeArrayEntry> node_list(
-            graph_nodes_ptr, layout.num_entries[storage::DataLayout::CH_GRAPH_NODE_LIST]);
-        util::vector_view<contractor::QueryGraphView::EdgeArrayEntry> edge_list(
-            graph_edges_ptr, layout.num_entries[storage::DataLayout::CH_GRAPH_EDGE_LIST]);
-
-        contractor::QueryGraphView graph_view(std::move(node_list), std::move(edge_list));
-        contractor::files::readGraph(config.hsgr_data_path, *checksum, graph_view);
+        loader.LoadMetric(config.hsgr_data_path, [&] {
+            auto graph_nodes_ptr =
+                layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
+                    memory_ptr, storage::DataLayout::CH_GRAPH_NODE_LIST);
+            auto graph_edges_ptr =
+                layout.GetBlockPtr<contractor::QueryGraphView::EdgeArrayEntry, true>(
+                    memory_ptr, storage::DataLayout::CH_GRAPH_EDGE_LIST);
+            auto checksum =
+                layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::HSGR_CHECKSUM);
+
+            util::vector_view<contractor::QueryGraphView::NodeArrayEntry> node_list(
+                graph_nodes_ptr, layout.num_entries[storage::DataLayout::CH_GRAPH_NODE_LIST]);
+            util::vector_view<contractor::QueryGraphView::EdgeArrayEntry> edge_list(
+                graph_edges_ptr, layout.num_entries[storage::DataLayout::CH_GRAPH_EDGE_LIST]);
+
+            contractor::QueryGraphView graph_view(std::move(node_list), std::move(edge_list));
+            contractor::files::readGraph(config.hsgr_data_path, *checksum, graph_view);
+        });
     }
-    else
+    else if (load_metric)
     {
         layout.GetBlockPtr<unsigned, true>(memory_ptr, DataLayout::HSGR_CHECKSUM);
         layout.GetBlockPtr<contractor::QueryGraphView::NodeArrayEntry, true>(
@@ -532,7 +769,15 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             memory_ptr, DataLayout::CH_GRAPH_EDGE_LIST);
     }
 
+    // taken before any file is read, a file changing while it is loaded changes the fingerprint
+    if (load_static)
+    {
+        *layout.GetBlockPtr<std::uint64_t, true>(memory_ptr, DataLayout::STATIC_DATA_FINGERPRINT) =
+            GetStaticDataFingerprint();
+    }
+
     // store the filename of the on-disk portion of the RTree
+    if (load_static)
     {
         const auto file_index_path_ptr =
             layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::FILE_INDEX_PATH);
@@ -549,7 +794,7 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
     }
 
     // Name data
-    {
+    loader.LoadStatic(config.names_data_path, [&] {
         io::FileReader name_file(config.names_data_path, io::FileReader::VerifyFingerprint);
         std::size_t name_file_size = name_file.GetSize();
 
@@ -558,10 +803,10 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::NAME_CHAR_DATA);
 
         name_file.ReadInto<char>(name_char_ptr, name_file_size);
-    }
+    });
 
     // Turn lane data
-    {
+    loader.LoadStatic(config.turn_lane_data_path, [&] {
         io::FileReader lane_data_file(config.turn_lane_data_path,
                                       io::FileReader::VerifyFingerprint);
 
@@ -574,10 +819,10 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
         BOOST_ASSERT(lane_tuple_count * sizeof(util::guidance::LaneTupleIdPair) ==
                      layout.GetBlockSize(DataLayout::TURN_LANE_DATA));
         lane_data_file.ReadInto(turn_lane_data_ptr, lane_tuple_count);
-    }
+    });
 
     // Turn lane descriptions
-    {
+    loader.LoadStatic(config.turn_lane_description_path, [&] {
         auto offsets_ptr = layout.GetBlockPtr<std::uint32_t, true>(
             memory_ptr, storage::DataLayout::LANE_DESCRIPTION_OFFSETS);
         util::vector_view<std::uint32_t> offsets(
@@ -590,10 +835,10 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
 
         extractor::files::readTurnLaneDescriptions(
             config.turn_lane_description_path, offsets, masks);
-    }
+    });
 
     // Load edge-based nodes data
-    {
+    loader.LoadStatic(config.edge_based_nodes_data_path, [&] {
         auto geometry_id_list_ptr =
             layout.GetBlockPtr<GeometryID, true>(memory_ptr, storage::DataLayout::GEOMETRY_ID_LIST);
         util::vector_view<GeometryID> geometry_ids(
@@ -620,10 +865,10 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
                                                    std::move(travel_modes));
 
         extractor::files::readNodeData(config.edge_based_nodes_data_path, node_data);
-    }
+    });
 
     // Load original edge data
-    {
+    loader.LoadStatic(config.edges_data_path, [&] {
         const auto lane_data_id_ptr =
             layout.GetBlockPtr<LaneDataID, true>(memory_ptr, storage::DataLayout::LANE_DATA_ID);
         util::vector_view<LaneDataID> lane_data_ids(
@@ -657,20 +902,23 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
                                           std::move(post_turn_bearings));
 
         extractor::files::readTurnData(config.edges_data_path, turn_data);
-    }
+    });
 
     // load compressed geometry
-    {
+    loader.LoadMetric(config.geometries_path, [&] {
         auto geometries_index_ptr =
             layout.GetBlockPtr<unsigned, true>(memory_ptr, storage::DataLayout::GEOMETRIES_INDEX);
         util::vector_view<unsigned> geometry_begin_indices(
             geometries_index_ptr, layout.num_entries[storage::DataLayout::GEOMETRIES_INDEX]);
 
-        auto num_entries = layout.num_entries[storage::DataLayout::GEOMETRIES_NODE_LIST];
+        // the node list is empty if the geometry is packed, the datasources are never packed
+        auto num_entries = layout.num_entries[storage::DataLayout::DATASOURCES_LIST];
 
         auto geometries_node_list_ptr =
             layout.GetBlockPtr<NodeID, true>(memory_ptr, storage::DataLayout::GEOMETRIES_NODE_LIST);
-        util::vector_view<NodeID> geometry_node_list(geometries_node_list_ptr, num_entries);
+        util::vector_view<NodeID> geometry_node_list(
+            geometries_node_list_ptr,
+            layout.num_entries[storage::DataLayout::GEOMETRIES_NODE_LIST]);
 
         auto geometries_fwd_weight_list_ptr =
             layout.GetBlockPtr<extractor::SegmentDataView::SegmentWeightVector::block_type, true>(
@@ -721,17 +969,40 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
                                                 std::move(geometry_rev_duration_list),
                                                 std::move(datasources_list)};
 
-        extractor::files::readSegmentData(config.geometries_path, segment_data);
-    }
+        if (config.compress_geometry)
+        {
+            // the index is read into shared memory before the encoder needs it
+            extractor::PackedGeometryEncoder encoder(
+                geometries_index_ptr,
+                layout.num_entries[storage::DataLayout::GEOMETRIES_INDEX],
+                layout.GetBlockPtr<NodeID, true>(memory_ptr,
+                                                 DataLayout::GEOMETRIES_PACKED_FIRST_NODES),
+                layout.GetBlockPtr<extractor::PackedGeometryBlock, true>(
+                    memory_ptr, DataLayout::GEOMETRIES_PACKED_BLOCKS),
+                layout.GetBlockPtr<extractor::PackedGeometryEncoder::WordT, true>(
+                    memory_ptr, DataLayout::GEOMETRIES_PACKED_WORDS));
+            extractor::files::readSegmentData(config.geometries_path, segment_data, encoder);
+        }
+        else
+        {
+            // the facade checks the canaries of the empty packed blocks as well
+            layout.GetBlockPtr<NodeID, true>(memory_ptr, DataLayout::GEOMETRIES_PACKED_FIRST_NODES);
+            layout.GetBlockPtr<extractor::PackedGeometryBlock, true>(
+                memory_ptr, DataLayout::GEOMETRIES_PACKED_BLOCKS);
+            layout.GetBlockPtr<extractor::PackedGeometryEncoder::WordT, true>(
+                memory_ptr, DataLayout::GEOMETRIES_PACKED_WORDS);
+            extractor::files::readSegmentData(config.geometries_path, segment_data);
+        }
+    });
 
-    {
+    loader.LoadMetric(config.datasource_names_path, [&] {
         const auto datasources_names_ptr = layout.GetBlockPtr<extractor::Datasources, true>(
             memory_ptr, DataLayout::DATASOURCES_NAMES);
         extractor::files::readDatasources(config.datasource_names_path, *datasources_names_ptr);
-    }
+    });
 
     // Loading list of coordinates
-    {
+    loader.LoadStatic(config.node_based_nodes_data_path, [&] {
         const auto coordinates_ptr =
             layout.GetBlockPtr<util::Coordinate, true>(memory_ptr, DataLayout::COORDINATE_LIST);
         const auto osmnodeid_ptr =
@@ -745,30 +1016,30 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             layout.num_entries[DataLayout::COORDINATE_LIST]);
 
         extractor::files::readNodes(config.node_based_nodes_data_path, coordinates, osm_node_ids);
-    }
+    });
 
     // load turn weight penalties
-    {
+    loader.LoadMetric(config.turn_weight_penalties_path, [&] {
         io::FileReader turn_weight_penalties_file(config.turn_weight_penalties_path,
                                                   io::FileReader::VerifyFingerprint);
         const auto number_of_penalties = turn_weight_penalties_file.ReadElementCount64();
         const auto turn_weight_penalties_ptr =
             layout.GetBlockPtr<TurnPenalty, true>(memory_ptr, DataLayout::TURN_WEIGHT_PENALTIES);
         turn_weight_penalties_file.ReadInto(turn_weight_penalties_ptr, number_of_penalties);
-    }
+    });
 
     // load turn duration penalties
-    {
+    loader.LoadMetric(config.turn_duration_penalties_path, [&] {
         io::FileReader turn_duration_penalties_file(config.turn_duration_penalties_path,
                                                     io::FileReader::VerifyFingerprint);
         const auto number_of_penalties = turn_duration_penalties_file.ReadElementCount64();
         const auto turn_duration_penalties_ptr =
             layout.GetBlockPtr<TurnPenalty, true>(memory_ptr, DataLayout::TURN_DURATION_PENALTIES);
         turn_duration_penalties_file.ReadInto(turn_duration_penalties_ptr, number_of_penalties);
-    }
+    });
 
     // store timestamp
-    {
+    loader.LoadStatic(config.timestamp_path, [&] {
         io::FileReader timestamp_file(config.timestamp_path, io::FileReader::VerifyFingerprint);
         const auto timestamp_size = timestamp_file.GetSize();
 
@@ -776,10 +1047,10 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             layout.GetBlockPtr<char, true>(memory_ptr, DataLayout::TIMESTAMP);
         BOOST_ASSERT(timestamp_size == layout.num_entries[DataLayout::TIMESTAMP]);
         timestamp_file.ReadInto(timestamp_ptr, timestamp_size);
-    }
+    });
 
     // store search tree portion of rtree
-    {
+    loader.LoadStatic(config.ram_index_path, [&] {
         io::FileReader tree_node_file(config.ram_index_path, io::FileReader::VerifyFingerprint);
         // perform this read so that we're at the right stream position for the next
         // read.
@@ -795,27 +1066,29 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
 
         tree_node_file.ReadInto(rtree_levelsizes_ptr,
                                 layout.num_entries[DataLayout::R_SEARCH_TREE_LEVELS]);
-    }
+    });
 
     if (boost::filesystem::exists(config.core_data_path))
     {
-        auto core_marker_ptr =
-            layout.GetBlockPtr<unsigned, true>(memory_ptr, storage::DataLayout::CH_CORE_MARKER);
-        util::vector_view<bool> is_core_node(
-            core_marker_ptr, layout.num_entries[storage::DataLayout::CH_CORE_MARKER]);
-
-        contractor::files::readCoreMarker(config.core_data_path, is_core_node);
+        loader.LoadMetric(config.core_data_path, [&] {
+            auto core_marker_ptr =
+                layout.GetBlockPtr<unsigned, true>(memory_ptr, storage::DataLayout::CH_CORE_MARKER);
+            util::vector_view<bool> is_core_node(
+                core_marker_ptr, layout.num_entries[storage::DataLayout::CH_CORE_MARKER]);
+
+            contractor::files::readCoreMarker(config.core_data_path, is_core_node);
+        });
     }
 
     // load profile properties
-    {
+    loader.LoadStatic(config.properties_path, [&] {
         const auto profile_properties_ptr = layout.GetBlockPtr<extractor::ProfileProperties, true>(
             memory_ptr, DataLayout::PROPERTIES);
         extractor::files::readProfileProperties(config.properties_path, *profile_properties_ptr);
-    }
+    });
 
     // Load intersection data
-    {
+    loader.LoadStatic(config.intersection_class_path, [&] {
         auto bearing_class_id_ptr = layout.GetBlockPtr<BearingClassID, true>(
             memory_ptr, storage::DataLayout::BEARING_CLASSID);
         util::vector_view<BearingClassID> bearing_class_id(
@@ -849,12 +1122,12 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
 
         extractor::files::readIntersections(
             config.intersection_class_path, intersection_bearings_view, entry_classes);
-    }
+    });
 
+    // Loading MLD Data
+    if (boost::filesystem::exists(config.mld_partition_path))
     {
-        // Loading MLD Data
-        if (boost::filesystem::exists(config.mld_partition_path))
-        {
+        loader.LoadStatic(config.mld_partition_path, [&] {
             BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_LEVEL_DATA) > 0);
             BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELL_TO_CHILDREN) > 0);
             BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_PARTITION) > 0);
@@ -878,10 +1151,12 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             partition::MultiLevelPartitionView mlp{
                 std::move(level_data), std::move(partition), std::move(cell_to_children)};
             partition::files::readPartition(config.mld_partition_path, mlp);
-        }
+        });
+    }
 
-        if (boost::filesystem::exists(config.mld_storage_path))
-        {
+    if (boost::filesystem::exists(config.mld_storage_path))
+    {
+        loader.LoadMetric(config.mld_storage_path, [&] {
             BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELLS) > 0);
             BOOST_ASSERT(layout.GetBlockSize(storage::DataLayout::MLD_CELL_LEVEL_OFFSETS) > 0);
 
@@ -929,11 +1204,12 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
                                                std::move(cells),
                                                std::move(level_offsets)};
             partition::files::readCells(config.mld_storage_path, storage);
-        }
-
-        if (boost::filesystem::exists(config.mld_graph_path))
-        {
+        });
+    }
 
+    if (boost::filesystem::exists(config.mld_graph_path))
+    {
+        loader.LoadMetric(config.mld_graph_path, [&] {
             auto graph_nodes_ptr =
                 layout.GetBlockPtr<customizer::MultiLevelEdgeBasedGraphView::NodeArrayEntry, true>(
                     memory_ptr, storage::DataLayout::MLD_GRAPH_NODE_LIST);
@@ -955,8 +1231,31 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
             customizer::MultiLevelEdgeBasedGraphView graph_view(
                 std::move(node_list), std::move(edge_list), std::move(node_to_offset));
             partition::files::readGraph(config.mld_graph_path, graph_view);
-        }
+        });
+    }
+
+    loader.Wait();
+
+    // project the segments of the rtree leaves, this needs the coordinates loaded above
+    if (load_static)
+    {
+        TIMER_START(project_leaves);
+        boost::iostreams::mapped_file_source objects_region;
+        const auto objects = util::mmapFile<RTreeLeaf>(config.file_index_path, objects_region);
+        const util::vector_view<const util::Coordinate> coordinates(
+            layout.GetBlockPtr<util::Coordinate>(memory_ptr, DataLayout::COORDINATE_LIST),
+            layout.num_entries[DataLayout::COORDINATE_LIST]);
+        const auto projected_leaves_ptr = layout.GetBlockPtr<RTreeProjectedLeaf, true>(
+            memory_ptr, DataLayout::R_SEARCH_TREE_PROJECTED_LEAVES);
+        BOOST_ASSERT(SharedRTree::GetNumberOfLeaves(objects.size()) ==
+                     layout.num_entries[DataLayout::R_SEARCH_TREE_PROJECTED_LEAVES]);
+        SharedRTree::ProjectLeaves(objects, coordinates, projected_leaves_ptr);
+        TIMER_STOP(project_leaves);
+        util::Log() << "Projected the rtree leaves in " << TIMER_MSEC(project_leaves) << "ms";
     }
+
+    TIMER_STOP(populate_data);
+    util::Log() << "Loaded all data in " << TIMER_SEC(populate_data) << " seconds";
 }
 }
 }
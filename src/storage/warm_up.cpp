@@ -0,0 +1,80 @@
+#include "storage/warm_up.hpp"
+
+#include <array>
+#include <vector>
+
+namespace osrm
+{
+namespace storage
+{
+namespace
+{
+// Smallest page size, touching huge pages at this stride costs next to nothing
+const constexpr std::uint64_t PAGE_SIZE = 4096;
+
+const constexpr std::array<DataLayout::BlockID, 23> QUERY_ORDER = {
+    {// snapping
+     DataLayout::R_SEARCH_TREE,
+     DataLayout::R_SEARCH_TREE_LEVELS,
+     DataLayout::COORDINATE_LIST,
+     DataLayout::COMPONENT_ID_LIST,
+     // search
+     DataLayout::CH_GRAPH_NODE_LIST,
+     DataLayout::CH_GRAPH_EDGE_LIST,
+     DataLayout::CH_CORE_MARKER,
+     DataLayout::MLD_PARTITION,
+     DataLayout::MLD_CELLS,
+     DataLayout::MLD_CELL_LEVEL_OFFSETS,
+     DataLayout::MLD_CELL_SOURCE_BOUNDARY,
+     DataLayout::MLD_CELL_DESTINATION_BOUNDARY,
+     DataLayout::MLD_CELL_WEIGHTS,
+     DataLayout::MLD_GRAPH_NODE_TO_OFFSET,
+     DataLayout::MLD_GRAPH_NODE_LIST,
+     DataLayout::MLD_GRAPH_EDGE_LIST,
+     // unpacking
+     DataLayout::GEOMETRY_ID_LIST,
+     DataLayout::GEOMETRIES_INDEX,
+     DataLayout::GEOMETRIES_NODE_LIST,
+     DataLayout::GEOMETRIES_PACKED_FIRST_NODES,
+     DataLayout::GEOMETRIES_PACKED_BLOCKS,
+     DataLayout::GEOMETRIES_PACKED_WORDS,
+     DataLayout::GEOMETRIES_FWD_WEIGHT_LIST}};
+}
+
+std::uint64_t warmUp(const DataLayout &layout, const char *memory)
+{
+    // all remaining blocks (guidance, names, ...) follow in layout order
+    std::vector<bool> visited(DataLayout::NUM_BLOCKS, false);
+    std::vector<DataLayout::BlockID> order(QUERY_ORDER.begin(), QUERY_ORDER.end());
+    for (const auto bid : QUERY_ORDER)
+        visited[bid] = true;
+    for (auto bid = 0; bid < DataLayout::NUM_BLOCKS; ++bid)
+    {
+        if (!visited[bid])
+            order.push_back(static_cast<DataLayout::BlockID>(bid));
+    }
+
+    std::uint64_t touched = 0;
+    volatile char sink = 0;
+    for (const auto bid : order)
+    {
+        // blocks of other segments are not populated
+        if (layout.GetBlockEntries(bid) == 0)
+            continue;
+
+        // The canaries are not checked here, the facade does that when it reads the block
+        const auto begin = static_cast<const char *>(
+            layout.GetAlignedBlockPtr(const_cast<char *>(memory), bid));
+        const auto size = layout.GetBlockSize(bid);
+        for (std::uint64_t offset = 0; offset < size; offset += PAGE_SIZE)
+        {
+            sink = sink + begin[offset];
+        }
+        sink = sink + begin[size - 1];
+        touched += size;
+    }
+
+    return touched;
+}
+}
+}
@@ -58,6 +58,13 @@ return_code parseArguments(int argc, char *argv[], contractor::ContractorConfig
         boost::program_options::value<bool>(&contractor_config.use_cached_priority)
             ->default_value(false),
         "Use .level file to retain the contaction level for each node from the last run.")(
+        "renumber-nodes",
+        boost::program_options::value<bool>(&contractor_config.renumber_nodes)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Renumber the nodes in the order of the hierarchy to make queries more cache friendly. "
+        "Changes the node IDs in the files of osrm-extract and removes the files of "
+        "osrm-partition and osrm-customize.")(
         "edge-weight-updates-over-factor",
         boost::program_options::value<double>(
             &contractor_config.updater_config.log_edge_updates_factor)
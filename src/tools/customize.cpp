@@ -65,7 +65,12 @@ parseArguments(int argc, char *argv[], customizer::CustomizationConfig &customiz
                 &customization_config.updater_config.tz_file_path)
                 ->default_value(""),
             "Required for conditional turn restriction parsing, provide a geojson file containing "
-            "time zone boundaries");
+            "time zone boundaries")(
+            "incremental",
+            boost::program_options::bool_switch(&customization_config.incremental)
+                ->default_value(false),
+            "Only recompute the cells that contain segments or turns updated by this or the last "
+            "customization. Customizes all cells if the .osrm.cells file was not customized yet");
 
     // hidden options, will be allowed on command line, but will not be
     // shown to the user
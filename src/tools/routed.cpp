@@ -11,6 +11,8 @@
 
 #include <boost/any.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/optional.hpp>
 #include <boost/program_options.hpp>
 
 #include <cstdlib>
@@ -25,6 +27,8 @@
 #include <new>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 boost::function0<void> console_ctrl_function;
@@ -62,6 +66,25 @@ EngineConfig::Algorithm stringToAlgorithm(const std::string &algorithm)
     throw util::RuntimeError(algorithm, ErrorCode::UnknownAlgorithm, SOURCE_REF);
 }
 
+// parses a concurrency limit of the form service=limit
+boost::optional<std::pair<std::string, unsigned>>
+parseServiceLimit(const std::string &service_limit)
+{
+    const auto separator = service_limit.find('=');
+    if (separator == std::string::npos || separator == 0)
+    {
+        return boost::none;
+    }
+
+    int limit = 0;
+    if (!boost::conversion::try_lexical_convert(service_limit.substr(separator + 1), limit) ||
+        limit < 1)
+    {
+        return boost::none;
+    }
+    return std::make_pair(service_limit.substr(0, separator), static_cast<unsigned>(limit));
+}
+
 // generate boost::program_options object for the routing part
 inline unsigned generateServerProgramOptions(const int argc,
                                              const char *argv[],
@@ -69,14 +92,26 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              std::string &ip_address,
                                              int &ip_port,
                                              int &requested_num_threads,
+                                             int &requested_num_io_threads,
+                                             int &max_queue_size,
+                                             std::vector<std::string> &max_concurrent_requests,
+                                             unsigned &keepalive_timeout,
+                                             unsigned &keepalive_max_requests,
                                              bool &use_shared_memory,
+                                             bool &use_mmap,
+                                             bool &warm_up,
+                                             bool &compress_geometry,
+                                             bool &numa_replicate,
                                              std::string &algorithm,
                                              bool &trial,
                                              int &max_locations_trip,
                                              int &max_locations_viaroute,
                                              int &max_locations_distance_table,
                                              int &max_locations_map_matching,
-                                             int &max_results_nearest)
+                                             int &max_results_nearest,
+                                             int &max_heap_index_memory_mb,
+                                             int &max_threads_distance_table,
+                                             int &result_cache_size)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
@@ -99,9 +134,42 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("threads,t",
          value<int>(&requested_num_threads)->default_value(8),
          "Number of threads to use") //
+        ("io-threads",
+         value<int>(&requested_num_io_threads)->default_value(2),
+         "Number of threads handling connections, queries run on the other threads") //
+        ("max-queue-size",
+         value<int>(&max_queue_size)->default_value(-1),
+         "Max. requests waiting for a free thread before new requests are rejected with 503 "
+         "(-1 for unlimited)") //
+        ("max-concurrent-requests",
+         value<std::vector<std::string>>(&max_concurrent_requests)->composing(),
+         "Max. requests of a service running at the same time, e.g. table=2. Can be "
+         "specified multiple times") //
+        ("keepalive-timeout",
+         value<unsigned>(&keepalive_timeout)->default_value(5),
+         "Seconds an idle persistent connection stays open (0 to close after every request)") //
+        ("keepalive-requests",
+         value<unsigned>(&keepalive_max_requests)->default_value(512),
+         "Max. requests served on one persistent connection") //
         ("shared-memory,s",
          value<bool>(&use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
+        ("mmap",
+         value<bool>(&use_mmap)->implicit_value(true)->default_value(false),
+         "Map the data read-only from a <base.osrm>.datastore image instead of loading it into "
+         "memory. The image is created on first use and when the files change") //
+        ("warm-up",
+         value<bool>(&warm_up)->implicit_value(true)->default_value(false),
+         "Touch all pages of the data before serving queries, e.g. the shared memory of "
+         "osrm-datastore or the pages of --mmap") //
+        ("compress-geometry",
+         value<bool>(&compress_geometry)->implicit_value(true)->default_value(false),
+         "Store the geometry node lists delta encoded and bit-packed when loading the data "
+         "into memory or --mmap, which needs less memory but makes unpacking slower") //
+        ("numa-replicate",
+         value<bool>(&numa_replicate)->implicit_value(true)->default_value(false),
+         "Keep a copy of the graph and the weights on every NUMA node and pin the query "
+         "threads to the nodes, so queries read local memory") //
         ("algorithm,a",
          value<std::string>(&algorithm)->default_value("CH"),
          "Algorithm to use for the data. Can be CH, CoreCH, MLD.") //
@@ -119,7 +187,19 @@ inline unsigned generateServerProgramOptions(const int argc,
          "Max. locations supported in map matching query") //
         ("max-nearest-size",
          value<int>(&max_results_nearest)->default_value(100),
-         "Max. results supported in nearest query");
+         "Max. results supported in nearest query") //
+        ("max-heap-index-memory",
+         value<int>(&max_heap_index_memory_mb)->default_value(256),
+         "Max. memory in MB for the node index of a search heap. Applies to each of the heaps "
+         "of every thread, larger graphs use hash map based heaps (-1 for unlimited, 0 to always "
+         "use hash maps)") //
+        ("max-table-threads",
+         value<int>(&max_threads_distance_table)->default_value(1),
+         "Max. threads a single distance table query may use (-1 for all available)") //
+        ("result-cache-size",
+         value<int>(&result_cache_size)->default_value(0),
+         "Max. responses of route, table and nearest queries kept in memory and reused for "
+         "queries snapping to the same locations (0 to disable)");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -192,25 +272,42 @@ int main(int argc, const char *argv[]) try
 
     bool trial_run = false;
     std::string ip_address;
-    int ip_port, requested_thread_num;
+    int ip_port, requested_thread_num, requested_io_thread_num;
+    server::RequestExecutorConfig executor_config;
+    server::ConnectionConfig connection_config;
+    std::vector<std::string> max_concurrent_requests;
 
     EngineConfig config;
     boost::filesystem::path base_path;
     std::string algorithm;
-    const unsigned init_result = generateServerProgramOptions(argc,
-                                                              argv,
-                                                              base_path,
-                                                              ip_address,
-                                                              ip_port,
-                                                              requested_thread_num,
-                                                              config.use_shared_memory,
-                                                              algorithm,
-                                                              trial_run,
-                                                              config.max_locations_trip,
-                                                              config.max_locations_viaroute,
-                                                              config.max_locations_distance_table,
-                                                              config.max_locations_map_matching,
-                                                              config.max_results_nearest);
+    bool compress_geometry = false;
+    const unsigned init_result =
+        generateServerProgramOptions(argc,
+                                     argv,
+                                     base_path,
+                                     ip_address,
+                                     ip_port,
+                                     requested_thread_num,
+                                     requested_io_thread_num,
+                                     executor_config.max_queue_size,
+                                     max_concurrent_requests,
+                                     connection_config.keepalive_timeout,
+                                     connection_config.keepalive_max_requests,
+                                     config.use_shared_memory,
+                                     config.use_mmap,
+                                     config.warm_up,
+                                     compress_geometry,
+                                     config.numa_replicate,
+                                     algorithm,
+                                     trial_run,
+                                     config.max_locations_trip,
+                                     config.max_locations_viaroute,
+                                     config.max_locations_distance_table,
+                                     config.max_locations_map_matching,
+                                     config.max_results_nearest,
+                                     config.max_heap_index_memory_mb,
+                                     config.max_threads_distance_table,
+                                     config.result_cache_size);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -222,6 +319,7 @@ int main(int argc, const char *argv[]) try
     if (!base_path.empty())
     {
         config.storage_config = storage::StorageConfig(base_path);
+        config.storage_config.compress_geometry = compress_geometry;
     }
     if (!config.use_shared_memory && !config.storage_config.IsValid())
     {
@@ -237,6 +335,18 @@ int main(int argc, const char *argv[]) try
         return EXIT_FAILURE;
     }
     config.algorithm = stringToAlgorithm(algorithm);
+    executor_config.pin_numa_nodes = config.numa_replicate;
+    for (const auto &limit : max_concurrent_requests)
+    {
+        const auto service_limit = parseServiceLimit(limit);
+        if (!service_limit)
+        {
+            util::Log(logERROR) << "Invalid concurrency limit " << limit
+                                << ", expected service=limit with a limit of at least 1";
+            return EXIT_FAILURE;
+        }
+        executor_config.max_concurrent_requests.insert(*service_limit);
+    }
 
     util::Log() << "starting up engines, " << OSRM_VERSION;
 
@@ -244,8 +354,13 @@ int main(int argc, const char *argv[]) try
     {
         util::Log() << "Loading from shared memory";
     }
+    else if (config.use_mmap)
+    {
+        util::Log() << "Mapping data from " << config.storage_config.memory_image_path.string();
+    }
 
     util::Log() << "Threads: " << requested_thread_num;
+    util::Log() << "I/O threads: " << requested_io_thread_num;
     util::Log() << "IP address: " << ip_address;
     util::Log() << "IP port: " << ip_port;
 
@@ -257,7 +372,12 @@ int main(int argc, const char *argv[]) try
     pthread_sigmask(SIG_BLOCK, &new_mask, &old_mask);
 #endif
 
-    auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
+    auto routing_server = server::Server::CreateServer(ip_address,
+                                                       ip_port,
+                                                       requested_thread_num,
+                                                       requested_io_thread_num,
+                                                       std::move(executor_config),
+                                                       connection_config);
     auto service_handler = std::make_unique<server::ServiceHandler>(config);
 
     routing_server->RegisterServiceHandler(std::move(service_handler));
@@ -45,6 +45,8 @@ void springClean()
     {
         deleteRegion(storage::REGION_1);
         deleteRegion(storage::REGION_2);
+        deleteRegion(storage::METRIC_REGION_1);
+        deleteRegion(storage::METRIC_REGION_2);
         removeLocks();
     }
 }
@@ -53,7 +55,10 @@ void springClean()
 bool generateDataStoreOptions(const int argc,
                               const char *argv[],
                               boost::filesystem::path &base_path,
-                              int &max_wait)
+                              int &max_wait,
+                              bool &only_metric,
+                              bool &huge_pages,
+                              bool &compress_geometry)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -67,7 +72,19 @@ bool generateDataStoreOptions(const int argc,
     config_options.add_options()("max-wait",
                                  boost::program_options::value<int>(&max_wait)->default_value(-1),
                                  "Maximum number of seconds to wait on a running data update "
-                                 "before aquiring the lock by force.");
+                                 "before aquiring the lock by force.")(
+        "only-metric",
+        boost::program_options::bool_switch(&only_metric)->default_value(false),
+        "Only reload the metric data (weights, durations, CH/MLD search graphs) and keep the "
+        "static data that is currently loaded.")(
+        "huge-pages",
+        boost::program_options::bool_switch(&huge_pages)->default_value(false),
+        "Allocate the shared memory with huge pages to reduce TLB misses of queries. Needs "
+        "reserved huge pages (vm.nr_hugepages), falls back to normal pages otherwise.")(
+        "compress-geometry",
+        boost::program_options::bool_switch(&compress_geometry)->default_value(false),
+        "Store the geometry node lists delta encoded and bit-packed, which needs less memory "
+        "but makes unpacking the geometry of a route a little slower.");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -159,11 +176,16 @@ int main(const int argc, const char *argv[]) try
 
     boost::filesystem::path base_path;
     int max_wait = -1;
-    if (!generateDataStoreOptions(argc, argv, base_path, max_wait))
+    bool only_metric = false;
+    bool huge_pages = false;
+    bool compress_geometry = false;
+    if (!generateDataStoreOptions(
+            argc, argv, base_path, max_wait, only_metric, huge_pages, compress_geometry))
     {
         return EXIT_SUCCESS;
     }
     storage::StorageConfig config(base_path);
+    config.compress_geometry = compress_geometry;
     if (!config.IsValid())
     {
         util::Log(logERROR) << "Config contains invalid file paths. Exiting!";
@@ -171,7 +193,7 @@ int main(const int argc, const char *argv[]) try
     }
     storage::Storage storage(std::move(config));
 
-    return storage.Run(max_wait);
+    return storage.Run(max_wait, only_metric, huge_pages);
 }
 catch (const osrm::RuntimeError &e)
 {
@@ -558,8 +558,18 @@ Updater::NumNodesAndEdges Updater::LoadAndUpdateEdgeExpandedGraph() const
 EdgeID
 Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list,
                                         std::vector<EdgeWeight> &node_weights) const
+{
+    std::vector<NodeID> updated_nodes;
+    return LoadAndUpdateEdgeExpandedGraph(edge_based_edge_list, node_weights, updated_nodes);
+}
+
+EdgeID
+Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &edge_based_edge_list,
+                                        std::vector<EdgeWeight> &node_weights,
+                                        std::vector<NodeID> &updated_nodes) const
 {
     TIMER_START(load_edges);
+    updated_nodes.clear();
 
     EdgeID max_edge_id = 0;
     std::vector<util::Coordinate> coordinates;
@@ -762,9 +772,7 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
                           }
                       });
 
-    const auto update_edge = [&](extractor::EdgeBasedEdge &edge) {
-        const auto node_id = edge.source;
-        const auto geometry_id = node_data.GetGeometryID(node_id);
+    const auto find_updated_segment = [&](const GeometryID geometry_id) {
         auto updated_iter = std::lower_bound(updated_segments.begin(),
                                              updated_segments.end(),
                                              geometry_id,
@@ -774,6 +782,17 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
                                              });
         if (updated_iter != updated_segments.end() && updated_iter->id == geometry_id.id &&
             updated_iter->forward == geometry_id.forward)
+        {
+            return updated_iter;
+        }
+        return updated_segments.end();
+    };
+
+    const auto update_edge = [&](extractor::EdgeBasedEdge &edge) {
+        const auto node_id = edge.source;
+        const auto geometry_id = node_data.GetGeometryID(node_id);
+        auto updated_iter = find_updated_segment(geometry_id);
+        if (updated_iter != updated_segments.end())
         {
             // Find a segment with zero speed and simultaneously compute the new edge
             // weight
@@ -835,6 +854,21 @@ Updater::LoadAndUpdateEdgeExpandedGraph(std::vector<extractor::EdgeBasedEdge> &e
                                   update_edge(edge_based_edge_list[index]);
                               }
                           });
+
+        // edge-based node ids are in [0, max_edge_id]
+        std::vector<std::uint8_t> is_updated(max_edge_id + 1, 0);
+        tbb::parallel_for(tbb::blocked_range<NodeID>(0, max_edge_id + 1), [&](const auto &range) {
+            for (auto node = range.begin(); node < range.end(); ++node)
+            {
+                is_updated[node] = find_updated_segment(node_data.GetGeometryID(node)) !=
+                                   updated_segments.end();
+            }
+        });
+        for (NodeID node = 0; node <= max_edge_id; ++node)
+        {
+            if (is_updated[node])
+                updated_nodes.push_back(node);
+        }
     }
 
     if (update_turn_penalties || update_conditional_turns)
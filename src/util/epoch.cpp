@@ -0,0 +1,110 @@
+#include "util/epoch.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace epoch
+{
+namespace detail
+{
+// 0 marks a thread that is not reading
+std::atomic<std::uint64_t> global_epoch{1};
+thread_local ThreadEpoch *local_epoch = nullptr;
+}
+
+namespace
+{
+// Keeps the counters of all threads. Counters of finished threads are handed to new threads,
+// so a short-lived thread does not grow the registry.
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<detail::ThreadEpoch>> epochs;
+    std::vector<detail::ThreadEpoch *> released;
+};
+
+Registry &registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+// Hands the counter back to the registry when the thread exits
+struct ThreadEpochHandle
+{
+    ~ThreadEpochHandle()
+    {
+        if (detail::local_epoch)
+        {
+            auto &epoch_registry = registry();
+            std::lock_guard<std::mutex> lock(epoch_registry.mutex);
+            epoch_registry.released.push_back(detail::local_epoch);
+            detail::local_epoch = nullptr;
+        }
+    }
+};
+
+thread_local ThreadEpochHandle thread_epoch_handle;
+}
+
+namespace detail
+{
+ThreadEpoch &registerThread()
+{
+    // odr-use the handle so that it is constructed and destroyed with the thread
+    (void)&thread_epoch_handle;
+
+    auto &epoch_registry = registry();
+    std::lock_guard<std::mutex> lock(epoch_registry.mutex);
+    if (epoch_registry.released.empty())
+    {
+        epoch_registry.epochs.emplace_back(new ThreadEpoch());
+        local_epoch = epoch_registry.epochs.back().get();
+    }
+    else
+    {
+        local_epoch = epoch_registry.released.back();
+        epoch_registry.released.pop_back();
+    }
+    return *local_epoch;
+}
+}
+
+void synchronize()
+{
+    // A reader stores its epoch before it reads the protected pointer and the writer replaced
+    // the pointer before it gets here. So either the reader sees the new pointer or we see
+    // its epoch below. Both sides use sequentially consistent operations for that.
+    const auto epoch = detail::global_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+    // Counters are never freed, so they can be checked without holding the lock
+    std::vector<detail::ThreadEpoch *> epochs;
+    {
+        auto &epoch_registry = registry();
+        std::lock_guard<std::mutex> lock(epoch_registry.mutex);
+        epochs.reserve(epoch_registry.epochs.size());
+        for (const auto &thread_epoch : epoch_registry.epochs)
+            epochs.push_back(thread_epoch.get());
+    }
+
+    for (const auto thread_epoch : epochs)
+    {
+        for (;;)
+        {
+            const auto reader_epoch = thread_epoch->epoch.load(std::memory_order_seq_cst);
+            if (reader_epoch == 0 || reader_epoch >= epoch)
+                break;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+}
+}
+}
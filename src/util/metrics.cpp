@@ -0,0 +1,569 @@
+#include "util/metrics.hpp"
+#include "util/msb.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace metrics
+{
+
+namespace detail
+{
+thread_local std::uint64_t settled_nodes = 0;
+}
+
+namespace
+{
+
+// Only written by the owning thread, so plain loads and stores suffice to update it.
+// Other threads may read it concurrently while collecting.
+struct ThreadHistogram
+{
+    void Record(const std::uint64_t value)
+    {
+        auto &bucket = buckets[Histogram::BucketIndex(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sum.store(sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    Histogram Load() const
+    {
+        Histogram::Buckets counts;
+        for (std::size_t index = 0; index < counts.size(); ++index)
+        {
+            counts[index] = buckets[index].load(std::memory_order_relaxed);
+        }
+        return Histogram(counts, sum.load(std::memory_order_relaxed));
+    }
+
+    std::array<std::atomic<std::uint64_t>, Histogram::NUMBER_OF_BUCKETS> buckets;
+    std::atomic<std::uint64_t> sum;
+};
+
+struct ThreadMetrics
+{
+    std::array<ThreadHistogram, NUMBER_OF_ENDPOINTS> request_duration;
+    std::array<std::array<ThreadHistogram, NUMBER_OF_STAGES>, NUMBER_OF_ENDPOINTS>
+        stage_duration;
+    std::array<ThreadHistogram, NUMBER_OF_ENDPOINTS> settled_nodes;
+    std::array<std::atomic<std::uint64_t>, NUMBER_OF_ENDPOINTS> cache_hits;
+    std::array<std::atomic<std::uint64_t>, NUMBER_OF_ENDPOINTS> cache_misses;
+    std::array<ThreadHistogram, NUMBER_OF_ENDPOINTS> queue_wait;
+    std::array<std::atomic<std::uint64_t>, NUMBER_OF_ENDPOINTS> rejected_requests;
+};
+
+// Keeps the metrics of all threads. Metrics of finished threads are handed to new threads,
+// so a short-lived thread does not grow the registry.
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadMetrics>> metrics;
+    std::vector<ThreadMetrics *> released;
+    // requests are queued and dequeued on different threads, so the queue sizes are shared
+    std::array<std::atomic<std::int64_t>, NUMBER_OF_ENDPOINTS> queued_requests{};
+};
+
+Registry &registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+struct ThreadMetricsHandle
+{
+    ~ThreadMetricsHandle()
+    {
+        if (metrics)
+        {
+            auto &metrics_registry = registry();
+            std::lock_guard<std::mutex> lock(metrics_registry.mutex);
+            metrics_registry.released.push_back(metrics);
+        }
+    }
+
+    ThreadMetrics *metrics = nullptr;
+};
+
+thread_local ThreadMetricsHandle thread_metrics;
+thread_local int current_endpoint = -1;
+thread_local StageScope *current_stage = nullptr;
+
+ThreadMetrics &localMetrics()
+{
+    if (!thread_metrics.metrics)
+    {
+        auto &metrics_registry = registry();
+        std::lock_guard<std::mutex> lock(metrics_registry.mutex);
+        if (metrics_registry.released.empty())
+        {
+            // value initialization zeroes all counters
+            metrics_registry.metrics.emplace_back(new ThreadMetrics());
+            thread_metrics.metrics = metrics_registry.metrics.back().get();
+        }
+        else
+        {
+            thread_metrics.metrics = metrics_registry.released.back();
+            metrics_registry.released.pop_back();
+        }
+    }
+    return *thread_metrics.metrics;
+}
+
+std::uint64_t elapsedMicroseconds(const std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+void appendNumber(std::string &out, const double value)
+{
+    char buffer[32];
+    const auto length = std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    out.append(buffer, length);
+}
+
+// Writes the histogram with cumulative buckets at powers of two, which are bucket boundaries.
+// Buckets above the largest recorded value are left out, +Inf always follows.
+void appendHistogram(std::string &out,
+                     const std::string &metric,
+                     const std::string &labels,
+                     const Histogram &histogram,
+                     const double scale)
+{
+    std::size_t last_bucket = 0;
+    for (std::size_t index = 0; index < Histogram::NUMBER_OF_BUCKETS; ++index)
+    {
+        if (histogram.Bucket(index) > 0)
+        {
+            last_bucket = index;
+        }
+    }
+
+    std::uint64_t cumulative = 0;
+    std::size_t index = 0;
+    for (std::uint64_t bound = 1;
+         index <= last_bucket && index < Histogram::NUMBER_OF_BUCKETS - 1;
+         bound *= 2)
+    {
+        for (; index < Histogram::NUMBER_OF_BUCKETS && Histogram::BucketUpperBound(index) <= bound;
+             ++index)
+        {
+            cumulative += histogram.Bucket(index);
+        }
+        out += metric + "_bucket{" + labels + ",le=\"";
+        appendNumber(out, bound * scale);
+        out += "\"} " + std::to_string(cumulative) + "\n";
+    }
+    out += metric + "_bucket{" + labels + ",le=\"+Inf\"} " + std::to_string(histogram.Count()) +
+           "\n";
+
+    out += metric + "_sum{" + labels + "} ";
+    appendNumber(out, histogram.Sum() * scale);
+    out += "\n";
+    out += metric + "_count{" + labels + "} " + std::to_string(histogram.Count()) + "\n";
+}
+
+std::string endpointLabel(const std::size_t endpoint)
+{
+    return std::string("endpoint=\"") + name(static_cast<Endpoint>(endpoint)) + "\"";
+}
+
+void increment(std::array<std::atomic<std::uint64_t>, NUMBER_OF_ENDPOINTS> &counters,
+               const Endpoint endpoint)
+{
+    auto &counter = counters[static_cast<std::size_t>(endpoint)];
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+Endpoint currentEndpoint()
+{
+    return current_endpoint < 0 ? Endpoint::Other : static_cast<Endpoint>(current_endpoint);
+}
+
+void appendCounters(std::string &out,
+                    const std::string &metric,
+                    const std::string &help,
+                    const std::array<std::uint64_t, NUMBER_OF_ENDPOINTS> &counters)
+{
+    out += "# HELP " + metric + " " + help + "\n# TYPE " + metric + " counter\n";
+    for (std::size_t endpoint = 0; endpoint < NUMBER_OF_ENDPOINTS; ++endpoint)
+    {
+        if (counters[endpoint] > 0)
+        {
+            out += metric + "{" + endpointLabel(endpoint) + "} " +
+                   std::to_string(counters[endpoint]) + "\n";
+        }
+    }
+}
+
+const constexpr double MICROSECONDS_TO_SECONDS = 1e-6;
+
+void appendDurationHistograms(std::string &out,
+                              const std::string &metric,
+                              const std::string &help,
+                              const std::array<Histogram, NUMBER_OF_ENDPOINTS> &histograms)
+{
+    out += "# HELP " + metric + " " + help + "\n# TYPE " + metric + " histogram\n";
+    for (std::size_t endpoint = 0; endpoint < NUMBER_OF_ENDPOINTS; ++endpoint)
+    {
+        if (histograms[endpoint].Count() > 0)
+        {
+            appendHistogram(out,
+                            metric,
+                            endpointLabel(endpoint),
+                            histograms[endpoint],
+                            MICROSECONDS_TO_SECONDS);
+        }
+    }
+}
+
+// Quantiles over the whole uptime, computed from the fine grained buckets
+void appendDurationQuantiles(std::string &out,
+                             const std::string &metric,
+                             const std::string &help,
+                             const std::array<Histogram, NUMBER_OF_ENDPOINTS> &histograms)
+{
+    out += "# HELP " + metric + " " + help + "\n# TYPE " + metric + " gauge\n";
+    for (std::size_t endpoint = 0; endpoint < NUMBER_OF_ENDPOINTS; ++endpoint)
+    {
+        const auto &histogram = histograms[endpoint];
+        if (histogram.Count() == 0)
+        {
+            continue;
+        }
+        for (const auto quantile : {0.5, 0.9, 0.99, 0.999})
+        {
+            out += metric + "{" + endpointLabel(endpoint) + ",quantile=\"";
+            appendNumber(out, quantile);
+            out += "\"} ";
+            appendNumber(out, histogram.Quantile(quantile) * MICROSECONDS_TO_SECONDS);
+            out += "\n";
+        }
+    }
+}
+}
+
+const char *name(const Endpoint endpoint)
+{
+    switch (endpoint)
+    {
+    case Endpoint::Route:
+        return "route";
+    case Endpoint::Table:
+        return "table";
+    case Endpoint::Nearest:
+        return "nearest";
+    case Endpoint::Trip:
+        return "trip";
+    case Endpoint::Match:
+        return "match";
+    case Endpoint::Tile:
+        return "tile";
+    case Endpoint::Other:
+        return "other";
+    }
+    return "other";
+}
+
+const char *name(const Stage stage)
+{
+    switch (stage)
+    {
+    case Stage::Snapping:
+        return "snapping";
+    case Stage::Search:
+        return "search";
+    case Stage::Unpacking:
+        return "unpacking";
+    case Stage::Guidance:
+        return "guidance";
+    case Stage::Rendering:
+        return "rendering";
+    }
+    return "unknown";
+}
+
+Endpoint endpointFromService(const std::string &service)
+{
+    for (std::size_t endpoint = 0; endpoint < NUMBER_OF_ENDPOINTS; ++endpoint)
+    {
+        if (service == name(static_cast<Endpoint>(endpoint)))
+        {
+            return static_cast<Endpoint>(endpoint);
+        }
+    }
+    return Endpoint::Other;
+}
+
+Histogram::Histogram(const Buckets &buckets_, const std::uint64_t sum_)
+    : buckets(buckets_), count(0), sum(sum_)
+{
+    for (const auto bucket : buckets)
+    {
+        count += bucket;
+    }
+}
+
+// Values below 4 have their own bucket. Larger values are grouped by their most significant
+// bit and the two bits following it.
+std::size_t Histogram::BucketIndex(const std::uint64_t value)
+{
+    if (value < 4)
+    {
+        return value;
+    }
+    const auto most_significant = msb(value);
+    const auto index = 4 * (most_significant - 1) + ((value >> (most_significant - 2)) & 3);
+    return std::min<std::size_t>(index, NUMBER_OF_BUCKETS - 1);
+}
+
+std::uint64_t Histogram::BucketUpperBound(const std::size_t index)
+{
+    BOOST_ASSERT(index < NUMBER_OF_BUCKETS);
+    if (index < 4)
+    {
+        return index + 1;
+    }
+    if (index == NUMBER_OF_BUCKETS - 1)
+    {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    const auto most_significant = index / 4 + 1;
+    const std::uint64_t sub_bucket = index % 4;
+    return (4 + sub_bucket + 1) << (most_significant - 2);
+}
+
+void Histogram::Merge(const Histogram &other)
+{
+    for (std::size_t index = 0; index < NUMBER_OF_BUCKETS; ++index)
+    {
+        buckets[index] += other.buckets[index];
+    }
+    count += other.count;
+    sum += other.sum;
+}
+
+std::uint64_t Histogram::Quantile(const double quantile) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    const auto rank =
+        std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(quantile * count)));
+    std::uint64_t cumulative = 0;
+    for (std::size_t index = 0; index < NUMBER_OF_BUCKETS; ++index)
+    {
+        cumulative += buckets[index];
+        if (cumulative >= rank)
+        {
+            return BucketUpperBound(index);
+        }
+    }
+    return BucketUpperBound(NUMBER_OF_BUCKETS - 1);
+}
+
+Snapshot collect()
+{
+    Snapshot snapshot;
+
+    auto &metrics_registry = registry();
+    std::lock_guard<std::mutex> lock(metrics_registry.mutex);
+    for (const auto &metrics : metrics_registry.metrics)
+    {
+        for (std::size_t endpoint = 0; endpoint < NUMBER_OF_ENDPOINTS; ++endpoint)
+        {
+            snapshot.request_duration[endpoint].Merge(metrics->request_duration[endpoint].Load());
+            snapshot.settled_nodes[endpoint].Merge(metrics->settled_nodes[endpoint].Load());
+            snapshot.cache_hits[endpoint] +=
+                metrics->cache_hits[endpoint].load(std::memory_order_relaxed);
+            snapshot.cache_misses[endpoint] +=
+                metrics->cache_misses[endpoint].load(std::memory_order_relaxed);
+            snapshot.queue_wait[endpoint].Merge(metrics->queue_wait[endpoint].Load());
+            snapshot.rejected_requests[endpoint] +=
+                metrics->rejected_requests[endpoint].load(std::memory_order_relaxed);
+            for (std::size_t stage = 0; stage < NUMBER_OF_STAGES; ++stage)
+            {
+                snapshot.stage_duration[endpoint][stage].Merge(
+                    metrics->stage_duration[endpoint][stage].Load());
+            }
+        }
+    }
+    for (std::size_t endpoint = 0; endpoint < NUMBER_OF_ENDPOINTS; ++endpoint)
+    {
+        const auto queued =
+            metrics_registry.queued_requests[endpoint].load(std::memory_order_relaxed);
+        snapshot.queue_size[endpoint] =
+            static_cast<std::uint64_t>(std::max<std::int64_t>(0, queued));
+    }
+
+    return snapshot;
+}
+
+std::string renderPrometheus(const Snapshot &snapshot)
+{
+    std::string out;
+
+    appendDurationHistograms(out,
+                             "osrm_request_duration_seconds",
+                             "Time spent handling requests.",
+                             snapshot.request_duration);
+    appendDurationQuantiles(out,
+                            "osrm_request_duration_quantile_seconds",
+                            "Request duration quantiles.",
+                            snapshot.request_duration);
+
+    out += "# HELP osrm_stage_duration_seconds Time spent in the stages of a request.\n"
+           "# TYPE osrm_stage_duration_seconds histogram\n";
+    for (std::size_t endpoint = 0; endpoint < NUMBER_OF_ENDPOINTS; ++endpoint)
+    {
+        for (std::size_t stage = 0; stage < NUMBER_OF_STAGES; ++stage)
+        {
+            const auto &histogram = snapshot.stage_duration[endpoint][stage];
+            if (histogram.Count() > 0)
+            {
+                appendHistogram(out,
+                                "osrm_stage_duration_seconds",
+                                endpointLabel(endpoint) + ",stage=\"" +
+                                    name(static_cast<Stage>(stage)) + "\"",
+                                histogram,
+                                MICROSECONDS_TO_SECONDS);
+            }
+        }
+    }
+
+    out += "# HELP osrm_settled_nodes Number of nodes settled by the searches of a request.\n"
+           "# TYPE osrm_settled_nodes histogram\n";
+    for (std::size_t endpoint = 0; endpoint < NUMBER_OF_ENDPOINTS; ++endpoint)
+    {
+        const auto &histogram = snapshot.settled_nodes[endpoint];
+        if (histogram.Count() > 0)
+        {
+            appendHistogram(
+                out, "osrm_settled_nodes", endpointLabel(endpoint), histogram, 1.0);
+        }
+    }
+
+    appendCounters(out,
+                   "osrm_result_cache_hits_total",
+                   "Requests answered from the result cache.",
+                   snapshot.cache_hits);
+    appendCounters(out,
+                   "osrm_result_cache_misses_total",
+                   "Requests not found in the result cache.",
+                   snapshot.cache_misses);
+
+    appendDurationHistograms(out,
+                             "osrm_request_queue_wait_seconds",
+                             "Time requests waited in the queue for a compute thread.",
+                             snapshot.queue_wait);
+    appendDurationQuantiles(out,
+                            "osrm_request_queue_wait_quantile_seconds",
+                            "Queue wait quantiles.",
+                            snapshot.queue_wait);
+    appendCounters(out,
+                   "osrm_requests_rejected_total",
+                   "Requests rejected because the queue was full.",
+                   snapshot.rejected_requests);
+
+    out += "# HELP osrm_request_queue_size Requests waiting for a compute thread.\n"
+           "# TYPE osrm_request_queue_size gauge\n";
+    for (std::size_t endpoint = 0; endpoint < NUMBER_OF_ENDPOINTS; ++endpoint)
+    {
+        out += "osrm_request_queue_size{" + endpointLabel(endpoint) + "} " +
+               std::to_string(snapshot.queue_size[endpoint]) + "\n";
+    }
+
+    return out;
+}
+
+void countCacheHit() { increment(localMetrics().cache_hits, currentEndpoint()); }
+
+void countCacheMiss() { increment(localMetrics().cache_misses, currentEndpoint()); }
+
+void recordQueueWait(const Endpoint endpoint, const std::uint64_t microseconds)
+{
+    localMetrics().queue_wait[static_cast<std::size_t>(endpoint)].Record(microseconds);
+}
+
+void countRejectedRequest(const Endpoint endpoint)
+{
+    increment(localMetrics().rejected_requests, endpoint);
+}
+
+void addQueuedRequests(const Endpoint endpoint, const std::int64_t count)
+{
+    registry().queued_requests[static_cast<std::size_t>(endpoint)].fetch_add(
+        count, std::memory_order_relaxed);
+}
+
+RequestScope::RequestScope(const Endpoint endpoint_)
+    : outermost(current_endpoint < 0), endpoint(endpoint_)
+{
+    if (outermost)
+    {
+        current_endpoint = static_cast<int>(endpoint);
+        settled_nodes_start = detail::settled_nodes;
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+RequestScope::~RequestScope()
+{
+    if (!outermost)
+    {
+        return;
+    }
+
+    const auto duration = std::chrono::steady_clock::now() - start;
+    auto &metrics = localMetrics();
+    const auto index = static_cast<std::size_t>(endpoint);
+    metrics.request_duration[index].Record(elapsedMicroseconds(duration));
+    metrics.settled_nodes[index].Record(detail::settled_nodes - settled_nodes_start);
+    current_endpoint = -1;
+}
+
+StageScope::StageScope(const Stage stage_)
+    : active(current_endpoint >= 0), stage(stage_), parent(nullptr), nested(0)
+{
+    if (active)
+    {
+        parent = current_stage;
+        current_stage = this;
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+StageScope::~StageScope()
+{
+    if (!active)
+    {
+        return;
+    }
+
+    const auto duration = std::chrono::steady_clock::now() - start;
+    auto &metrics = localMetrics();
+    metrics.stage_duration[current_endpoint][static_cast<std::size_t>(stage)].Record(
+        elapsedMicroseconds(duration - nested));
+
+    if (parent)
+    {
+        parent->nested += duration;
+    }
+    current_stage = parent;
+}
+}
+}
+}
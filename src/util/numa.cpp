@@ -0,0 +1,205 @@
+#include "util/numa.hpp"
+
+#include "util/log.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+namespace numa
+{
+
+namespace
+{
+// The nodes with CPUs, numbered by their position in the list
+struct Topology
+{
+    std::vector<unsigned> node_ids;
+    std::vector<std::vector<unsigned>> node_cpus;
+    // node index of every CPU
+    std::vector<unsigned> cpu_nodes;
+};
+
+// Parses CPU lists like "0-3,8,10-11"
+std::vector<unsigned> parseCPUList(const std::string &list)
+{
+    std::vector<unsigned> cpus;
+    std::size_t begin = 0;
+    while (begin < list.size())
+    {
+        auto end = list.find(',', begin);
+        if (end == std::string::npos)
+            end = list.size();
+
+        const auto range = list.substr(begin, end - begin);
+        const auto dash = range.find('-');
+        try
+        {
+            const auto first = std::stoul(range.substr(0, dash));
+            const auto last =
+                dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+            for (auto cpu = first; cpu <= last; ++cpu)
+                cpus.push_back(cpu);
+        }
+        catch (const std::exception &)
+        {
+            // whitespace at the end
+        }
+        begin = end + 1;
+    }
+    return cpus;
+}
+
+Topology readTopology()
+{
+    Topology topology;
+#ifdef __linux__
+    const boost::filesystem::path nodes_path{"/sys/devices/system/node"};
+    boost::system::error_code error;
+    std::vector<unsigned> node_ids;
+    const auto is_digit = [](const char c) { return std::isdigit(static_cast<unsigned char>(c)); };
+    boost::filesystem::directory_iterator entry(nodes_path, error), end;
+    for (; !error && entry != end; entry.increment(error))
+    {
+        const auto name = entry->path().filename().string();
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+            std::all_of(name.begin() + 4, name.end(), is_digit))
+        {
+            node_ids.push_back(std::stoul(name.substr(4)));
+        }
+    }
+    std::sort(node_ids.begin(), node_ids.end());
+
+    for (const auto node_id : node_ids)
+    {
+        boost::filesystem::ifstream cpulist_file(nodes_path / ("node" + std::to_string(node_id)) /
+                                                 "cpulist");
+        if (!cpulist_file)
+            continue;
+
+        std::string cpulist;
+        std::getline(cpulist_file, cpulist);
+        auto cpus = parseCPUList(cpulist);
+        if (cpus.empty())
+            continue;
+
+        const auto node = static_cast<unsigned>(topology.node_ids.size());
+        for (const auto cpu : cpus)
+        {
+            if (cpu >= topology.cpu_nodes.size())
+                topology.cpu_nodes.resize(cpu + 1, 0);
+            topology.cpu_nodes[cpu] = node;
+        }
+        topology.node_ids.push_back(node_id);
+        topology.node_cpus.push_back(std::move(cpus));
+    }
+#endif
+
+    if (topology.node_ids.empty())
+    {
+        topology.node_ids.push_back(0);
+        topology.node_cpus.emplace_back();
+    }
+    return topology;
+}
+
+const Topology &getTopology()
+{
+    static const Topology topology = readTopology();
+    return topology;
+}
+
+// node of the calling thread if it is pinned, -1 otherwise
+thread_local int pinned_node = -1;
+}
+
+unsigned getNodeCount() { return getTopology().node_ids.size(); }
+
+unsigned getCurrentNode()
+{
+    if (pinned_node >= 0)
+        return pinned_node;
+
+#ifdef __linux__
+    const auto &topology = getTopology();
+    const auto cpu = ::sched_getcpu();
+    if (cpu >= 0 && static_cast<std::size_t>(cpu) < topology.cpu_nodes.size())
+        return topology.cpu_nodes[cpu];
+#endif
+    return 0;
+}
+
+bool pinThreadToNode(const unsigned node)
+{
+    const auto &topology = getTopology();
+    if (node >= topology.node_ids.size())
+        return false;
+
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (const auto cpu : topology.node_cpus[node])
+    {
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &cpu_set);
+    }
+    if (CPU_COUNT(&cpu_set) == 0 ||
+        ::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set), &cpu_set) != 0)
+    {
+        util::Log(logWARNING) << "Could not pin thread to NUMA node "
+                              << topology.node_ids[node];
+        return false;
+    }
+    pinned_node = node;
+    return true;
+#else
+    pinned_node = node;
+    return topology.node_ids.size() == 1;
+#endif
+}
+
+bool bindMemoryToNode(void *memory, const std::size_t size, const unsigned node)
+{
+    const auto &topology = getTopology();
+    if (node >= topology.node_ids.size())
+        return false;
+
+#ifdef __linux__
+    const auto node_id = topology.node_ids[node];
+    const auto bits_per_word = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> node_mask(node_id / bits_per_word + 1, 0);
+    node_mask[node_id / bits_per_word] |= 1ul << (node_id % bits_per_word);
+
+    // the kernel ignores the last bit of maxnode
+    const auto max_node = node_mask.size() * bits_per_word + 1;
+    if (::syscall(SYS_mbind, memory, size, MPOL_BIND, node_mask.data(), max_node, 0) != 0)
+    {
+        util::Log(logWARNING) << "Could not bind memory to NUMA node " << node_id;
+        return false;
+    }
+    return true;
+#else
+    (void)memory;
+    (void)size;
+    return topology.node_ids.size() == 1;
+#endif
+}
+}
+}
+}
@@ -0,0 +1,232 @@
+#include "util/segment_projection.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OSRM_PROJECTION_SIMD
+#include <immintrin.h>
+#endif
+
+namespace osrm
+{
+namespace util
+{
+namespace detail
+{
+
+namespace
+{
+// The segments and the coordinate are integers in fixed point, so a segment has no length
+// exactly if the squared length is zero.
+// Rounds to the nearest even integer on ties like the SIMD conversions.
+void projectScalar(const std::int32_t *u_lon,
+                   const std::int32_t *u_lat,
+                   const std::int32_t *v_lon,
+                   const std::int32_t *v_lat,
+                   const std::size_t begin,
+                   const std::size_t end,
+                   const double lon,
+                   const double lat,
+                   std::int32_t *nearest_lon,
+                   std::int32_t *nearest_lat)
+{
+    for (auto i = begin; i < end; ++i)
+    {
+        const double source_lon = u_lon[i];
+        const double source_lat = u_lat[i];
+        const double slope_lon = v_lon[i] - source_lon;
+        const double slope_lat = v_lat[i] - source_lat;
+
+        const auto squared_length = slope_lon * slope_lon + slope_lat * slope_lat;
+        double ratio = 0;
+        if (squared_length > 0)
+        {
+            const auto unnormed_ratio =
+                slope_lon * (lon - source_lon) + slope_lat * (lat - source_lat);
+            ratio = std::min(std::max(unnormed_ratio / squared_length, 0.), 1.);
+        }
+
+        nearest_lon[i] = static_cast<std::int32_t>(std::nearbyint(source_lon + ratio * slope_lon));
+        nearest_lat[i] = static_cast<std::int32_t>(std::nearbyint(source_lat + ratio * slope_lat));
+    }
+}
+
+#ifdef OSRM_PROJECTION_SIMD
+// lambdas do not inherit the target of the function, so the helpers are functions
+__attribute__((target("sse2"))) inline __m128d loadSSE2(const std::int32_t *values)
+{
+    return _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(values)));
+}
+
+__attribute__((target("sse2"))) inline void storeSSE2(std::int32_t *values, const __m128d rounded)
+{
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(values), _mm_cvtpd_epi32(rounded));
+}
+
+__attribute__((target("avx2"))) inline __m256d loadAVX2(const std::int32_t *values)
+{
+    return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values)));
+}
+
+__attribute__((target("avx2"))) inline void storeAVX2(std::int32_t *values, const __m256d rounded)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(values), _mm256_cvtpd_epi32(rounded));
+}
+
+__attribute__((target("sse2"))) void projectSSE2(const std::int32_t *u_lon,
+                                                 const std::int32_t *u_lat,
+                                                 const std::int32_t *v_lon,
+                                                 const std::int32_t *v_lat,
+                                                 const std::size_t number_of_segments,
+                                                 const double lon,
+                                                 const double lat,
+                                                 std::int32_t *nearest_lon,
+                                                 std::int32_t *nearest_lat)
+{
+    const auto input_lon = _mm_set1_pd(lon);
+    const auto input_lat = _mm_set1_pd(lat);
+    const auto zero = _mm_setzero_pd();
+    const auto one = _mm_set1_pd(1.);
+
+    std::size_t i = 0;
+    for (; i + 2 <= number_of_segments; i += 2)
+    {
+        const auto source_lon = loadSSE2(u_lon + i);
+        const auto source_lat = loadSSE2(u_lat + i);
+        const auto slope_lon = _mm_sub_pd(loadSSE2(v_lon + i), source_lon);
+        const auto slope_lat = _mm_sub_pd(loadSSE2(v_lat + i), source_lat);
+
+        const auto squared_length =
+            _mm_add_pd(_mm_mul_pd(slope_lon, slope_lon), _mm_mul_pd(slope_lat, slope_lat));
+        const auto unnormed_ratio =
+            _mm_add_pd(_mm_mul_pd(slope_lon, _mm_sub_pd(input_lon, source_lon)),
+                       _mm_mul_pd(slope_lat, _mm_sub_pd(input_lat, source_lat)));
+        // segments without length divide by zero, the mask sets their ratio to 0
+        const auto has_length = _mm_cmpgt_pd(squared_length, zero);
+        const auto ratio = _mm_and_pd(
+            has_length,
+            _mm_min_pd(_mm_max_pd(_mm_div_pd(unnormed_ratio, squared_length), zero), one));
+
+        storeSSE2(nearest_lon + i, _mm_add_pd(source_lon, _mm_mul_pd(ratio, slope_lon)));
+        storeSSE2(nearest_lat + i, _mm_add_pd(source_lat, _mm_mul_pd(ratio, slope_lat)));
+    }
+
+    projectScalar(
+        u_lon, u_lat, v_lon, v_lat, i, number_of_segments, lon, lat, nearest_lon, nearest_lat);
+}
+
+__attribute__((target("avx2"))) void projectAVX2(const std::int32_t *u_lon,
+                                                 const std::int32_t *u_lat,
+                                                 const std::int32_t *v_lon,
+                                                 const std::int32_t *v_lat,
+                                                 const std::size_t number_of_segments,
+                                                 const double lon,
+                                                 const double lat,
+                                                 std::int32_t *nearest_lon,
+                                                 std::int32_t *nearest_lat)
+{
+    const auto input_lon = _mm256_set1_pd(lon);
+    const auto input_lat = _mm256_set1_pd(lat);
+    const auto zero = _mm256_setzero_pd();
+    const auto one = _mm256_set1_pd(1.);
+
+    std::size_t i = 0;
+    for (; i + 4 <= number_of_segments; i += 4)
+    {
+        const auto source_lon = loadAVX2(u_lon + i);
+        const auto source_lat = loadAVX2(u_lat + i);
+        const auto slope_lon = _mm256_sub_pd(loadAVX2(v_lon + i), source_lon);
+        const auto slope_lat = _mm256_sub_pd(loadAVX2(v_lat + i), source_lat);
+
+        const auto squared_length = _mm256_add_pd(_mm256_mul_pd(slope_lon, slope_lon),
+                                                  _mm256_mul_pd(slope_lat, slope_lat));
+        const auto unnormed_ratio =
+            _mm256_add_pd(_mm256_mul_pd(slope_lon, _mm256_sub_pd(input_lon, source_lon)),
+                          _mm256_mul_pd(slope_lat, _mm256_sub_pd(input_lat, source_lat)));
+        // segments without length divide by zero, the mask sets their ratio to 0
+        const auto has_length = _mm256_cmp_pd(squared_length, zero, _CMP_GT_OQ);
+        const auto ratio = _mm256_and_pd(
+            has_length,
+            _mm256_min_pd(_mm256_max_pd(_mm256_div_pd(unnormed_ratio, squared_length), zero),
+                          one));
+
+        storeAVX2(nearest_lon + i, _mm256_add_pd(source_lon, _mm256_mul_pd(ratio, slope_lon)));
+        storeAVX2(nearest_lat + i, _mm256_add_pd(source_lat, _mm256_mul_pd(ratio, slope_lat)));
+    }
+
+    projectScalar(
+        u_lon, u_lat, v_lon, v_lat, i, number_of_segments, lon, lat, nearest_lon, nearest_lat);
+}
+#endif
+}
+
+ProjectionKernel getProjectionKernel()
+{
+#ifdef OSRM_PROJECTION_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return ProjectionKernel::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return ProjectionKernel::SSE2;
+#endif
+    return ProjectionKernel::Scalar;
+}
+
+void projectPointOnSegments(const ProjectionKernel kernel,
+                            const std::int32_t *u_lon,
+                            const std::int32_t *u_lat,
+                            const std::int32_t *v_lon,
+                            const std::int32_t *v_lat,
+                            const std::size_t number_of_segments,
+                            const Coordinate coordinate,
+                            std::int32_t *nearest_lon,
+                            std::int32_t *nearest_lat)
+{
+    const double lon = static_cast<std::int32_t>(coordinate.lon);
+    const double lat = static_cast<std::int32_t>(coordinate.lat);
+
+    switch (kernel)
+    {
+#ifdef OSRM_PROJECTION_SIMD
+    case ProjectionKernel::AVX2:
+        projectAVX2(
+            u_lon, u_lat, v_lon, v_lat, number_of_segments, lon, lat, nearest_lon, nearest_lat);
+        break;
+    case ProjectionKernel::SSE2:
+        projectSSE2(
+            u_lon, u_lat, v_lon, v_lat, number_of_segments, lon, lat, nearest_lon, nearest_lat);
+        break;
+#endif
+    default:
+        BOOST_ASSERT(kernel == ProjectionKernel::Scalar);
+        projectScalar(
+            u_lon, u_lat, v_lon, v_lat, 0, number_of_segments, lon, lat, nearest_lon, nearest_lat);
+    }
+}
+}
+
+void projectPointOnSegments(const std::int32_t *u_lon,
+                            const std::int32_t *u_lat,
+                            const std::int32_t *v_lon,
+                            const std::int32_t *v_lat,
+                            const std::size_t number_of_segments,
+                            const Coordinate coordinate,
+                            std::int32_t *nearest_lon,
+                            std::int32_t *nearest_lat)
+{
+    static const auto kernel = detail::getProjectionKernel();
+    detail::projectPointOnSegments(kernel,
+                                   u_lon,
+                                   u_lat,
+                                   v_lon,
+                                   v_lat,
+                                   number_of_segments,
+                                   coordinate,
+                                   nearest_lon,
+                                   nearest_lat);
+}
+}
+}
@@ -0,0 +1,125 @@
+#include <boost/test/unit_test.hpp>
+
+#include "contractor/renumber.hpp"
+
+#include "../common/range_tools.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace osrm;
+using namespace osrm::contractor;
+
+namespace
+{
+QueryEdge makeEdge(const NodeID source, const NodeID target, const bool shortcut, const NodeID id)
+{
+    QueryEdge::EdgeData data;
+    data.shortcut = shortcut;
+    data.turn_id = id;
+    data.weight = 1;
+    data.duration = 1;
+    data.forward = true;
+    return QueryEdge{source, target, data};
+}
+
+// Every edge leads from a contracted node to a higher node:
+//
+//   node   level   edges to
+//     4    core
+//     6    core    4
+//     1    5
+//     0    3       1
+//     3    2       1
+//     5    1       0
+//     2    0       6
+//
+// The core nodes 4 and 6 have arbitrary levels, the core marker takes precedence.
+struct Hierarchy
+{
+    Hierarchy()
+    {
+        edges.push_back(makeEdge(0, 1, false, 10));
+        edges.push_back(makeEdge(2, 6, false, 11));
+        edges.push_back(makeEdge(3, 1, false, 12));
+        edges.push_back(makeEdge(5, 0, false, 13));
+        edges.push_back(makeEdge(6, 4, false, 14));
+    }
+
+    const NodeID number_of_nodes = 7;
+    util::DeallocatingVector<QueryEdge> edges;
+    const std::vector<float> node_levels = {3, 5, 0, 2, 0, 1, 0};
+    const std::vector<bool> is_core_node = {false, false, false, false, true, false, true};
+};
+}
+
+BOOST_AUTO_TEST_SUITE(renumber_tests)
+
+BOOST_FIXTURE_TEST_CASE(permutation_is_bijection, Hierarchy)
+{
+    auto permutation = makePermutation(number_of_nodes, edges, node_levels, is_core_node);
+    BOOST_REQUIRE_EQUAL(permutation.size(), number_of_nodes);
+
+    std::sort(permutation.begin(), permutation.end());
+    std::vector<NodeID> identity(number_of_nodes);
+    std::iota(identity.begin(), identity.end(), 0);
+    CHECK_EQUAL_COLLECTIONS(permutation, identity);
+}
+
+BOOST_FIXTURE_TEST_CASE(core_comes_first, Hierarchy)
+{
+    const auto permutation = makePermutation(number_of_nodes, edges, node_levels, is_core_node);
+
+    // in their original order
+    BOOST_CHECK_EQUAL(permutation[4], 0);
+    BOOST_CHECK_EQUAL(permutation[6], 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(depth_first_from_highest_level, Hierarchy)
+{
+    // core 4 and 6 first, then the subtree of the core (2), then the subtree of the
+    // highest node 1 depth-first: 1, 0, 5 and 3
+    // node:                                0  1  2  3  4  5  6
+    const auto permutation = makePermutation(number_of_nodes, edges, node_levels, is_core_node);
+    CHECK_EQUAL_RANGE(permutation, 4, 3, 2, 6, 0, 5, 1);
+
+    // without a core the nodes are ordered by level only, 6 is searched from 4
+    // node:                              0  1  2  3  4  5  6
+    const auto no_core = makePermutation(number_of_nodes, edges, node_levels, {});
+    CHECK_EQUAL_RANGE(no_core, 1, 0, 4, 3, 5, 2, 6);
+}
+
+BOOST_FIXTURE_TEST_CASE(renumber_edges, Hierarchy)
+{
+    const auto permutation = makePermutation(number_of_nodes, edges, node_levels, is_core_node);
+
+    util::DeallocatingVector<QueryEdge> query_edges;
+    // a shortcut from 5 to 1 over its middle node 0
+    query_edges.push_back(makeEdge(5, 1, true, 0));
+    // an original edge stores the ID of its turn, which is not a node
+    query_edges.push_back(makeEdge(3, 1, false, 3));
+    renumber(query_edges, permutation);
+
+    // sorted by the new source
+    BOOST_REQUIRE_EQUAL(query_edges.size(), 2);
+    BOOST_CHECK_EQUAL(query_edges[0].source, permutation[5]);
+    BOOST_CHECK_EQUAL(query_edges[0].target, permutation[1]);
+    BOOST_CHECK(query_edges[0].data.shortcut);
+    BOOST_CHECK_EQUAL(query_edges[0].data.turn_id, permutation[0]);
+
+    BOOST_CHECK_EQUAL(query_edges[1].source, permutation[3]);
+    BOOST_CHECK_EQUAL(query_edges[1].target, permutation[1]);
+    BOOST_CHECK(!query_edges[1].data.shortcut);
+    BOOST_CHECK_EQUAL(query_edges[1].data.turn_id, 3);
+
+    auto core = is_core_node;
+    renumber(core, permutation);
+    CHECK_EQUAL_RANGE(core, true, true, false, false, false, false, false);
+
+    auto levels = node_levels;
+    renumber(levels, permutation);
+    CHECK_EQUAL_RANGE(levels, 0, 0, 0, 5, 3, 1, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
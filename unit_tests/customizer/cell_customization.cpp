@@ -6,6 +6,8 @@
 #include "partition/multi_level_partition.hpp"
 #include "util/static_graph.hpp"
 
+#include <random>
+
 using namespace osrm;
 using namespace osrm::customizer;
 using namespace osrm::partition;
@@ -42,6 +44,76 @@ auto makeGraph(const MultiLevelPartition &mlp, const std::vector<MockEdge> &mock
     return partition::MultiLevelGraph<EdgeData, osrm::storage::Ownership::Container>(
         mlp, max_id + 1, edges);
 }
+
+// Unique random edges between the given number of nodes
+std::vector<MockEdge> makeRandomEdges(const std::size_t number_of_nodes,
+                                      const std::size_t number_of_edges)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<NodeID> node_distribution(0, number_of_nodes - 1);
+    std::uniform_int_distribution<EdgeWeight> weight_distribution(1, 10);
+    std::vector<MockEdge> edges;
+    for (std::size_t index = 0; index < number_of_edges; ++index)
+    {
+        const auto start = node_distribution(generator);
+        const auto target = node_distribution(generator);
+        if (start != target)
+        {
+            edges.push_back({start, target, weight_distribution(generator)});
+        }
+    }
+    // MultiLevelGraph expects unique edges
+    std::sort(edges.begin(), edges.end(), [](const MockEdge &lhs, const MockEdge &rhs) {
+        return std::tie(lhs.start, lhs.target) < std::tie(rhs.start, rhs.target);
+    });
+    edges.erase(std::unique(edges.begin(),
+                            edges.end(),
+                            [](const MockEdge &lhs, const MockEdge &rhs) {
+                                return lhs.start == rhs.start && lhs.target == rhs.target;
+                            }),
+                edges.end());
+    return edges;
+}
+
+// Triples the weights of all outgoing edges of the given nodes
+std::vector<MockEdge> updateEdges(std::vector<MockEdge> edges, const std::vector<NodeID> &nodes)
+{
+    for (auto &edge : edges)
+    {
+        if (std::find(nodes.begin(), nodes.end(), edge.start) != nodes.end())
+        {
+            edge.weight *= 3;
+        }
+    }
+    return edges;
+}
+
+// Number of cell sources with different weights or durations
+std::size_t countDifferentSources(const MultiLevelPartition &mlp,
+                                  const CellStorage &lhs,
+                                  const CellStorage &rhs)
+{
+    std::size_t number_of_sources = 0;
+    for (LevelID level = 1; level < mlp.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < mlp.GetNumberOfCells(level); ++id)
+        {
+            const auto lhs_cell = lhs.GetCell(level, id);
+            const auto rhs_cell = rhs.GetCell(level, id);
+            for (const auto source : lhs_cell.GetSourceNodes())
+            {
+                const auto lhs_weights = lhs_cell.GetOutWeight(source);
+                const auto rhs_weights = rhs_cell.GetOutWeight(source);
+                const auto lhs_durations = lhs_cell.GetOutDuration(source);
+                const auto rhs_durations = rhs_cell.GetOutDuration(source);
+                number_of_sources +=
+                    !std::equal(lhs_weights.begin(), lhs_weights.end(), rhs_weights.begin()) ||
+                    !std::equal(lhs_durations.begin(), lhs_durations.end(), rhs_durations.begin());
+            }
+        }
+    }
+    return number_of_sources;
+}
 }
 
 BOOST_AUTO_TEST_SUITE(cell_customization_tests)
@@ -270,4 +342,145 @@ BOOST_AUTO_TEST_CASE(four_levels_test)
     CHECK_EQUAL_COLLECTIONS(cell_2_1.GetInWeight(12), storage_rec.GetCell(2, 1).GetInWeight(12));
 }
 
+BOOST_AUTO_TEST_CASE(parallel_customization_test)
+{
+    // large cells on the higher levels split their searches across threads
+    const std::size_t number_of_nodes = 400;
+    std::vector<CellID> l1(number_of_nodes), l2(number_of_nodes), l3(number_of_nodes);
+    for (std::size_t node = 0; node < number_of_nodes; ++node)
+    {
+        l1[node] = node / 10;
+        l2[node] = node / 100;
+        l3[node] = node / 200;
+    }
+    MultiLevelPartition mlp{{l1, l2, l3}, {40, 4, 2}};
+
+    const auto edges = makeRandomEdges(number_of_nodes, 3000);
+
+    auto graph = makeGraph(mlp, edges);
+
+    CellCustomizer customizer(mlp);
+    CellCustomizer::Heap heap(graph.GetNumberOfNodes());
+    CellStorage storage(mlp, graph);
+    for (LevelID level = 1; level < mlp.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < mlp.GetNumberOfCells(level); ++id)
+        {
+            customizer.Customize(graph, heap, storage, level, id);
+        }
+    }
+
+    CellStorage storage_parallel(mlp, graph);
+    customizer.Customize(graph, storage_parallel);
+
+    BOOST_CHECK_GE(storage.GetCell(3, 0).GetSourceNodes().size(), 64);
+    for (LevelID level = 1; level < mlp.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < mlp.GetNumberOfCells(level); ++id)
+        {
+            const auto cell = storage.GetCell(level, id);
+            const auto cell_parallel = storage_parallel.GetCell(level, id);
+            for (const auto source : cell.GetSourceNodes())
+            {
+                CHECK_EQUAL_COLLECTIONS(cell.GetOutWeight(source),
+                                        cell_parallel.GetOutWeight(source));
+                CHECK_EQUAL_COLLECTIONS(cell.GetOutDuration(source),
+                                        cell_parallel.GetOutDuration(source));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(incremental_customization_test)
+{
+    const std::size_t number_of_nodes = 400;
+    std::vector<CellID> l1(number_of_nodes), l2(number_of_nodes), l3(number_of_nodes);
+    for (std::size_t node = 0; node < number_of_nodes; ++node)
+    {
+        l1[node] = node / 10;
+        l2[node] = node / 100;
+        l3[node] = node / 200;
+    }
+    MultiLevelPartition mlp{{l1, l2, l3}, {40, 4, 2}};
+
+    auto edges = makeRandomEdges(number_of_nodes, 3000);
+    CellCustomizer customizer(mlp);
+
+    CellStorage storage(mlp, makeGraph(mlp, edges));
+    customizer.Customize(makeGraph(mlp, edges), storage);
+
+    // change the weights of all outgoing edges of a few nodes
+    const std::vector<NodeID> updated_nodes = {5, 123, 321};
+    for (auto &edge : edges)
+    {
+        if (std::find(updated_nodes.begin(), updated_nodes.end(), edge.start) !=
+            updated_nodes.end())
+        {
+            edge.weight *= 3;
+        }
+    }
+    const auto graph = makeGraph(mlp, edges);
+
+    CellStorage storage_full(mlp, graph);
+    customizer.Customize(graph, storage_full);
+
+    const auto number_of_cells = customizer.Customize(graph, storage, updated_nodes);
+    BOOST_CHECK_GT(number_of_cells, 0);
+    BOOST_CHECK_LT(number_of_cells, 40 + 4 + 2);
+
+    for (LevelID level = 1; level < mlp.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < mlp.GetNumberOfCells(level); ++id)
+        {
+            const auto cell = storage.GetCell(level, id);
+            const auto cell_full = storage_full.GetCell(level, id);
+            for (const auto source : cell.GetSourceNodes())
+            {
+                CHECK_EQUAL_COLLECTIONS(cell.GetOutWeight(source), cell_full.GetOutWeight(source));
+                CHECK_EQUAL_COLLECTIONS(cell.GetOutDuration(source),
+                                        cell_full.GetOutDuration(source));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(incremental_customization_dropped_update_test)
+{
+    const std::size_t number_of_nodes = 400;
+    std::vector<CellID> l1(number_of_nodes), l2(number_of_nodes), l3(number_of_nodes);
+    for (std::size_t node = 0; node < number_of_nodes; ++node)
+    {
+        l1[node] = node / 10;
+        l2[node] = node / 100;
+        l3[node] = node / 200;
+    }
+    MultiLevelPartition mlp{{l1, l2, l3}, {40, 4, 2}};
+
+    // every run applies its updates to the original weights
+    const auto edges = makeRandomEdges(number_of_nodes, 3000);
+    const std::vector<NodeID> first_updated_nodes = {5, 123};
+    const std::vector<NodeID> second_updated_nodes = {123, 321};
+    CellCustomizer customizer(mlp);
+
+    const auto first_graph = makeGraph(mlp, updateEdges(edges, first_updated_nodes));
+    CellStorage storage(mlp, first_graph);
+    customizer.Customize(first_graph, storage);
+    CellStorage storage_stale(mlp, first_graph);
+    customizer.Customize(first_graph, storage_stale);
+
+    // the second run drops the update of node 5
+    const auto graph = makeGraph(mlp, updateEdges(edges, second_updated_nodes));
+    CellStorage storage_full(mlp, graph);
+    customizer.Customize(graph, storage_full);
+
+    // the cells of node 5 keep the weights of the first run without the updates of that run
+    customizer.Customize(graph, storage_stale, second_updated_nodes);
+    BOOST_CHECK_GT(countDifferentSources(mlp, storage_stale, storage_full), 0);
+
+    const std::vector<NodeID> dirty_nodes = {5, 123, 321};
+    const auto number_of_cells = customizer.Customize(graph, storage, dirty_nodes);
+    BOOST_CHECK_LT(number_of_cells, 40 + 4 + 2);
+    BOOST_CHECK_EQUAL(countDifferentSources(mlp, storage, storage_full), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,86 @@
+#include "engine/datafacade/numa_replica_allocator.hpp"
+#include "util/numa.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(numa_replica_allocator)
+
+using namespace osrm;
+using namespace osrm::engine::datafacade;
+using storage::DataLayout;
+
+namespace
+{
+// Holds one metric and one static block in process memory
+class TestAllocator : public ContiguousBlockAllocator
+{
+  public:
+    TestAllocator()
+    {
+        layout.SetBlockSize<std::uint32_t>(DataLayout::MLD_CELL_WEIGHTS, 1000);
+        layout.SetBlockSize<std::uint64_t>(DataLayout::NAME_CHAR_DATA, 10);
+        for (auto i = 0; i < DataLayout::NUM_BLOCKS; i++)
+        {
+            if (layout.entry_align[i] == 0)
+                layout.SetBlockSize<char>(static_cast<DataLayout::BlockID>(i), 0);
+        }
+
+        memory.reset(new char[layout.GetSizeOfLayout()]);
+        for (auto i = 0; i < DataLayout::NUM_BLOCKS; i++)
+            layout.GetBlockPtr<char, true>(memory.get(), static_cast<DataLayout::BlockID>(i));
+
+        auto weights =
+            layout.GetBlockPtr<std::uint32_t>(memory.get(), DataLayout::MLD_CELL_WEIGHTS);
+        std::iota(weights, weights + 1000, 7);
+    }
+
+    DataLayout &GetLayout() override final { return layout; }
+    char *GetMemory() override final { return memory.get(); }
+
+    DataLayout layout;
+    std::unique_ptr<char[]> memory;
+};
+}
+
+BOOST_AUTO_TEST_CASE(replicates_metric_blocks)
+{
+    const auto source = std::make_shared<TestAllocator>();
+    NumaReplicaAllocator replica(source, 0);
+
+    // the static blocks are shared
+    BOOST_CHECK_EQUAL(replica.GetMemory(), source->GetMemory());
+    BOOST_CHECK_NE(replica.GetMetricMemory(), source->GetMetricMemory());
+
+    auto &layout = replica.GetMetricLayout();
+    BOOST_CHECK_EQUAL(layout.GetBlockEntries(DataLayout::MLD_CELL_WEIGHTS), 1000);
+    BOOST_CHECK_EQUAL(layout.GetBlockEntries(DataLayout::NAME_CHAR_DATA), 0);
+
+    // all metric blocks have valid canaries, so the facade can read them
+    for (auto i = 0; i < DataLayout::NUM_BLOCKS; i++)
+    {
+        const auto bid = static_cast<DataLayout::BlockID>(i);
+        if (DataLayout::IsMetricBlock(bid))
+            BOOST_CHECK_NO_THROW(layout.GetBlockPtr<char>(replica.GetMetricMemory(), bid));
+    }
+
+    const auto weights =
+        layout.GetBlockPtr<std::uint32_t>(replica.GetMetricMemory(), DataLayout::MLD_CELL_WEIGHTS);
+    const auto source_weights = source->layout.GetBlockPtr<std::uint32_t>(
+        source->GetMemory(), DataLayout::MLD_CELL_WEIGHTS);
+    BOOST_CHECK_NE(weights, source_weights);
+    BOOST_CHECK_EQUAL_COLLECTIONS(weights, weights + 1000, source_weights, source_weights + 1000);
+}
+
+BOOST_AUTO_TEST_CASE(pinned_thread_node)
+{
+    BOOST_CHECK_GE(util::numa::getNodeCount(), 1);
+    BOOST_CHECK(util::numa::getCurrentNode() < util::numa::getNodeCount());
+    BOOST_CHECK(!util::numa::pinThreadToNode(util::numa::getNodeCount()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+#include "engine/result_cache.hpp"
+
+#include "util/metrics.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(result_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+std::shared_ptr<const ResultCache::Entry> makeEntry(const std::string &bytes)
+{
+    auto entry = std::make_shared<ResultCache::Entry>();
+    entry->status = Status::Ok;
+    entry->bytes.assign(bytes.begin(), bytes.end());
+    return entry;
+}
+}
+
+BOOST_AUTO_TEST_CASE(least_recently_used_is_evicted)
+{
+    // a single shard, so the eviction order is deterministic
+    ResultCache cache(2, 1);
+    cache.Put("a", makeEntry("1"), cache.Generation());
+    cache.Put("b", makeEntry("2"), cache.Generation());
+    BOOST_CHECK(cache.Get("a"));
+
+    cache.Put("c", makeEntry("3"), cache.Generation());
+    BOOST_CHECK_EQUAL(cache.Size(), 2);
+    BOOST_CHECK(cache.Get("a"));
+    BOOST_CHECK(!cache.Get("b"));
+    BOOST_CHECK(cache.Get("c"));
+}
+
+BOOST_AUTO_TEST_CASE(invalidate)
+{
+    ResultCache cache(16);
+    const auto generation = cache.Generation();
+    cache.Put("a", makeEntry("1"), generation);
+    BOOST_CHECK(cache.Get("a"));
+
+    cache.Invalidate();
+    BOOST_CHECK(!cache.Get("a"));
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+
+    // computed with the data of before the invalidation
+    cache.Put("a", makeEntry("1"), generation);
+    BOOST_CHECK(!cache.Get("a"));
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(cached_response)
+{
+    ResultCache cache(16);
+    const auto metrics_before = util::metrics::collect();
+
+    unsigned computed = 0;
+    const auto compute = [&](util::json::Writer &writer) {
+        return [&]() {
+            computed++;
+            writer.StartObject();
+            writer.Key("code");
+            writer.String("Ok");
+            writer.EndObject();
+            return Status::Ok;
+        };
+    };
+
+    ResultCacheKey key;
+    key.Add(util::Coordinate{util::FloatLongitude{7.4}, util::FloatLatitude{43.7}});
+
+    std::vector<char> first, second;
+    util::json::Writer first_writer(first), second_writer(second);
+    BOOST_CHECK(cachedResponse(&cache, key, first_writer, compute(first_writer)) == Status::Ok);
+    BOOST_CHECK(cachedResponse(&cache, key, second_writer, compute(second_writer)) ==
+                Status::Ok);
+    BOOST_CHECK_EQUAL(computed, 1);
+    BOOST_CHECK_EQUAL(std::string(second.begin(), second.end()), "{\"code\":\"Ok\"}");
+    BOOST_CHECK_EQUAL_COLLECTIONS(first.begin(), first.end(), second.begin(), second.end());
+
+    // the same key with another result type is a different response
+    util::json::Object object;
+    BOOST_CHECK(cachedResponse(&cache, key, object, [&]() {
+                    computed++;
+                    object.values["code"] = "Ok";
+                    return Status::Ok;
+                }) == Status::Ok);
+    BOOST_CHECK_EQUAL(computed, 2);
+
+    const auto metrics_after = util::metrics::collect();
+    const auto other = static_cast<std::size_t>(util::metrics::Endpoint::Other);
+    BOOST_CHECK_EQUAL(metrics_after.cache_hits[other], metrics_before.cache_hits[other] + 1);
+    BOOST_CHECK_EQUAL(metrics_after.cache_misses[other], metrics_before.cache_misses[other] + 2);
+}
+
+BOOST_AUTO_TEST_CASE(phantom_node_key)
+{
+    PhantomNode phantom;
+    phantom.location = util::Coordinate{util::FloatLongitude{7.4}, util::FloatLatitude{43.7}};
+    phantom.input_location =
+        util::Coordinate{util::FloatLongitude{7.41}, util::FloatLatitude{43.71}};
+    auto moved_input = phantom;
+    moved_input.input_location =
+        util::Coordinate{util::FloatLongitude{7.42}, util::FloatLatitude{43.72}};
+
+    // the input location only matters if the response has hints
+    BOOST_CHECK_EQUAL(ResultCacheKey().Add(phantom, false).Get(),
+                      ResultCacheKey().Add(moved_input, false).Get());
+    BOOST_CHECK_NE(ResultCacheKey().Add(phantom, true).Get(),
+                   ResultCacheKey().Add(moved_input, true).Get());
+
+    auto other_weight = phantom;
+    other_weight.forward_weight++;
+    BOOST_CHECK_NE(ResultCacheKey().Add(phantom, false).Get(),
+                   ResultCacheKey().Add(other_weight, false).Get());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
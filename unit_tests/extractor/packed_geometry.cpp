@@ -0,0 +1,190 @@
+#include "extractor/packed_geometry.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/range/adaptor/reversed.hpp>
+#include <boost/range/distance.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <iterator>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(packed_geometry)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+// Packs the geometries like Storage does: count first, then encode into the allocated memory
+PackedGeometry pack(const std::vector<std::uint32_t> &index, const std::vector<NodeID> &nodes)
+{
+    PackedGeometryEncoder counter(index.data(), index.size());
+    counter.Push(nodes.begin(), nodes.end());
+    counter.Finish();
+    BOOST_CHECK_EQUAL(counter.GetNumberOfNodes(), nodes.size());
+
+    std::vector<NodeID> first_nodes(counter.GetNumberOfGeometries());
+    std::vector<PackedGeometryBlock> blocks(counter.GetNumberOfBlocks());
+    std::vector<PackedGeometryEncoder::WordT> words(counter.GetNumberOfWords());
+    PackedGeometryEncoder encoder(
+        index.data(), index.size(), first_nodes.data(), blocks.data(), words.data());
+    encoder.Push(nodes.begin(), nodes.end());
+    encoder.Finish();
+    BOOST_CHECK_EQUAL(encoder.GetNumberOfBlocks(), blocks.size());
+    BOOST_CHECK_EQUAL(encoder.GetNumberOfWords(), words.size());
+
+    return PackedGeometry{std::move(first_nodes), std::move(blocks), std::move(words)};
+}
+
+void checkGeometries(const std::vector<std::uint32_t> &index, const std::vector<NodeID> &nodes)
+{
+    const auto packed = pack(index, nodes);
+    for (std::uint32_t id = 0; id + 1 < index.size(); ++id)
+    {
+        std::vector<NodeID> decoded(index[id + 1] - index[id]);
+        packed.Decode(id, index[id], index[id + 1], decoded.begin());
+
+        const std::vector<NodeID> expected(nodes.begin() + index[id],
+                                           nodes.begin() + index[id + 1]);
+        BOOST_CHECK_EQUAL_COLLECTIONS(
+            decoded.begin(), decoded.end(), expected.begin(), expected.end());
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(zigzag)
+{
+    for (const NodeID previous : {0u, 1u, 1000u, SPECIAL_NODEID})
+    {
+        for (const NodeID node : {0u, 1u, 999u, 1001u, SPECIAL_NODEID - 1})
+        {
+            BOOST_CHECK_EQUAL(detail::zigzagDecode(detail::zigzagEncode(node, previous), previous),
+                              node);
+        }
+    }
+    BOOST_CHECK_EQUAL(detail::zigzagEncode(5, 5), 0);
+    BOOST_CHECK_EQUAL(detail::zigzagEncode(4, 5), 1);
+    BOOST_CHECK_EQUAL(detail::zigzagEncode(6, 5), 2);
+}
+
+BOOST_AUTO_TEST_CASE(small_geometries)
+{
+    // includes empty geometries in between and at the end
+    const std::vector<std::uint32_t> index = {0, 3, 3, 5, 6, 6, 6};
+    const std::vector<NodeID> nodes = {10, 11, 12, 7, 5, 100};
+    checkGeometries(index, nodes);
+}
+
+BOOST_AUTO_TEST_CASE(single_node_geometries)
+{
+    // all deltas are zero, so the blocks need no bits
+    std::vector<std::uint32_t> index;
+    std::vector<NodeID> nodes;
+    for (NodeID node = 0; node < 200; ++node)
+    {
+        index.push_back(nodes.size());
+        nodes.push_back(node * 7);
+    }
+    index.push_back(nodes.size());
+
+    checkGeometries(index, nodes);
+}
+
+BOOST_AUTO_TEST_CASE(random_geometries)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::uint32_t> length_distribution(0, 150);
+    std::uniform_int_distribution<std::int32_t> small_delta(-20, 20);
+    std::uniform_int_distribution<NodeID> any_node(0, SPECIAL_NODEID - 1);
+    std::bernoulli_distribution jump(0.05);
+
+    std::vector<std::uint32_t> index;
+    std::vector<NodeID> nodes;
+    for (int geometry = 0; geometry < 500; ++geometry)
+    {
+        index.push_back(nodes.size());
+        NodeID node = any_node(generator);
+        const auto length = length_distribution(generator);
+        for (std::uint32_t position = 0; position < length; ++position)
+        {
+            // mostly close nodes, but some blocks need the full width
+            node = jump(generator) ? any_node(generator) : node + small_delta(generator);
+            nodes.push_back(node);
+        }
+    }
+    index.push_back(nodes.size());
+
+    checkGeometries(index, nodes);
+}
+
+BOOST_AUTO_TEST_CASE(geometry_iterator)
+{
+    // packed nodes can only be reached one by one
+    static_assert(std::is_same<std::iterator_traits<GeometryIterator>::iterator_category,
+                               std::bidirectional_iterator_tag>::value,
+                  "geometry iterator must not promise random access");
+
+    const std::vector<std::uint32_t> index = {0, 4, 5, 5, 8};
+    std::vector<NodeID> nodes = {10, 12, 9, 1000, 3, 7, 6, 7};
+
+    PackedGeometryEncoder counter(index.data(), index.size());
+    counter.Push(nodes.begin(), nodes.end());
+    counter.Finish();
+    std::vector<NodeID> first_nodes(counter.GetNumberOfGeometries());
+    std::vector<PackedGeometryBlock> blocks(counter.GetNumberOfBlocks());
+    std::vector<PackedGeometryEncoder::WordT> words(counter.GetNumberOfWords());
+    PackedGeometryEncoder encoder(
+        index.data(), index.size(), first_nodes.data(), blocks.data(), words.data());
+    encoder.Push(nodes.begin(), nodes.end());
+    encoder.Finish();
+    const PackedGeometryView packed{
+        util::vector_view<NodeID>(first_nodes.data(), first_nodes.size()),
+        util::vector_view<PackedGeometryBlock>(blocks.data(), blocks.size()),
+        util::vector_view<PackedGeometryEncoder::WordT>(words.data(), words.size())};
+
+    for (std::uint32_t id = 0; id + 1 < index.size(); ++id)
+    {
+        const auto begin = index[id], end = index[id + 1];
+        const std::vector<NodeID> expected(nodes.begin() + begin, nodes.begin() + end);
+        const std::vector<NodeID> expected_reverse(expected.rbegin(), expected.rend());
+
+        const auto plain = boost::make_iterator_range(GeometryIterator{nodes.data() + begin},
+                                                      GeometryIterator{nodes.data() + end});
+        const auto last = begin == end ? 0 : packed.GetLastNode(id, begin, end);
+        const auto decoded =
+            boost::make_iterator_range(GeometryIterator{&packed, begin, packed.GetFirstNode(id)},
+                                       GeometryIterator{&packed, end, last});
+
+        for (const auto &range : {plain, decoded})
+        {
+            BOOST_CHECK_EQUAL(static_cast<std::size_t>(boost::distance(range)), expected.size());
+            BOOST_CHECK_EQUAL_COLLECTIONS(
+                range.begin(), range.end(), expected.begin(), expected.end());
+
+            const auto reversed = boost::adaptors::reverse(range);
+            BOOST_CHECK_EQUAL_COLLECTIONS(reversed.begin(),
+                                          reversed.end(),
+                                          expected_reverse.begin(),
+                                          expected_reverse.end());
+        }
+
+        if (end - begin > 2)
+        {
+            BOOST_CHECK_EQUAL(*std::next(decoded.begin(), 2), expected[2]);
+            BOOST_CHECK_EQUAL(*std::prev(decoded.end(), 2), expected[expected.size() - 2]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+    const std::vector<std::uint32_t> index = {0};
+    const std::vector<NodeID> nodes;
+    const auto packed = pack(index, nodes);
+    BOOST_CHECK(packed.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
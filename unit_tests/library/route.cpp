@@ -447,4 +447,53 @@ BOOST_AUTO_TEST_CASE(test_manual_setting_of_annotations_property)
     BOOST_CHECK_EQUAL(annotations.size(), 5);
 }
 
+BOOST_AUTO_TEST_CASE(test_route_alternatives_mld)
+{
+    using namespace osrm;
+
+    auto osrm = getOSRM(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", EngineConfig::Algorithm::MLD);
+
+    // across Monaco from Fontvieille to Larvotto, whether an alternative is found depends on the
+    // data, but any alternative has to satisfy the bounds of the search
+    const auto routes = [&](const bool alternatives) {
+        RouteParameters params;
+        params.alternatives = alternatives;
+        params.coordinates.push_back(get_locations_in_big_component().front());
+        params.coordinates.push_back(get_dummy_location());
+
+        json::Object result;
+        const auto rc = osrm.Route(params, result);
+        BOOST_CHECK(rc == Status::Ok);
+
+        return result.values["routes"].get<json::Array>().values;
+    };
+    const auto value = [](const json::Value &route, const std::string &key) {
+        return route.get<json::Object>().values.at(key);
+    };
+
+    const auto shortest = routes(false);
+    const auto alternatives = routes(true);
+    BOOST_REQUIRE_EQUAL(shortest.size(), 1);
+    BOOST_REQUIRE_GE(alternatives.size(), 1);
+    BOOST_REQUIRE_LE(alternatives.size(), 2);
+
+    // the first route is the shortest one
+    const auto shortest_weight = value(shortest.front(), "weight").get<json::Number>().value;
+    BOOST_CHECK_EQUAL(value(alternatives[0], "weight").get<json::Number>().value,
+                      shortest_weight);
+    BOOST_CHECK_EQUAL(value(alternatives[0], "geometry").get<json::String>().value,
+                      value(shortest.front(), "geometry").get<json::String>().value);
+
+    // an alternative takes another way and is at most 15% longer
+    for (std::size_t index = 1; index < alternatives.size(); ++index)
+    {
+        const auto &alternative = alternatives[index];
+        const auto alternative_weight = value(alternative, "weight").get<json::Number>().value;
+        BOOST_CHECK_NE(value(alternative, "geometry").get<json::String>().value,
+                       value(alternatives[0], "geometry").get<json::String>().value);
+        BOOST_CHECK_GE(alternative_weight, shortest_weight);
+        BOOST_CHECK_LE(alternative_weight, shortest_weight * 1.15 + 0.1);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
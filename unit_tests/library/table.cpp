@@ -13,6 +13,10 @@
 #include "osrm/osrm.hpp"
 #include "osrm/status.hpp"
 
+#include <tbb/task_scheduler_init.h>
+
+#include <string>
+
 BOOST_AUTO_TEST_SUITE(table)
 
 BOOST_AUTO_TEST_CASE(test_table_three_coords_one_source_one_dest_matrix)
@@ -174,4 +178,90 @@ BOOST_AUTO_TEST_CASE(test_table_no_segment_for_some_coordinates)
     BOOST_CHECK_EQUAL(code, "NoSegment");
 }
 
+namespace
+{
+osrm::OSRM getOSRM(const std::string &base_path,
+                   const osrm::EngineConfig::Algorithm algorithm,
+                   const int max_threads_distance_table)
+{
+    osrm::EngineConfig config;
+    config.storage_config = {base_path};
+    config.use_shared_memory = false;
+    config.algorithm = algorithm;
+    config.max_threads_distance_table = max_threads_distance_table;
+
+    return osrm::OSRM{config};
+}
+
+// Compares the tables of a request computed on one and on several threads
+void checkParallelTable(const std::string &base_path, const osrm::EngineConfig::Algorithm algorithm)
+{
+    using namespace osrm;
+
+    // the arena of a request only gets workers the scheduler has, even on a single core
+    tbb::task_scheduler_init scheduler(4);
+    auto sequential_osrm = getOSRM(base_path, algorithm, 1);
+    auto parallel_osrm = getOSRM(base_path, algorithm, 4);
+
+    // a grid over Monaco, enough searches to split them across the threads
+    TableParameters params;
+    for (auto row = 0; row < 10; ++row)
+    {
+        for (auto column = 0; column < 10; ++column)
+        {
+            params.coordinates.push_back({Longitude{7.413 + column * 0.0025},
+                                          Latitude{43.728 + row * 0.002}});
+        }
+    }
+
+    json::Object sequential_result;
+    BOOST_CHECK(sequential_osrm.Table(params, sequential_result) == Status::Ok);
+    json::Object parallel_result;
+    BOOST_CHECK(parallel_osrm.Table(params, parallel_result) == Status::Ok);
+
+    const auto &sequential_rows =
+        sequential_result.values.at("durations").get<json::Array>().values;
+    const auto &parallel_rows = parallel_result.values.at("durations").get<json::Array>().values;
+    BOOST_REQUIRE_EQUAL(sequential_rows.size(), params.coordinates.size());
+    BOOST_REQUIRE_EQUAL(parallel_rows.size(), params.coordinates.size());
+
+    // unreachable destinations are null
+    const auto get_duration = [](const json::Value &value) {
+        return value.is<json::Null>() ? -1. : value.get<json::Number>().value;
+    };
+
+    std::size_t number_of_routes = 0;
+    for (std::size_t row = 0; row < sequential_rows.size(); ++row)
+    {
+        const auto &sequential_row = sequential_rows[row].get<json::Array>().values;
+        const auto &parallel_row = parallel_rows[row].get<json::Array>().values;
+        BOOST_REQUIRE_EQUAL(sequential_row.size(), params.coordinates.size());
+        BOOST_REQUIRE_EQUAL(parallel_row.size(), params.coordinates.size());
+
+        for (std::size_t column = 0; column < sequential_row.size(); ++column)
+        {
+            const auto sequential_duration = get_duration(sequential_row[column]);
+            const auto parallel_duration = get_duration(parallel_row[column]);
+            BOOST_CHECK_MESSAGE(sequential_duration == parallel_duration,
+                                "duration " << row << " -> " << column << ": "
+                                            << sequential_duration << " != " << parallel_duration);
+            number_of_routes += sequential_duration > 0;
+        }
+    }
+
+    // most of the grid lies on the road network
+    BOOST_CHECK_GT(number_of_routes, params.coordinates.size());
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_table_parallel_ch)
+{
+    checkParallelTable(OSRM_TEST_DATA_DIR "/ch/monaco.osrm", osrm::EngineConfig::Algorithm::CH);
+}
+
+BOOST_AUTO_TEST_CASE(test_table_parallel_mld)
+{
+    checkParallelTable(OSRM_TEST_DATA_DIR "/mld/monaco.osrm", osrm::EngineConfig::Algorithm::MLD);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
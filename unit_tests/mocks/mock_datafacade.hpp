@@ -46,40 +46,52 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
     {
         return 0;
     }
-    std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID /* id */) const override
+    NodeForwardRange GetUncompressedForwardGeometry(const EdgeID /* id */) const override
     {
         return {};
     }
-    std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID /* id */) const override
+    NodeReverseRange GetUncompressedReverseGeometry(const EdgeID id) const override
     {
-        return {};
+        return NodeReverseRange(GetUncompressedForwardGeometry(id));
     }
-    std::vector<EdgeWeight> GetUncompressedForwardWeights(const EdgeID /* id */) const override
+    WeightForwardRange GetUncompressedForwardWeights(const EdgeID /* id */) const override
     {
-        std::vector<EdgeWeight> result_weights;
-        result_weights.resize(1);
-        result_weights[0] = 1;
-        return result_weights;
+        static std::uint64_t data[] = {0, 0};
+        static const auto weights = [] {
+            extractor::SegmentDataView::SegmentWeightVector weights(
+                util::vector_view<std::uint64_t>(data, 2), 1);
+            weights[0] = 1;
+            return weights;
+        }();
+        return WeightForwardRange(weights.begin(), weights.end());
     }
-    std::vector<EdgeWeight> GetUncompressedReverseWeights(const EdgeID id) const override
+    WeightReverseRange GetUncompressedReverseWeights(const EdgeID id) const override
     {
-        return GetUncompressedForwardWeights(id);
+        return WeightReverseRange(GetUncompressedForwardWeights(id));
     }
-    std::vector<EdgeWeight> GetUncompressedForwardDurations(const EdgeID id) const override
+    DurationForwardRange GetUncompressedForwardDurations(const EdgeID /* id */) const override
     {
-        return GetUncompressedForwardWeights(id);
+        static std::uint64_t data[] = {0, 0};
+        static const auto durations = [] {
+            extractor::SegmentDataView::SegmentDurationVector durations(
+                util::vector_view<std::uint64_t>(data, 2), 1);
+            durations[0] = 1;
+            return durations;
+        }();
+        return DurationForwardRange(durations.begin(), durations.end());
     }
-    std::vector<EdgeWeight> GetUncompressedReverseDurations(const EdgeID id) const override
+    DurationReverseRange GetUncompressedReverseDurations(const EdgeID id) const override
     {
-        return GetUncompressedForwardWeights(id);
+        return DurationReverseRange(GetUncompressedForwardDurations(id));
     }
-    std::vector<DatasourceID> GetUncompressedForwardDatasources(const EdgeID /*id*/) const override
+    DatasourceForwardRange GetUncompressedForwardDatasources(const EdgeID /*id*/) const override
     {
-        return {};
+        static const util::vector_view<DatasourceID> datasources(nullptr, 0);
+        return DatasourceForwardRange(datasources.cbegin(), datasources.cend());
     }
-    std::vector<DatasourceID> GetUncompressedReverseDatasources(const EdgeID /*id*/) const override
+    DatasourceReverseRange GetUncompressedReverseDatasources(const EdgeID id) const override
     {
-        return {};
+        return DatasourceReverseRange(GetUncompressedForwardDatasources(id));
     }
 
     StringView GetDatasourceName(const DatasourceID) const override final { return {}; }
@@ -189,6 +201,17 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
         return {};
     }
 
+    std::vector<std::pair<engine::PhantomNode, engine::PhantomNode>>
+    NearestPhantomNodesWithAlternativeFromBigComponent(
+        const std::vector<util::Coordinate> & /*input_coordinates*/,
+        const std::vector<boost::optional<double>> & /*max_distances*/,
+        const std::vector<boost::optional<engine::Bearing>> & /*bearings*/,
+        const std::vector<boost::optional<engine::Approach>> & /*approaches*/,
+        const int /*max_threads*/) const override
+    {
+        return {};
+    }
+
     unsigned GetCheckSum() const override { return 0; }
 
     extractor::TravelMode GetTravelMode(const NodeID /* id */) const override
@@ -84,6 +84,7 @@ BOOST_AUTO_TEST_CASE(invalid_table_urls)
         testInvalidOptions<TableParameters>("1,2;3,4?sources=1&destinations=1&bla=foo"), 32UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?sources=foo"), 16UL);
     BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4?destinations=foo"), 21UL);
+    BOOST_CHECK_EQUAL(testInvalidOptions<TableParameters>("1,2;3,4.csv"), 7UL);
 }
 
 BOOST_AUTO_TEST_CASE(valid_route_hint)
@@ -324,6 +325,12 @@ BOOST_AUTO_TEST_CASE(valid_route_urls)
     BOOST_CHECK(result_11);
     BOOST_CHECK_EQUAL(result_11->generate_hints, false);
 
+    auto result_binary = parseParameters<RouteParameters>("1,2;3.5,4.binary?overview=full");
+    BOOST_CHECK(result_binary);
+    BOOST_CHECK(result_binary->format == RouteParameters::OutputFormatType::Binary);
+    BOOST_CHECK(result_binary->overview == RouteParameters::OverviewType::Full);
+    BOOST_CHECK_EQUAL(result_binary->coordinates.size(), 2);
+
     auto result_12 = parseParameters<RouteParameters>("1,2;3,4?generate_hints=true");
     BOOST_CHECK(result_12);
     BOOST_CHECK_EQUAL(result_12->generate_hints, true);
@@ -467,6 +474,16 @@ BOOST_AUTO_TEST_CASE(valid_table_urls)
     CHECK_EQUAL_RANGE(reference_1.radiuses, result_3->radiuses);
     CHECK_EQUAL_RANGE(reference_1.approaches, result_3->approaches);
     CHECK_EQUAL_RANGE(reference_1.coordinates, result_3->coordinates);
+
+    auto result_4 = parseParameters<TableParameters>("1,2;3,4.binary?sources=all");
+    BOOST_CHECK(result_4);
+    BOOST_CHECK(result_4->format == TableParameters::OutputFormatType::Binary);
+    CHECK_EQUAL_RANGE(reference_1.coordinates, result_4->coordinates);
+
+    auto result_5 = parseParameters<TableParameters>("1,2;3,4.json");
+    BOOST_CHECK(result_5);
+    BOOST_CHECK(result_5->format == TableParameters::OutputFormatType::JSON);
+    CHECK_EQUAL_RANGE(reference_1.coordinates, result_5->coordinates);
 }
 
 BOOST_AUTO_TEST_CASE(valid_match_urls)
@@ -0,0 +1,163 @@
+#include "server/request_executor.hpp"
+#include "util/metrics.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(request_executor)
+
+using namespace osrm;
+using namespace osrm::server;
+
+// Blocks all tasks until released
+struct Gate
+{
+    void Wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        opened.wait(lock, [this] { return open; });
+    }
+
+    void Open()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            open = true;
+        }
+        opened.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable opened;
+    bool open = false;
+};
+
+template <typename Predicate> void waitFor(Predicate predicate)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!predicate() && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    BOOST_REQUIRE(predicate());
+}
+
+BOOST_AUTO_TEST_CASE(service_name)
+{
+    BOOST_CHECK_EQUAL(RequestExecutor::ServiceName("/route/v1/driving/1,2;3,4"), "route");
+    BOOST_CHECK_EQUAL(RequestExecutor::ServiceName("/table?foo"), "table");
+    BOOST_CHECK_EQUAL(RequestExecutor::ServiceName("/nearest"), "nearest");
+    BOOST_CHECK_EQUAL(RequestExecutor::ServiceName("/"), "");
+    BOOST_CHECK_EQUAL(RequestExecutor::ServiceName(""), "");
+}
+
+BOOST_AUTO_TEST_CASE(executes_all_tasks)
+{
+    RequestExecutorConfig config;
+    config.num_threads = 4;
+    RequestExecutor executor(config);
+
+    std::atomic<unsigned> executed{0};
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        BOOST_CHECK(executor.Post("/route/v1/driving/1,2;3,4", [&executed] { executed++; }));
+    }
+    waitFor([&] { return executed == 100; });
+
+    const auto statistics = executor.GetStatistics();
+    for (const auto &service : statistics)
+    {
+        BOOST_CHECK_EQUAL(service.second.executed, service.first == "route" ? 100 : 0);
+        BOOST_CHECK_EQUAL(service.second.wait_us.Count(), service.second.executed);
+        BOOST_CHECK_EQUAL(service.second.rejected, 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sheds_load_on_full_queue)
+{
+    RequestExecutorConfig config;
+    config.num_threads = 1;
+    config.max_queue_size = 2;
+    RequestExecutor executor(config);
+    const auto table = static_cast<std::size_t>(util::metrics::Endpoint::Table);
+    const auto metrics_before = util::metrics::collect();
+
+    Gate gate;
+    std::atomic<unsigned> executed{0};
+    const auto task = [&] {
+        gate.Wait();
+        executed++;
+    };
+
+    BOOST_CHECK(executor.Post("/table/v1/driving/1,2;3,4", task));
+    // wait until the only thread is busy so the next tasks have to wait in the queue
+    waitFor([&] { return executor.QueueSize() == 0; });
+    BOOST_CHECK(executor.Post("/table/v1/driving/1,2;3,4", task));
+    BOOST_CHECK(executor.Post("/table/v1/driving/1,2;3,4", task));
+    BOOST_CHECK(!executor.Post("/table/v1/driving/1,2;3,4", task));
+
+    const auto metrics_queued = util::metrics::collect();
+    BOOST_CHECK_EQUAL(metrics_queued.queue_size[table], metrics_before.queue_size[table] + 2);
+    BOOST_CHECK_EQUAL(metrics_queued.rejected_requests[table],
+                      metrics_before.rejected_requests[table] + 1);
+
+    gate.Open();
+    waitFor([&] { return executed == 3; });
+
+    const auto metrics_after = util::metrics::collect();
+    BOOST_CHECK_EQUAL(metrics_after.queue_size[table], metrics_before.queue_size[table]);
+    BOOST_CHECK_EQUAL(metrics_after.queue_wait[table].Count(),
+                      metrics_before.queue_wait[table].Count() + 3);
+
+    for (const auto &service : executor.GetStatistics())
+    {
+        if (service.first == "table")
+        {
+            BOOST_CHECK_EQUAL(service.second.executed, 3);
+            BOOST_CHECK_EQUAL(service.second.rejected, 1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(limits_concurrency_per_service)
+{
+    RequestExecutorConfig config;
+    config.num_threads = 4;
+    config.max_concurrent_requests["table"] = 1;
+    RequestExecutor executor(config);
+
+    Gate gate;
+    std::atomic<unsigned> running_tables{0};
+    std::atomic<unsigned> executed_tables{0};
+    std::atomic<unsigned> executed_routes{0};
+
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        executor.Post("/table/v1/driving/1,2;3,4", [&] {
+            running_tables++;
+            gate.Wait();
+            executed_tables++;
+            running_tables--;
+        });
+    }
+
+    // cheap requests are not blocked by the tables waiting for their turn
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        executor.Post("/route/v1/driving/1,2;3,4", [&] { executed_routes++; });
+    }
+    waitFor([&] { return executed_routes == 10; });
+
+    BOOST_CHECK_EQUAL(running_tables, 1);
+    BOOST_CHECK_EQUAL(executor.QueueSize(), 2);
+
+    gate.Open();
+    waitFor([&] { return executed_tables == 3; });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+#include "server/request_parser.hpp"
+#include "server/http/request.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <tuple>
+
+BOOST_AUTO_TEST_SUITE(request_parser)
+
+using namespace osrm;
+using namespace osrm::server;
+
+BOOST_AUTO_TEST_CASE(http_version_and_connection)
+{
+    std::string data = "GET /route/v1/driving/1,2;3,4 HTTP/1.1\r\n"
+                       "Connection: keep-alive\r\n"
+                       "Accept-Encoding: gzip\r\n\r\n";
+
+    RequestParser parser;
+    http::request request;
+    RequestParser::RequestStatus result;
+    http::compression_type compression;
+    char *request_end;
+    std::tie(result, compression, request_end) =
+        parser.parse(request, &data[0], &data[0] + data.size());
+
+    BOOST_CHECK(result == RequestParser::RequestStatus::valid);
+    BOOST_CHECK(compression == http::gzip_rfc1952);
+    BOOST_CHECK(request_end == &data[0] + data.size());
+    BOOST_CHECK_EQUAL(request.uri, "/route/v1/driving/1,2;3,4");
+    BOOST_CHECK_EQUAL(request.http_version_major, 1);
+    BOOST_CHECK_EQUAL(request.http_version_minor, 1);
+    BOOST_CHECK_EQUAL(request.connection, "keep-alive");
+}
+
+BOOST_AUTO_TEST_CASE(pipelined_requests)
+{
+    const std::string first = "GET /nearest/v1/driving/1,2 HTTP/1.1\r\n\r\n";
+    const std::string second = "GET /route/v1/driving/1,2;3,4 HTTP/1.0\r\n"
+                               "Connection: close\r\n\r\n";
+    std::string data = first + second;
+    char *const end = &data[0] + data.size();
+
+    RequestParser parser;
+    http::request request;
+    RequestParser::RequestStatus result;
+    http::compression_type compression;
+    char *request_end;
+    std::tie(result, compression, request_end) = parser.parse(request, &data[0], end);
+
+    BOOST_CHECK(result == RequestParser::RequestStatus::valid);
+    BOOST_CHECK(request_end == &data[0] + first.size());
+    BOOST_CHECK_EQUAL(request.uri, "/nearest/v1/driving/1,2");
+
+    parser = RequestParser();
+    request = http::request();
+    std::tie(result, compression, request_end) = parser.parse(request, request_end, end);
+
+    BOOST_CHECK(result == RequestParser::RequestStatus::valid);
+    BOOST_CHECK(request_end == end);
+    BOOST_CHECK_EQUAL(request.uri, "/route/v1/driving/1,2;3,4");
+    BOOST_CHECK_EQUAL(request.http_version_major, 1);
+    BOOST_CHECK_EQUAL(request.http_version_minor, 0);
+    BOOST_CHECK_EQUAL(request.connection, "close");
+}
+
+BOOST_AUTO_TEST_CASE(incomplete_request)
+{
+    std::string data = "GET /route/v1/driving/1,2;3,4 HTTP/1.1\r\nConn";
+
+    RequestParser parser;
+    http::request request;
+    RequestParser::RequestStatus result;
+    http::compression_type compression;
+    char *request_end;
+    std::tie(result, compression, request_end) =
+        parser.parse(request, &data[0], &data[0] + data.size());
+
+    BOOST_CHECK(result == RequestParser::RequestStatus::indeterminate);
+    BOOST_CHECK(request_end == &data[0] + data.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+#include "storage/shared_datatype.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+BOOST_AUTO_TEST_SUITE(shared_datatype)
+
+using namespace osrm;
+using namespace osrm::storage;
+
+namespace
+{
+// Every block osrm-customize or osrm-contract rewrites, listed independently of
+// DataLayout::IsMetricBlock so a new block has to be classified on purpose.
+const DataLayout::BlockID metric_blocks[] = {DataLayout::HSGR_CHECKSUM,
+                                             DataLayout::CH_GRAPH_NODE_LIST,
+                                             DataLayout::CH_GRAPH_EDGE_LIST,
+                                             DataLayout::CH_CORE_MARKER,
+                                             DataLayout::GEOMETRIES_INDEX,
+                                             DataLayout::GEOMETRIES_NODE_LIST,
+                                             DataLayout::GEOMETRIES_PACKED_FIRST_NODES,
+                                             DataLayout::GEOMETRIES_PACKED_BLOCKS,
+                                             DataLayout::GEOMETRIES_PACKED_WORDS,
+                                             DataLayout::GEOMETRIES_FWD_WEIGHT_LIST,
+                                             DataLayout::GEOMETRIES_REV_WEIGHT_LIST,
+                                             DataLayout::GEOMETRIES_FWD_DURATION_LIST,
+                                             DataLayout::GEOMETRIES_REV_DURATION_LIST,
+                                             DataLayout::DATASOURCES_LIST,
+                                             DataLayout::DATASOURCES_NAMES,
+                                             DataLayout::TURN_WEIGHT_PENALTIES,
+                                             DataLayout::TURN_DURATION_PENALTIES,
+                                             DataLayout::MLD_CELL_WEIGHTS,
+                                             DataLayout::MLD_CELL_DURATIONS,
+                                             DataLayout::MLD_CELL_SOURCE_BOUNDARY,
+                                             DataLayout::MLD_CELL_DESTINATION_BOUNDARY,
+                                             DataLayout::MLD_CELLS,
+                                             DataLayout::MLD_CELL_LEVEL_OFFSETS,
+                                             DataLayout::MLD_GRAPH_NODE_LIST,
+                                             DataLayout::MLD_GRAPH_EDGE_LIST,
+                                             DataLayout::MLD_GRAPH_NODE_TO_OFFSET};
+
+bool isExpectedMetricBlock(const DataLayout::BlockID block)
+{
+    return std::find(std::begin(metric_blocks), std::end(metric_blocks), block) !=
+           std::end(metric_blocks);
+}
+
+// Every block gets a different number of entries and a different entry size
+DataLayout makeLayout()
+{
+    DataLayout layout;
+    for (auto block = 0; block < DataLayout::NUM_BLOCKS; ++block)
+    {
+        const auto id = static_cast<DataLayout::BlockID>(block);
+        switch (block % 3)
+        {
+        case 0:
+            layout.SetBlockSize<char>(id, 100 + block);
+            break;
+        case 1:
+            layout.SetBlockSize<std::uint32_t>(id, 10 + block);
+            break;
+        default:
+            layout.SetBlockSize<std::uint64_t>(id, 1 + block);
+        }
+    }
+    return layout;
+}
+}
+
+BOOST_AUTO_TEST_CASE(metric_blocks_are_classified)
+{
+    for (auto block = 0; block < DataLayout::NUM_BLOCKS; ++block)
+    {
+        const auto id = static_cast<DataLayout::BlockID>(block);
+        BOOST_CHECK_MESSAGE(DataLayout::IsMetricBlock(id) == isExpectedMetricBlock(id),
+                            block_id_to_name[block]);
+    }
+
+    // blocks that osrm-datastore computes from the static files stay in the static region
+    BOOST_CHECK(!DataLayout::IsMetricBlock(DataLayout::R_SEARCH_TREE));
+    BOOST_CHECK(!DataLayout::IsMetricBlock(DataLayout::R_SEARCH_TREE_LEVELS));
+    BOOST_CHECK(!DataLayout::IsMetricBlock(DataLayout::R_SEARCH_TREE_PROJECTED_LEAVES));
+    BOOST_CHECK(!DataLayout::IsMetricBlock(DataLayout::COORDINATE_LIST));
+    BOOST_CHECK(!DataLayout::IsMetricBlock(DataLayout::MLD_PARTITION));
+}
+
+BOOST_AUTO_TEST_CASE(every_block_lands_in_one_segment)
+{
+    const auto layout = makeLayout();
+    const auto static_layout = layout.GetSegmentLayout(false);
+    const auto metric_layout = layout.GetSegmentLayout(true);
+
+    for (auto block = 0; block < DataLayout::NUM_BLOCKS; ++block)
+    {
+        const auto id = static_cast<DataLayout::BlockID>(block);
+        const auto &segment = isExpectedMetricBlock(id) ? metric_layout : static_layout;
+        const auto &other_segment = isExpectedMetricBlock(id) ? static_layout : metric_layout;
+
+        BOOST_CHECK_MESSAGE(segment.GetBlockEntries(id) == layout.GetBlockEntries(id),
+                            block_id_to_name[block]);
+        BOOST_CHECK_MESSAGE(other_segment.GetBlockEntries(id) == 0, block_id_to_name[block]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(segment_sizes_add_up)
+{
+    const auto layout = makeLayout();
+    const auto static_layout = layout.GetSegmentLayout(false);
+    const auto metric_layout = layout.GetSegmentLayout(true);
+    BOOST_CHECK_LT(static_layout.GetSizeOfLayout(), layout.GetSizeOfLayout());
+    BOOST_CHECK_LT(metric_layout.GetSizeOfLayout(), layout.GetSizeOfLayout());
+
+    // Both segments keep the canaries and alignment of every block, and empty blocks of the
+    // core marker still take one word. This overhead is what a layout without entries needs.
+    auto empty_layout = layout;
+    std::fill(empty_layout.num_entries.begin(), empty_layout.num_entries.end(), 0);
+    BOOST_CHECK_EQUAL(static_layout.GetSizeOfLayout() + metric_layout.GetSizeOfLayout(),
+                      layout.GetSizeOfLayout() + empty_layout.GetSizeOfLayout());
+
+    // the blocks themselves are split without loss
+    for (auto block = 0; block < DataLayout::NUM_BLOCKS; ++block)
+    {
+        const auto id = static_cast<DataLayout::BlockID>(block);
+        BOOST_CHECK_MESSAGE(static_layout.GetBlockSize(id) + metric_layout.GetBlockSize(id) ==
+                                layout.GetBlockSize(id) + empty_layout.GetBlockSize(id),
+                            block_id_to_name[block]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,129 @@
+#include "storage/storage.hpp"
+
+#include "common/temporary_file.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(static_data_fingerprint)
+
+using namespace osrm;
+using namespace osrm::storage;
+
+namespace
+{
+// Writes a few bytes to every file of a dataset and removes them again
+struct Dataset
+{
+    Dataset() : config(base.path)
+    {
+        for (const auto &path : Files())
+        {
+            Write(path, "data");
+        }
+    }
+
+    ~Dataset()
+    {
+        for (const auto &path : Files())
+        {
+            boost::filesystem::remove(path);
+        }
+    }
+
+    std::vector<boost::filesystem::path> Files() const
+    {
+        return {config.ram_index_path,
+                config.file_index_path,
+                config.hsgr_data_path,
+                config.node_based_nodes_data_path,
+                config.edge_based_nodes_data_path,
+                config.edges_data_path,
+                config.geometries_path,
+                config.timestamp_path,
+                config.turn_weight_penalties_path,
+                config.turn_duration_penalties_path,
+                config.datasource_names_path,
+                config.names_data_path,
+                config.properties_path,
+                config.intersection_class_path,
+                config.turn_lane_data_path,
+                config.turn_lane_description_path,
+                config.mld_partition_path,
+                config.mld_storage_path,
+                config.mld_graph_path};
+    }
+
+    static void Write(const boost::filesystem::path &path, const std::string &data)
+    {
+        boost::filesystem::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << data;
+    }
+
+    TemporaryFile base;
+    StorageConfig config;
+};
+}
+
+BOOST_AUTO_TEST_CASE(unchanged_files)
+{
+    Dataset dataset;
+    const Storage storage(dataset.config);
+    BOOST_CHECK_EQUAL(storage.GetStaticDataFingerprint(), storage.GetStaticDataFingerprint());
+}
+
+BOOST_AUTO_TEST_CASE(metric_files_are_ignored)
+{
+    Dataset dataset;
+    const Storage storage(dataset.config);
+    const auto fingerprint = storage.GetStaticDataFingerprint();
+
+    // what osrm-customize and osrm-contract write
+    for (const auto &path : {dataset.config.hsgr_data_path,
+                             dataset.config.geometries_path,
+                             dataset.config.turn_weight_penalties_path,
+                             dataset.config.turn_duration_penalties_path,
+                             dataset.config.datasource_names_path,
+                             dataset.config.mld_storage_path,
+                             dataset.config.mld_graph_path})
+    {
+        Dataset::Write(path, "new metric");
+        boost::filesystem::last_write_time(path, boost::filesystem::last_write_time(path) + 10);
+    }
+
+    BOOST_CHECK_EQUAL(storage.GetStaticDataFingerprint(), fingerprint);
+}
+
+BOOST_AUTO_TEST_CASE(changed_static_file)
+{
+    Dataset dataset;
+    const Storage storage(dataset.config);
+    const auto fingerprint = storage.GetStaticDataFingerprint();
+
+    // e.g. the node order of osrm-contract --renumber-nodes, the size stays the same
+    const auto &path = dataset.config.edge_based_nodes_data_path;
+    const auto modified = boost::filesystem::last_write_time(path);
+    Dataset::Write(path, "atad");
+    boost::filesystem::last_write_time(path, modified + 10);
+    BOOST_CHECK_NE(storage.GetStaticDataFingerprint(), fingerprint);
+
+    // a file of another size with the old modification time
+    Dataset::Write(path, "more data");
+    boost::filesystem::last_write_time(path, modified);
+    BOOST_CHECK_NE(storage.GetStaticDataFingerprint(), fingerprint);
+}
+
+BOOST_AUTO_TEST_CASE(other_dataset)
+{
+    Dataset dataset;
+    Dataset other_dataset;
+
+    BOOST_CHECK_NE(Storage(dataset.config).GetStaticDataFingerprint(),
+                   Storage(other_dataset.config).GetStaticDataFingerprint());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
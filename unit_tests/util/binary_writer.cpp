@@ -0,0 +1,38 @@
+#include "util/binary_writer.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(binary_writer)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(little_endian_values)
+{
+    std::vector<char> buffer;
+    binary::Writer writer(buffer);
+    writer.UInt32(0x01020304);
+    writer.Int32(-2);
+    writer.Float(1.5f);
+    writer.String("Ok");
+
+    const std::vector<unsigned char> expected = {
+        0x04, 0x03, 0x02, 0x01, // 0x01020304
+        0xfe, 0xff, 0xff, 0xff, // -2
+        0x00, 0x00, 0xc0, 0x3f, // 1.5f
+        0x02, 0x00, 0x00, 0x00, // length of "Ok"
+        'O',  'k'};
+
+    BOOST_REQUIRE_EQUAL(buffer.size(), expected.size());
+    BOOST_CHECK_EQUAL(writer.Size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(static_cast<unsigned char>(buffer[i]), expected[i]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,120 @@
+#include "util/epoch.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(epoch)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+// Counts the live instances to check when they are deleted
+struct Tracked
+{
+    Tracked(int value, std::atomic<int> &alive) : value(value), alive(alive) { ++alive; }
+    ~Tracked() { --alive; }
+
+    int value;
+    std::atomic<int> &alive;
+};
+}
+
+BOOST_AUTO_TEST_CASE(update_without_readers)
+{
+    std::atomic<int> alive{0};
+    {
+        EpochPointer<const Tracked> pointer(std::make_unique<const Tracked>(1, alive));
+        BOOST_CHECK_EQUAL(pointer.Acquire()->value, 1);
+
+        pointer.Update(std::make_unique<const Tracked>(2, alive));
+        BOOST_CHECK_EQUAL(alive, 1);
+        BOOST_CHECK_EQUAL(pointer.Acquire()->value, 2);
+
+        // nested handles keep the outer guard
+        auto outer = pointer.Acquire();
+        auto inner = pointer.Acquire();
+        BOOST_CHECK_EQUAL(inner->value, 2);
+    }
+    BOOST_CHECK_EQUAL(alive, 0);
+}
+
+BOOST_AUTO_TEST_CASE(update_waits_for_readers)
+{
+    std::atomic<int> alive{0};
+    EpochPointer<const Tracked> pointer(std::make_unique<const Tracked>(1, alive));
+
+    std::atomic<bool> acquired{false};
+    std::atomic<bool> release{false};
+    std::atomic<int> read_value{0};
+    std::thread reader([&] {
+        auto handle = pointer.Acquire();
+        acquired = true;
+        while (!release)
+            std::this_thread::yield();
+        // the object must still be alive while the handle exists
+        read_value = handle->value;
+    });
+    while (!acquired)
+        std::this_thread::yield();
+
+    std::atomic<bool> updated{false};
+    std::thread writer([&] {
+        pointer.Update(std::make_unique<const Tracked>(2, alive));
+        updated = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    BOOST_CHECK(!updated);
+    BOOST_CHECK_EQUAL(alive, 2);
+    // new readers already see the new object
+    BOOST_CHECK_EQUAL(pointer.Acquire()->value, 2);
+
+    release = true;
+    reader.join();
+    writer.join();
+    BOOST_CHECK_EQUAL(read_value, 1);
+    BOOST_CHECK(updated);
+    BOOST_CHECK_EQUAL(alive, 1);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_readers)
+{
+    std::atomic<int> alive{0};
+    EpochPointer<const Tracked> pointer(std::make_unique<const Tracked>(0, alive));
+
+    std::atomic<bool> done{false};
+    std::atomic<int> errors{0};
+    std::vector<std::thread> readers;
+    for (int index = 0; index < 4; ++index)
+    {
+        readers.emplace_back([&] {
+            while (!done)
+            {
+                auto handle = pointer.Acquire();
+                if (handle->alive <= 0 || handle->value < 0)
+                    ++errors;
+            }
+        });
+    }
+
+    for (int value = 1; value <= 200; ++value)
+    {
+        pointer.Update(std::make_unique<const Tracked>(value, alive));
+        BOOST_CHECK_EQUAL(alive, 1);
+    }
+    done = true;
+    for (auto &reader : readers)
+        reader.join();
+
+    BOOST_CHECK_EQUAL(errors, 0);
+    BOOST_CHECK_EQUAL(pointer.Acquire()->value, 200);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
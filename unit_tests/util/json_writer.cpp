@@ -0,0 +1,99 @@
+#include "util/json_renderer.hpp"
+#include "util/json_writer.hpp"
+
+#include "util/cast.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(json_writer)
+
+using namespace osrm;
+using namespace osrm::util;
+
+std::string write(const double value)
+{
+    std::vector<char> buffer;
+    json::Writer writer(buffer);
+    writer.Number(value);
+    return std::string(buffer.begin(), buffer.end());
+}
+
+BOOST_AUTO_TEST_CASE(numbers_like_tree_renderer)
+{
+    const std::vector<double> values = {0.,
+                                        -0.,
+                                        1.,
+                                        -1.,
+                                        10.,
+                                        123.4,
+                                        -123.45,
+                                        0.1,
+                                        0.0000001,
+                                        -0.0000001,
+                                        13.3880401,
+                                        52.517037,
+                                        1234567.8,
+                                        2147483647.,
+                                        1e15,
+                                        1e20,
+                                        std::numeric_limits<double>::max()};
+    for (const auto value : values)
+    {
+        BOOST_CHECK_EQUAL(write(value), cast::to_string_with_precision(value));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(streaming_document)
+{
+    std::vector<char> buffer;
+    json::Writer writer(buffer);
+    writer.StartObject();
+    writer.Key("code");
+    writer.String("Ok");
+    writer.Key("durations");
+    writer.StartArray();
+    for (int row = 0; row < 2; ++row)
+    {
+        writer.StartArray();
+        writer.Number(row);
+        writer.Null();
+        writer.Number(2.5);
+        writer.EndArray();
+    }
+    writer.EndArray();
+    writer.Key("empty");
+    writer.StartObject();
+    writer.EndObject();
+    writer.Key("escaped");
+    writer.String("a\"b/c\n");
+    writer.Key("flag");
+    writer.Bool(true);
+    writer.EndObject();
+
+    BOOST_CHECK_EQUAL(std::string(buffer.begin(), buffer.end()),
+                      "{\"code\":\"Ok\",\"durations\":[[0,null,2.5],[1,null,2.5]],\"empty\":{},"
+                      "\"escaped\":\"a\\\"b\\/c\\n\",\"flag\":true}");
+}
+
+BOOST_AUTO_TEST_CASE(tree_values)
+{
+    json::Array array;
+    array.values.push_back(json::Number(1.5));
+    array.values.push_back(json::String("x"));
+    array.values.push_back(json::False());
+
+    std::vector<char> buffer;
+    json::Writer writer(buffer);
+    writer.StartArray();
+    writer.Value(array);
+    writer.Value(json::Value(json::Null()));
+    writer.EndArray();
+
+    BOOST_CHECK_EQUAL(std::string(buffer.begin(), buffer.end()), "[[1.5,\"x\",false],null]");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
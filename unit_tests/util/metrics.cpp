@@ -0,0 +1,175 @@
+#include "util/metrics.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(metrics)
+
+using namespace osrm;
+using namespace osrm::util::metrics;
+
+BOOST_AUTO_TEST_CASE(bucket_bounds)
+{
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(0), 0);
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(3), 3);
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(4), 4);
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(7), 7);
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(8), 8);
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(9), 8);
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(10), 9);
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(std::uint64_t{1} << 63),
+                      Histogram::NUMBER_OF_BUCKETS - 1);
+
+    // every value is below the upper bound of its bucket and at least the one of the previous
+    for (std::uint64_t value = 1; value < (std::uint64_t{1} << 41); value = value * 3 / 2 + 1)
+    {
+        const auto index = Histogram::BucketIndex(value);
+        BOOST_CHECK_LT(value, Histogram::BucketUpperBound(index));
+        BOOST_CHECK_GE(value, Histogram::BucketUpperBound(index - 1));
+        // the relative error is bounded by the sub-buckets
+        BOOST_CHECK_LE(Histogram::BucketUpperBound(index), value + value / 4 + 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(quantiles)
+{
+    Histogram histogram;
+    BOOST_CHECK_EQUAL(histogram.Quantile(0.5), 0);
+
+    for (std::uint64_t value = 1; value <= 100; ++value)
+    {
+        histogram.Record(value);
+    }
+    BOOST_CHECK_EQUAL(histogram.Count(), 100);
+    BOOST_CHECK_EQUAL(histogram.Sum(), 5050);
+    BOOST_CHECK_EQUAL(histogram.Quantile(0.5), 56);
+    BOOST_CHECK_EQUAL(histogram.Quantile(0.99), 112);
+    BOOST_CHECK_EQUAL(histogram.Quantile(1.0), 112);
+
+    Histogram other;
+    other.Record(1000);
+    histogram.Merge(other);
+    BOOST_CHECK_EQUAL(histogram.Count(), 101);
+    BOOST_CHECK_EQUAL(histogram.Quantile(1.0), 1024);
+}
+
+BOOST_AUTO_TEST_CASE(endpoint_names)
+{
+    BOOST_CHECK(endpointFromService("route") == Endpoint::Route);
+    BOOST_CHECK(endpointFromService("tile") == Endpoint::Tile);
+    BOOST_CHECK(endpointFromService("foo") == Endpoint::Other);
+    BOOST_CHECK_EQUAL(name(Stage::Unpacking), std::string("unpacking"));
+}
+
+BOOST_AUTO_TEST_CASE(scopes_record_exclusive_stage_time)
+{
+    const auto before = collect();
+    const auto index = static_cast<std::size_t>(Endpoint::Match);
+
+    {
+        // without a request nothing is recorded
+        StageScope stage(Stage::Search);
+    }
+
+    std::thread worker([] {
+        RequestScope request(Endpoint::Match);
+        {
+            RequestScope nested_request(Endpoint::Route);
+            StageScope search(Stage::Search);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            {
+                StageScope unpacking(Stage::Unpacking);
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+        }
+        countSettledNode();
+        addSettledNodes(takeSettledNodes([] {
+            for (int i = 0; i < 41; ++i)
+            {
+                countSettledNode();
+            }
+        }));
+    });
+    worker.join();
+
+    const auto after = collect();
+    BOOST_CHECK_EQUAL(after.request_duration[index].Count(),
+                      before.request_duration[index].Count() + 1);
+    BOOST_CHECK_EQUAL(after.request_duration[static_cast<std::size_t>(Endpoint::Route)].Count(),
+                      before.request_duration[static_cast<std::size_t>(Endpoint::Route)].Count());
+    BOOST_CHECK_EQUAL(after.settled_nodes[index].Sum(), before.settled_nodes[index].Sum() + 42);
+
+    const auto &search_before =
+        before.stage_duration[index][static_cast<std::size_t>(Stage::Search)];
+    const auto &search_after = after.stage_duration[index][static_cast<std::size_t>(Stage::Search)];
+    const auto &unpacking_after =
+        after.stage_duration[index][static_cast<std::size_t>(Stage::Unpacking)];
+    BOOST_CHECK_EQUAL(search_after.Count(), search_before.Count() + 1);
+    // the nested stage is not counted twice
+    const auto search_us = search_after.Sum() - search_before.Sum();
+    BOOST_CHECK_GE(search_us, 20000);
+    BOOST_CHECK_LT(search_us, 40000);
+    BOOST_CHECK_GE(unpacking_after.Sum(), 20000);
+}
+
+BOOST_AUTO_TEST_CASE(prometheus_format)
+{
+    std::thread worker([] { RequestScope request(Endpoint::Nearest); });
+    worker.join();
+
+    const auto text = renderPrometheus(collect());
+    BOOST_CHECK(text.find("# TYPE osrm_request_duration_seconds histogram\n") !=
+                std::string::npos);
+    BOOST_CHECK(text.find("osrm_request_duration_seconds_bucket{endpoint=\"nearest\","
+                          "le=\"1e-06\"}") != std::string::npos);
+    BOOST_CHECK(text.find("osrm_request_duration_seconds_bucket{endpoint=\"nearest\","
+                          "le=\"+Inf\"}") != std::string::npos);
+    BOOST_CHECK(text.find("osrm_request_duration_quantile_seconds{endpoint=\"nearest\","
+                          "quantile=\"0.99\"}") != std::string::npos);
+    BOOST_CHECK(text.find("osrm_settled_nodes_count{endpoint=\"nearest\"}") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(queue_metrics)
+{
+    const auto before = collect();
+    const auto index = static_cast<std::size_t>(Endpoint::Trip);
+
+    addQueuedRequests(Endpoint::Trip, 3);
+    addQueuedRequests(Endpoint::Trip, -1);
+    countRejectedRequest(Endpoint::Trip);
+    std::thread worker([] {
+        for (std::uint64_t wait_us = 1; wait_us <= 100; ++wait_us)
+        {
+            recordQueueWait(Endpoint::Trip, wait_us * 1000);
+        }
+    });
+    worker.join();
+
+    const auto after = collect();
+    BOOST_CHECK_EQUAL(after.queue_size[index], before.queue_size[index] + 2);
+    BOOST_CHECK_EQUAL(after.rejected_requests[index], before.rejected_requests[index] + 1);
+    BOOST_CHECK_EQUAL(after.queue_wait[index].Count(), before.queue_wait[index].Count() + 100);
+    BOOST_CHECK_EQUAL(after.queue_wait[index].Quantile(0.99), 114688);
+
+    const auto text = renderPrometheus(after);
+    BOOST_CHECK(text.find("# TYPE osrm_request_queue_wait_seconds histogram\n") !=
+                std::string::npos);
+    BOOST_CHECK(text.find("osrm_request_queue_wait_seconds_count{endpoint=\"trip\"} 100\n") !=
+                std::string::npos);
+    BOOST_CHECK(text.find("osrm_request_queue_wait_quantile_seconds{endpoint=\"trip\","
+                          "quantile=\"0.99\"} 0.114688\n") != std::string::npos);
+    BOOST_CHECK(text.find("# TYPE osrm_requests_rejected_total counter\n"
+                          "osrm_requests_rejected_total{endpoint=\"trip\"} 1\n") !=
+                std::string::npos);
+    BOOST_CHECK(text.find("# TYPE osrm_request_queue_size gauge\n") != std::string::npos);
+    BOOST_CHECK(text.find("osrm_request_queue_size{endpoint=\"trip\"} 2\n") != std::string::npos);
+    BOOST_CHECK(text.find("osrm_request_queue_size{endpoint=\"route\"} 0\n") != std::string::npos);
+
+    addQueuedRequests(Endpoint::Trip, -2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
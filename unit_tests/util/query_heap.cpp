@@ -24,8 +24,10 @@ typedef NodeID TestNodeID;
 typedef int TestKey;
 typedef int TestWeight;
 typedef boost::mpl::list<ArrayStorage<TestNodeID, TestKey>,
+                         GenerationArrayStorage<TestNodeID, TestKey>,
                          MapStorage<TestNodeID, TestKey>,
-                         UnorderedMapStorage<TestNodeID, TestKey>>
+                         UnorderedMapStorage<TestNodeID, TestKey>,
+                         AdaptiveStorage<TestNodeID, TestKey>>
     storage_types;
 
 template <unsigned NUM_ELEM> struct RandomDataFixture
@@ -157,4 +159,55 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomData
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(generation_clear_test, RandomDataFixture<NUM_NODES>)
+{
+    using Storage = GenerationArrayStorage<TestNodeID, TestKey>;
+    QueryHeap<TestNodeID, TestKey, TestWeight, TestData, Storage> heap(NUM_NODES);
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+
+    // more clears than the generation counter can represent
+    for (unsigned round = 0; round < (1u << 16) + 2; ++round)
+    {
+        heap.Clear();
+    }
+
+    for (auto id : ids)
+    {
+        BOOST_CHECK(!heap.WasInserted(id));
+    }
+
+    heap.Insert(ids[0], weights[0], data[0]);
+    BOOST_CHECK(heap.WasInserted(ids[0]));
+    BOOST_CHECK(!heap.WasInserted(ids[1]));
+}
+
+BOOST_FIXTURE_TEST_CASE(adaptive_storage_fallback_test, RandomDataFixture<NUM_NODES>)
+{
+    using Storage = AdaptiveStorage<TestNodeID, TestKey>;
+    BOOST_CHECK(Storage(NUM_NODES).UsesArray());
+    BOOST_CHECK(!Storage(NUM_NODES, 0).UsesArray());
+
+    // a heap over budget must still behave like any other heap
+    QueryHeap<TestNodeID, TestKey, TestWeight, TestData, Storage> heap(NUM_NODES, 0);
+    BOOST_CHECK_EQUAL(heap.Capacity(), NUM_NODES);
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+
+    for (auto id : ids)
+    {
+        BOOST_CHECK_EQUAL(heap.GetData(id).value, data[id].value);
+        BOOST_CHECK_EQUAL(id, heap.DeleteMin());
+    }
+
+    heap.Clear();
+    BOOST_CHECK(!heap.WasInserted(ids[0]));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+#include "util/segment_projection.hpp"
+#include "util/coordinate_calculation.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(segment_projection_test)
+
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(kernels_match_projection_of_single_segments)
+{
+    // an odd number of segments, so the SIMD kernels process a remainder
+    const std::size_t number_of_segments = 1001;
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::int32_t> lon(-180000000, 180000000);
+    std::uniform_int_distribution<std::int32_t> lat(-170000000, 170000000);
+    std::uniform_int_distribution<std::int32_t> offset(-1000, 1000);
+
+    std::vector<std::int32_t> u_lon, u_lat, v_lon, v_lat;
+    for (std::size_t i = 0; i < number_of_segments; ++i)
+    {
+        u_lon.push_back(lon(generator));
+        u_lat.push_back(lat(generator));
+        if (i % 10 == 0)
+        {
+            // segments without a length
+            v_lon.push_back(u_lon.back());
+            v_lat.push_back(u_lat.back());
+        }
+        else
+        {
+            v_lon.push_back(u_lon.back() + offset(generator));
+            v_lat.push_back(u_lat.back() + offset(generator));
+        }
+    }
+    const Coordinate input{FixedLongitude{u_lon[1] + 300}, FixedLatitude{u_lat[1] - 200}};
+
+    const auto best_kernel = detail::getProjectionKernel();
+    std::vector<detail::ProjectionKernel> kernels = {detail::ProjectionKernel::Scalar};
+    if (best_kernel != detail::ProjectionKernel::Scalar)
+        kernels.push_back(detail::ProjectionKernel::SSE2);
+    if (best_kernel == detail::ProjectionKernel::AVX2)
+        kernels.push_back(detail::ProjectionKernel::AVX2);
+
+    for (const auto kernel : kernels)
+    {
+        std::vector<std::int32_t> nearest_lon(number_of_segments), nearest_lat(number_of_segments);
+        detail::projectPointOnSegments(kernel,
+                                       u_lon.data(),
+                                       u_lat.data(),
+                                       v_lon.data(),
+                                       v_lat.data(),
+                                       number_of_segments,
+                                       input,
+                                       nearest_lon.data(),
+                                       nearest_lat.data());
+
+        for (std::size_t i = 0; i < number_of_segments; ++i)
+        {
+            const Coordinate u{FixedLongitude{u_lon[i]}, FixedLatitude{u_lat[i]}};
+            const Coordinate v{FixedLongitude{v_lon[i]}, FixedLatitude{v_lat[i]}};
+            const Coordinate expected{
+                coordinate_calculation::projectPointOnSegment(u, v, input).second};
+
+            // the projection in degrees can round differently
+            BOOST_CHECK_LE(std::abs(nearest_lon[i] - static_cast<std::int32_t>(expected.lon)), 1);
+            BOOST_CHECK_LE(std::abs(nearest_lat[i] - static_cast<std::int32_t>(expected.lat)), 1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(nearest_point_is_clamped_to_segment)
+{
+    const std::int32_t u_lon[] = {0, 0, 0};
+    const std::int32_t u_lat[] = {0, 0, 0};
+    const std::int32_t v_lon[] = {1000, 1000, 1000};
+    const std::int32_t v_lat[] = {0, 0, 0};
+    std::int32_t nearest_lon[3], nearest_lat[3];
+
+    projectPointOnSegments(u_lon,
+                           u_lat,
+                           v_lon,
+                           v_lat,
+                           3,
+                           Coordinate{FixedLongitude{-500}, FixedLatitude{100}},
+                           nearest_lon,
+                           nearest_lat);
+    BOOST_CHECK_EQUAL(nearest_lon[0], 0);
+    BOOST_CHECK_EQUAL(nearest_lat[0], 0);
+
+    projectPointOnSegments(u_lon,
+                           u_lat,
+                           v_lon,
+                           v_lat,
+                           3,
+                           Coordinate{FixedLongitude{400}, FixedLatitude{100}},
+                           nearest_lon,
+                           nearest_lat);
+    BOOST_CHECK_EQUAL(nearest_lon[2], 400);
+    BOOST_CHECK_EQUAL(nearest_lat[2], 0);
+
+    projectPointOnSegments(u_lon,
+                           u_lat,
+                           v_lon,
+                           v_lat,
+                           3,
+                           Coordinate{FixedLongitude{1500}, FixedLatitude{-100}},
+                           nearest_lon,
+                           nearest_lat);
+    BOOST_CHECK_EQUAL(nearest_lon[1], 1000);
+    BOOST_CHECK_EQUAL(nearest_lat[1], 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -300,6 +300,106 @@ BOOST_FIXTURE_TEST_CASE(construct_multiple_levels_test, TestRandomGraphFixture_M
     construction_test("test_5", this);
 }
 
+BOOST_FIXTURE_TEST_CASE(batch_nearest, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<TestRandomGraphFixture_MultipleLevels, TestStaticRTree>(
+        "test_batch", this, leaves_path, nodes_path);
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    std::vector<Coordinate> queries;
+    for (unsigned i = 0; i < 300; i++)
+    {
+        queries.emplace_back(FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)});
+    }
+
+    for (const int max_threads : {1, 2})
+    {
+        std::vector<std::vector<TestData>> batch_results(queries.size());
+        rtree.BatchNearest(
+            queries,
+            [](const std::size_t, const TestStaticRTree::CandidateSegment &) {
+                return std::make_pair(true, true);
+            },
+            [](const std::size_t query,
+               const std::size_t num_results,
+               const TestStaticRTree::CandidateSegment &) {
+                // a different number of results per query
+                return num_results >= 1 + query % 3;
+            },
+            [&](const std::size_t query, const std::vector<TestData> &results) {
+                batch_results[query] = results;
+            },
+            max_threads);
+
+        for (std::size_t query = 0; query < queries.size(); ++query)
+        {
+            const auto results = rtree.Nearest(
+                queries[query],
+                [](const TestStaticRTree::CandidateSegment &) {
+                    return std::make_pair(true, true);
+                },
+                [query](const std::size_t num_results, const TestStaticRTree::CandidateSegment &) {
+                    return num_results >= 1 + query % 3;
+                });
+            BOOST_REQUIRE_EQUAL(batch_results[query].size(), results.size());
+            for (std::size_t i = 0; i < results.size(); ++i)
+            {
+                BOOST_CHECK_EQUAL(batch_results[query][i].u, results[i].u);
+                BOOST_CHECK_EQUAL(batch_results[query][i].v, results[i].v);
+            }
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(nearest_k, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree<TestRandomGraphFixture_MultipleLevels, TestStaticRTree>(
+        "test_nearest_k", this, leaves_path, nodes_path);
+    TestStaticRTree rtree(nodes_path, leaves_path, coords);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+
+    const auto filter = [](const TestStaticRTree::CandidateSegment &segment) {
+        return std::make_pair(segment.data.u % 3 != 0, segment.data.u % 3 != 0);
+    };
+
+    // one context for all queries, every query overwrites the results of the previous one
+    TestStaticRTree::TraversalContext context;
+    for (unsigned i = 0; i < 100; i++)
+    {
+        const Coordinate q{FixedLongitude{lon_udist(g)}, FixedLatitude{lat_udist(g)}};
+        const std::size_t max_results = 1 + i % 10;
+
+        const auto expected = rtree.Nearest(
+            q, filter, [max_results](const std::size_t num_results,
+                                     const TestStaticRTree::CandidateSegment &) {
+                return num_results >= max_results;
+            });
+        const auto &results = rtree.NearestK(context, q, max_results, filter);
+
+        // segments that share a node can have the same distance, so their order may differ
+        BOOST_REQUIRE_EQUAL(results.size(), expected.size());
+        for (std::size_t j = 0; j < results.size(); ++j)
+        {
+            BOOST_CHECK_CLOSE(
+                coordinate_calculation::perpendicularDistance(
+                    coords[results[j].u], coords[results[j].v], q),
+                coordinate_calculation::perpendicularDistance(
+                    coords[expected[j].u], coords[expected[j].v], q),
+                0.0001);
+        }
+    }
+}
+
 // Bug: If you querry a point that lies between two BBs that have a gap,
 // one BB will be pruned, even if it could contain a nearer match.
 BOOST_AUTO_TEST_CASE(regression_test)